@@ -3,7 +3,7 @@
 #include "json.hpp"
 #include "SharedState.h" 
 #include "DetectionData.h" 
-#include "StreamProcessor.h" 
+#include "StreamManager.h"
 #include "SerialCommunicator.h" 
 #include "STM32Protocol.h"     
 #include <fstream>
@@ -11,8 +11,8 @@
 #include <iomanip>
 #include <sys/sysinfo.h>
 
-ApiService::ApiService(crow::SimpleApp& app, StreamProcessor& processor, DatabaseManager& dbManager, SerialCommunicator& serial_comm)
-    : app_(app), processor_(processor), dbManager_(dbManager), serial_comm_(serial_comm) {}
+ApiService::ApiService(crow::SimpleApp& app, StreamManager& manager, DatabaseManager& dbManager, SerialCommunicator& serial_comm)
+    : app_(app), manager_(manager), dbManager_(dbManager), serial_comm_(serial_comm) {}
 
 void ApiService::setupRoutes() {
     // 웹소켓 라우트
@@ -36,6 +36,8 @@ void ApiService::setupRoutes() {
                 } 
                 else if (type == "set_mode") {
                     std::string mode = json_req.value("mode", "stop");
+                    // camera_id가 없으면 모든 카메라에 적용 (단일 카메라 시절 클라이언트 호환)
+                    int camera_id = json_req.value("camera_id", 0);
                     
                     // 기존 POST 라우트에 있던 유효성 검사 로직을 그대로 가져옵니다.
                     std::vector<std::string> valid_modes = {"detect", "blur", "raw", "stop", "trespass", "fall"};
@@ -47,23 +49,37 @@ void ApiService::setupRoutes() {
                         }
                     }
 
-                    if (is_valid) {
-                        std::lock_guard<std::mutex> lock(g_mode_mutex);
-                        g_current_mode = mode;
-                        std::cout << "모드가 다음으로 변경되었습니다 : " << mode << std::endl;
+                    std::vector<StreamProcessor*> targets;
+                    if (camera_id == 0) {
+                        targets = manager_.getCameras();
+                    } else if (StreamProcessor* camera = manager_.getCamera(camera_id)) {
+                        targets.push_back(camera);
+                    }
+
+                    if (is_valid && !targets.empty()) {
+                        for (StreamProcessor* camera : targets) camera->setMode(mode);
                         
                         // (선택) 요청한 클라이언트에게 성공했다는 응답(ACK)을 보내줍니다.
                         nlohmann::json res;
                         res["type"] = "mode_change_ack";
                         res["status"] = "success";
                         res["mode"] = mode;
+                        res["camera_id"] = camera_id;
+                        // 모델을 올리는 중이면 준비될 때까지 이전 모드로 송출 (완료는 model_load 이벤트로 알림)
+                        bool loading = false;
+                        for (StreamProcessor* camera : targets) {
+                            if (manager_.getEngine().activeMode(camera->getCameraId()) != mode) loading = true;
+                        }
+                        res["loading"] = loading;
                         conn.send_text(res.dump());
                     } else {
                         // (선택) 요청한 클라이언트에게 실패했다는 응답(NACK)을 보내줍니다.
                         nlohmann::json res;
                         res["type"] = "mode_change_ack";
                         res["status"] = "error";
-                        res["message"] = "Invalid mode requested: " + mode;
+                        res["camera_id"] = camera_id;
+                        res["message"] = is_valid ? "Unknown camera: " + std::to_string(camera_id)
+                                                  : "Invalid mode requested: " + mode;
                         conn.send_text(res.dump());
                     }
                 }
@@ -71,11 +87,39 @@ void ApiService::setupRoutes() {
                 // value 키가 있고, 숫자인지 확인
                 if (json_req.contains("value") && json_req["value"].is_number()) {
                     int brightness_value = json_req["value"].get<int>();
+                    int camera_id = json_req.value("camera_id", 0);
                     
-                    // StreamProcessor에 새로운 밝기 값 전달
-                    processor_.setBrightness(brightness_value);
+                    // 대상 카메라(들)의 StreamProcessor에 새로운 밝기 값 전달
+                    for (StreamProcessor* camera : manager_.getCameras()) {
+                        if (camera_id == 0 || camera->getCameraId() == camera_id) {
+                            camera->setBrightness(brightness_value);
+                        }
+                    }
                     }
                 }
+                else if (type == "set_zones") {
+                    // 침입 감지 구역 교체: {"camera_id": 1, "zones": [[[x, y], ...], ...]} (빈 배열이면 해제)
+                    int camera_id = json_req.value("camera_id", 0);
+                    StreamProcessor* camera = manager_.getCamera(camera_id);
+                    std::vector<Zone> zones;
+                    std::string error;
+
+                    nlohmann::json res;
+                    res["type"] = "zones_ack";
+                    res["camera_id"] = camera_id;
+                    if (!camera) {
+                        res["status"] = "error";
+                        res["message"] = "Unknown camera: " + std::to_string(camera_id);
+                    } else if (!zones_from_json(json_req.value("zones", nlohmann::json::array()), zones, error)) {
+                        res["status"] = "error";
+                        res["message"] = error;
+                    } else {
+                        camera->setZones(zones);
+                        res["status"] = "success";
+                        res["zones"] = zones_to_json(zones);
+                    }
+                    conn.send_text(res.dump());
+                }
             } catch (const std::exception& e) {
                 CROW_LOG_ERROR << "Invalid WebSocket message: " << e.what();
             }
@@ -114,6 +158,164 @@ void ApiService::setupRoutes() {
         }
     });
 
+    CROW_ROUTE(app_, "/api/cameras")([this] {
+        nlohmann::json cameras = nlohmann::json::array();
+        for (StreamProcessor* camera : manager_.getCameras()) {
+            nlohmann::json obj;
+            obj["camera_id"] = camera->getCameraId();
+            obj["mode"] = camera->getMode();
+            obj["rtsp_url"] = camera->getRtspUrl();
+            cameras.push_back(obj);
+        }
+
+        nlohmann::json response_json;
+        response_json["status"] = "success";
+        response_json["cameras"] = cameras;
+
+        crow::response res(response_json.dump());
+        res.set_header("Content-Type", "application/json");
+        return res;
+    });
+
+    // 카메라별 침입 감지 구역 조회(GET) / 교체(POST {"zones": [...]})
+    CROW_ROUTE(app_, "/api/cameras/<int>/zones").methods(crow::HTTPMethod::GET, crow::HTTPMethod::POST)
+    ([this](const crow::request& req, int camera_id) {
+        nlohmann::json response_json;
+        StreamProcessor* camera = manager_.getCamera(camera_id);
+        if (!camera) {
+            response_json["status"] = "error";
+            response_json["message"] = "Unknown camera: " + std::to_string(camera_id);
+            crow::response res(404, response_json.dump());
+            res.set_header("Content-Type", "application/json");
+            return res;
+        }
+
+        if (req.method == crow::HTTPMethod::POST) {
+            std::vector<Zone> zones;
+            std::string error;
+            nlohmann::json body = nlohmann::json::parse(req.body, nullptr, false);
+            if (body.is_discarded() || !body.is_object()) {
+                error = "Invalid JSON body";
+            } else {
+                zones_from_json(body.value("zones", nlohmann::json::array()), zones, error);
+            }
+            if (!error.empty()) {
+                response_json["status"] = "error";
+                response_json["message"] = error;
+                crow::response res(400, response_json.dump());
+                res.set_header("Content-Type", "application/json");
+                return res;
+            }
+            camera->setZones(zones);
+        }
+
+        response_json["status"] = "success";
+        response_json["camera_id"] = camera_id;
+        response_json["zones"] = zones_to_json(camera->getZones());
+        crow::response res(response_json.dump());
+        res.set_header("Content-Type", "application/json");
+        return res;
+    });
+
+    CROW_ROUTE(app_, "/api/pipeline/stats")([this] {
+        auto queue_to_json = [](const QueueStats& q) {
+            nlohmann::json obj;
+            obj["capacity"] = q.capacity;
+            obj["depth"] = q.depth;
+            obj["pushed"] = q.pushed;
+            obj["popped"] = q.popped;
+            obj["dropped"] = q.dropped;
+            return obj;
+        };
+
+        auto latency_to_json = [](const LatencyStats& l) {
+            nlohmann::json obj;
+            obj["samples"] = l.samples;
+            obj["last_ms"] = l.last_ms;
+            obj["avg_ms"] = l.avg_ms;
+            obj["max_ms"] = l.max_ms;
+            return obj;
+        };
+
+        nlohmann::json cameras = nlohmann::json::array();
+        for (StreamProcessor* camera : manager_.getCameras()) {
+            PipelineStats stats = camera->getPipelineStats();
+
+            nlohmann::json obj;
+            obj["camera_id"] = stats.camera_id;
+            obj["mode"] = stats.mode;
+            obj["active_mode"] = stats.active_mode;
+            obj["source"]["name"] = stats.source;
+            obj["source"]["delivered"] = stats.capture.delivered;
+            obj["source"]["dropped"] = stats.capture.dropped;
+            obj["captured_frames"] = stats.captured_frames;
+            obj["inferred_frames"] = stats.inferred_frames;
+            obj["streamed_frames"] = stats.streamed_frames;
+            obj["cadence_skipped_frames"] = stats.cadence_skipped_frames;
+            obj["propagated_frames"] = stats.propagated_frames;
+            obj["motion_gate"]["gated_frames"] = stats.motion_gated_frames;
+            obj["motion_gate"]["changed_ratio"] = stats.motion_changed_ratio;
+            obj["queues"]["inference"] = queue_to_json(stats.inference_queue);
+            obj["queues"]["render"] = queue_to_json(stats.render_queue);
+            obj["latency"]["capture_to_inference"] = latency_to_json(stats.capture_to_inference);
+            obj["latency"]["capture_to_output"] = latency_to_json(stats.capture_to_output);
+            obj["frame_pool"]["buffers"] = stats.frame_pool.buffers;
+            obj["frame_pool"]["in_use"] = stats.frame_pool.in_use;
+            obj["frame_pool"]["allocations"] = stats.frame_pool.allocations;
+            cameras.push_back(obj);
+        }
+
+        // 공유 추론 엔진: 카메라별 요청/처리 횟수로 스케줄링이 공정한지 확인
+        EngineStats engine_stats = manager_.getEngine().getStats();
+        nlohmann::json engine;
+        engine["loaded_models"] = engine_stats.loaded_models;
+        engine["model_pool"]["loaded"] = engine_stats.model_pool.loaded;
+        engine["model_pool"]["resident_mb"] = engine_stats.model_pool.resident_bytes / (1024.0 * 1024.0);
+        engine["model_pool"]["budget_mb"] = engine_stats.model_pool.budget_bytes / (1024 * 1024);
+        engine["model_pool"]["loads"] = engine_stats.model_pool.loads;
+        engine["model_pool"]["hits"] = engine_stats.model_pool.hits;
+        engine["model_pool"]["evictions"] = engine_stats.model_pool.evictions;
+        engine["cameras"] = nlohmann::json::array();
+        for (const auto& camera : engine_stats.cameras) {
+            nlohmann::json obj;
+            obj["camera_id"] = camera.camera_id;
+            obj["mode"] = camera.mode;
+            obj["requested_mode"] = camera.requested_mode;
+            obj["requests"] = camera.requests;
+            obj["served"] = camera.served;
+            engine["cameras"].push_back(obj);
+        }
+
+        auto histogram_to_json = [](const Histogram& h) {
+            nlohmann::json obj;
+            obj["bounds"] = h.bounds;
+            obj["counts"] = h.counts;
+            obj["samples"] = h.samples;
+            obj["avg"] = h.samples > 0 ? h.sum / h.samples : 0.0;
+            return obj;
+        };
+        engine["batching"]["max_batch"] = engine_stats.max_batch;
+        engine["batching"]["window_ms"] = engine_stats.batch_window_ms;
+        engine["batching"]["batches"] = engine_stats.batches;
+        engine["batching"]["batch_size"] = histogram_to_json(engine_stats.batch_size);
+        engine["batching"]["wait_ms"] = histogram_to_json(engine_stats.batch_wait_ms);
+        // 공유 추론 스레드: contended가 늘면 다른 모델 실행(로드 워밍업 등)을 기다린 것
+        engine["threads"]["threads"] = engine_stats.threads.threads;
+        engine["threads"]["opencv_threads"] = engine_stats.threads.opencv_threads;
+        engine["threads"]["runs"] = engine_stats.threads.runs;
+        engine["threads"]["contended"] = engine_stats.threads.contended;
+        engine["threads"]["wait_ms"] = histogram_to_json(engine_stats.threads.wait_ms);
+
+        nlohmann::json response_json;
+        response_json["status"] = "success";
+        response_json["cameras"] = cameras;
+        response_json["engine"] = engine;
+
+        crow::response res(response_json.dump());
+        res.set_header("Content-Type", "application/json");
+        return res;
+    });
+
     CROW_ROUTE(app_, "/api/trespass")([this] {
         std::vector<TrespassLogData> results;
         nlohmann::json response_json;
@@ -235,6 +437,21 @@ void ApiService::broadcastNewFall(const FallCountData& data) {
     }
 }
 
+void ApiService::broadcastModelLoad(const ModelLoadEvent& event) {
+    nlohmann::json msg;
+    msg["type"] = "model_load";
+    msg["data"]["model"] = event.model;
+    msg["data"]["state"] = event.state;
+    msg["data"]["camera_ids"] = event.camera_ids;
+    msg["data"]["elapsed_ms"] = event.elapsed_ms;
+    if (!event.error.empty()) msg["data"]["error"] = event.error;
+
+    std::lock_guard<std::mutex> _(mtx_);
+    for (auto user : ws_users_) {
+        user->send_text(msg.dump());
+    }
+}
+
 void ApiService::broadcastNewTrespass(const TrespassLogData& data) {
     nlohmann::json msg;
     msg["type"] = "new_trespass";
@@ -4,18 +4,19 @@
 #include <mutex>
 
 // 전방 선언
-class StreamProcessor;
+class StreamManager;
 class DatabaseManager;
 class SerialCommunicator;
 struct DetectionData;     
 struct PersonCountData;  
 struct FallCountData;
 struct TrespassLogData;
+struct ModelLoadEvent;
 
 class ApiService {
 public:
     //ApiService(crow::SimpleApp& app, StreamProcessor& processor, DatabaseManager& dbManager);
-    ApiService(crow::SimpleApp& app, StreamProcessor& processor, DatabaseManager& dbManager, SerialCommunicator& serial_comm);
+    ApiService(crow::SimpleApp& app, StreamManager& manager, DatabaseManager& dbManager, SerialCommunicator& serial_comm);
     void setupRoutes();
 
     // ▼▼▼ StreamProcessor가 호출할 공개 함수 추가 ▼▼▼
@@ -26,12 +27,13 @@ public:
     void broadcastNewFall(const FallCountData& data);
     void broadcastNewTrespass(const TrespassLogData& data);
     void broadcastSystemInfo(double cpuUsage, double memoryUsage);
+    void broadcastModelLoad(const ModelLoadEvent& event);
     void handleSTM32StatusCheck();
     
 
 private:
     crow::SimpleApp& app_;
-    StreamProcessor& processor_;
+    StreamManager& manager_;
     DatabaseManager& dbManager_;
     SerialCommunicator& serial_comm_;
 
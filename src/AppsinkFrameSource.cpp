@@ -0,0 +1,204 @@
+#include "AppsinkFrameSource.h"
+
+#include <cstring>
+#include <iostream>
+
+AppsinkFrameSource::AppsinkFrameSource(const CaptureConfig& config) : config_(config) {}
+
+AppsinkFrameSource::~AppsinkFrameSource() {
+    close();
+}
+
+bool AppsinkFrameSource::open() {
+    if (!gst_is_initialized()) gst_init(nullptr, nullptr);
+
+    // 콜백에서 바로 꺼내가므로 appsink 자체에는 최신 버퍼 하나만 둠
+    const std::string description = camera_source_pipeline(config_) +
+        "appsink name=sink sync=false max-buffers=1 drop=true emit-signals=false";
+
+    GError* error = nullptr;
+    pipeline_ = gst_parse_launch(description.c_str(), &error);
+    if (!pipeline_ || error) {
+        std::cerr << "오류: GStreamer 파이프라인 생성 실패: " << (error ? error->message : "unknown") << std::endl;
+        if (error) g_error_free(error);
+        if (pipeline_) gst_object_unref(pipeline_);
+        pipeline_ = nullptr;
+        return false;
+    }
+
+    appsink_ = gst_bin_get_by_name(GST_BIN(pipeline_), "sink");
+    if (!appsink_) {
+        std::cerr << "오류: 파이프라인에서 appsink를 찾을 수 없습니다." << std::endl;
+        close();
+        return false;
+    }
+
+    GstAppSinkCallbacks callbacks;
+    std::memset(&callbacks, 0, sizeof(callbacks));
+    callbacks.new_sample = &AppsinkFrameSource::on_new_sample;
+    gst_app_sink_set_callbacks(GST_APP_SINK(appsink_), &callbacks, this, nullptr);
+
+    if (config_.framerate > 0) {
+        frame_interval_ = GST_SECOND / static_cast<GstClockTime>(config_.framerate);
+    }
+
+    if (gst_element_set_state(pipeline_, GST_STATE_PLAYING) == GST_STATE_CHANGE_FAILURE) {
+        std::cerr << "오류: GStreamer 파이프라인을 시작할 수 없습니다." << std::endl;
+        close();
+        return false;
+    }
+    std::cout << "[INFO] appsink 캡처 시작: " << description << std::endl;
+    return true;
+}
+
+bool AppsinkFrameSource::read(Frame& frame) {
+    // 콜백이 프레임을 넣는 즉시 깨어남. 시간 초과 시 false를 돌려 종료 플래그를 확인하게 함
+    if (frames_.pop_for(frame, std::chrono::milliseconds(100))) return true;
+    poll_bus();
+    return false;
+}
+
+void AppsinkFrameSource::close() {
+    if (pipeline_) {
+        gst_element_set_state(pipeline_, GST_STATE_NULL);
+    }
+    if (appsink_) {
+        gst_object_unref(appsink_);
+        appsink_ = nullptr;
+    }
+    if (pipeline_) {
+        gst_object_unref(pipeline_);
+        pipeline_ = nullptr;
+    }
+    frames_.close();
+}
+
+CaptureStats AppsinkFrameSource::stats() const {
+    CaptureStats stats;
+    const QueueStats queue = frames_.stats();
+    stats.delivered = queue.popped;
+    // 카메라/appsink 단계에서 빠진 프레임(PTS 간격) + 캡처 스레드가 늦어 덮어쓴 프레임
+    stats.dropped = pts_gap_dropped_.load() + queue.dropped;
+    return stats;
+}
+
+GstFlowReturn AppsinkFrameSource::on_new_sample(GstAppSink* sink, gpointer user_data) {
+    GstSample* sample = gst_app_sink_pull_sample(sink);
+    if (!sample) return GST_FLOW_EOS;
+    GstFlowReturn ret = static_cast<AppsinkFrameSource*>(user_data)->handle_sample(sample);
+    gst_sample_unref(sample);
+    return ret;
+}
+
+GstFlowReturn AppsinkFrameSource::handle_sample(GstSample* sample) {
+    GstBuffer* buffer = gst_sample_get_buffer(sample);
+    GstCaps* caps = gst_sample_get_caps(sample);
+    GstVideoInfo info;
+    if (!buffer || !caps || !gst_video_info_from_caps(&info, caps)) return GST_FLOW_OK;
+
+    Frame frame;
+    frame.format = config_.format;
+    if (!copy_buffer(buffer, info, frame)) return GST_FLOW_OK;
+
+    const GstClockTime pts = GST_BUFFER_PTS(buffer);
+    if (GST_CLOCK_TIME_IS_VALID(pts)) {
+        frame.pts_ns = static_cast<int64_t>(pts);
+        frame.captured_at = to_steady(pts);
+
+        // PTS 간격이 프레임 주기의 1.5배를 넘으면 그 사이 프레임이 버려진 것으로 봄
+        if (GST_CLOCK_TIME_IS_VALID(last_pts_) && GST_CLOCK_TIME_IS_VALID(frame_interval_) && pts > last_pts_) {
+            const GstClockTime gap = pts - last_pts_;
+            const uint64_t missing = (gap + frame_interval_ / 2) / frame_interval_;
+            if (missing > 1) pts_gap_dropped_ += missing - 1;
+        }
+        last_pts_ = pts;
+    } else {
+        frame.captured_at = std::chrono::steady_clock::now();
+    }
+
+    frames_.push(std::move(frame));
+    return GST_FLOW_OK;
+}
+
+bool AppsinkFrameSource::copy_buffer(GstBuffer* buffer, const GstVideoInfo& info, Frame& frame) {
+    GstVideoFrame video_frame;
+    if (!gst_video_frame_map(&video_frame, const_cast<GstVideoInfo*>(&info), buffer, GST_MAP_READ)) return false;
+
+    const int width = GST_VIDEO_INFO_WIDTH(&info);
+    const int height = GST_VIDEO_INFO_HEIGHT(&info);
+
+    // 평면마다 stride가 패딩되어 있을 수 있으므로 연속 버퍼로 평면 단위 복사
+    auto copy_plane = [&](int plane, uchar* dst, int row_bytes, int rows) {
+        const uchar* src = static_cast<const uchar*>(GST_VIDEO_FRAME_PLANE_DATA(&video_frame, plane));
+        const int stride = GST_VIDEO_FRAME_PLANE_STRIDE(&video_frame, plane);
+        for (int y = 0; y < rows; ++y) {
+            std::memcpy(dst + static_cast<size_t>(y) * row_bytes, src + static_cast<size_t>(y) * stride, row_bytes);
+        }
+    };
+
+    bool ok = true;
+    switch (config_.format) {
+        case PixelFormat::Bgr:
+            frame_pool_.acquire(frame, height, width, CV_8UC3);
+            copy_plane(0, frame.image.data, width * 3, height);
+            break;
+        case PixelFormat::I420: {
+            frame_pool_.acquire(frame, height * 3 / 2, width, CV_8UC1);
+            uchar* out = frame.image.data;
+            const size_t luma = static_cast<size_t>(width) * height;
+            copy_plane(0, out, width, height);
+            copy_plane(1, out + luma, width / 2, height / 2);
+            copy_plane(2, out + luma + luma / 4, width / 2, height / 2);
+            break;
+        }
+        case PixelFormat::Nv12:
+            frame_pool_.acquire(frame, height * 3 / 2, width, CV_8UC1);
+            copy_plane(0, frame.image.data, width, height);
+            copy_plane(1, frame.image.data + static_cast<size_t>(width) * height, width, height / 2);
+            break;
+        default:
+            ok = false;
+            break;
+    }
+
+    gst_video_frame_unmap(&video_frame);
+    return ok;
+}
+
+std::chrono::steady_clock::time_point AppsinkFrameSource::to_steady(GstClockTime pts) {
+    // PTS는 running time이므로 base_time을 더하면 파이프라인 클럭의 절대 시각이 됨.
+    // 파이프라인 클럭과 steady_clock의 차이를 처음 한 번 측정해 두고 이후 프레임에 적용
+    if (!clock_synced_) {
+        GstClock* clock = gst_element_get_clock(pipeline_);
+        if (!clock) return std::chrono::steady_clock::now();
+        const GstClockTime gst_now = gst_clock_get_time(clock);
+        const auto steady_now = std::chrono::steady_clock::now().time_since_epoch();
+        gst_object_unref(clock);
+        steady_minus_gst_ns_ = std::chrono::duration_cast<std::chrono::nanoseconds>(steady_now).count() -
+                               static_cast<int64_t>(gst_now);
+        clock_synced_ = true;
+    }
+    const int64_t absolute_ns = static_cast<int64_t>(gst_element_get_base_time(pipeline_) + pts);
+    return std::chrono::steady_clock::time_point(
+        std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+            std::chrono::nanoseconds(absolute_ns + steady_minus_gst_ns_)));
+}
+
+void AppsinkFrameSource::poll_bus() {
+    if (!pipeline_) return;
+    GstBus* bus = gst_element_get_bus(pipeline_);
+    while (GstMessage* message = gst_bus_pop_filtered(bus, static_cast<GstMessageType>(GST_MESSAGE_ERROR | GST_MESSAGE_EOS))) {
+        if (GST_MESSAGE_TYPE(message) == GST_MESSAGE_ERROR) {
+            GError* error = nullptr;
+            gchar* debug = nullptr;
+            gst_message_parse_error(message, &error, &debug);
+            std::cerr << "[WARN] GStreamer 오류: " << (error ? error->message : "unknown") << std::endl;
+            if (error) g_error_free(error);
+            g_free(debug);
+        } else {
+            std::cerr << "[WARN] GStreamer 스트림 종료(EOS)" << std::endl;
+        }
+        gst_message_unref(message);
+    }
+    gst_object_unref(bus);
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <atomic>
+#include <gst/gst.h>
+#include <gst/app/gstappsink.h>
+#include <gst/video/video.h>
+#include "FramePool.h"
+#include "FrameQueue.h"
+#include "FrameSource.h"
+
+// libcamerasrc → appsink 파이프라인을 GStreamer API로 직접 구동하는 소스.
+// appsink의 new-sample 콜백에서 프레임을 바로 큐에 넣으므로 폴링 지연이 없고,
+// 버퍼 PTS를 steady_clock 시각으로 옮겨 프레임에 실어 보냅니다.
+class AppsinkFrameSource : public FrameSource {
+public:
+    explicit AppsinkFrameSource(const CaptureConfig& config);
+    ~AppsinkFrameSource() override;
+
+    bool open() override;
+    bool read(Frame& frame) override;
+    void close() override;
+    std::string name() const override { return "appsink"; }
+    CaptureStats stats() const override;
+
+private:
+    static GstFlowReturn on_new_sample(GstAppSink* sink, gpointer user_data);
+    GstFlowReturn handle_sample(GstSample* sample);
+    bool copy_buffer(GstBuffer* buffer, const GstVideoInfo& info, Frame& frame);
+    std::chrono::steady_clock::time_point to_steady(GstClockTime pts);
+    void poll_bus();
+
+    CaptureConfig config_;
+    GstElement* pipeline_ = nullptr;
+    GstElement* appsink_ = nullptr;
+
+    // 콜백(GStreamer 스트리밍 스레드) → read()(캡처 스레드). 최신 프레임만 유지
+    FrameQueue<Frame> frames_{2, QueuePolicy::DropOldest};
+
+    // 스트리밍 스레드에서만 갱신
+    FramePool frame_pool_; // 샘플을 복사해 넣을 버퍼. 캡처 단계가 조건화를 마치고 놓으면 돌아옴
+    GstClockTime last_pts_ = GST_CLOCK_TIME_NONE;
+    GstClockTime frame_interval_ = GST_CLOCK_TIME_NONE;
+    bool clock_synced_ = false;
+    int64_t steady_minus_gst_ns_ = 0;
+
+    std::atomic<uint64_t> pts_gap_dropped_{0};
+};
@@ -36,6 +36,8 @@ bool AudioNotifier::isPlaying() const {
 
 // play 함수: 재생 중이 아니면 새 스레드를 만들어 음성 재생 시작
 void AudioNotifier::play(const std::string& filename) {
+    std::lock_guard<std::mutex> lock(play_mutex_);
+
     // 이미 재생 중이면 아무것도 하지 않고 즉시 반환
     if (is_playing_.load()) {
         return;
@@ -46,6 +48,9 @@ void AudioNotifier::play(const std::string& filename) {
         player_thread_.join();
     }
 
+    // 다른 스레드가 스레드 시작 전에 끼어들지 않도록 여기서 먼저 재생 중으로 표시
+    is_playing_ = true;
+
     // play_wav_file 함수를 새 스레드에서 실행
     player_thread_ = std::thread(&AudioNotifier::play_wav_file, this, filename);
 }
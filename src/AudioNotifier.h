@@ -9,6 +9,7 @@ bool play_wav_file(const std::string& filename, const std::string& device = "plu
 #include <string>
 #include <atomic>
 #include <thread>
+#include <mutex>
 
 class AudioNotifier {
 public:
@@ -27,4 +28,5 @@ private:
     std::string device_ = "default"; // 사용할 사운드 장치 이름
     std::atomic<bool> is_playing_{false}; // 재생 상태 (스레드 충돌 방지)
     std::thread player_thread_; // 음성 재생을 위한 스레드 객체
+    std::mutex play_mutex_; // 여러 카메라 스레드가 동시에 play를 호출할 수 있음
 };
\ No newline at end of file
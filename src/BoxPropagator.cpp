@@ -0,0 +1,62 @@
+#include "BoxPropagator.h"
+#include "YuvImage.h"
+
+#include <algorithm>
+
+namespace {
+
+constexpr double kMinMatchScore = 0.5; // 이보다 낮으면 가려졌거나 모양이 바뀐 것으로 보고 위치 유지
+constexpr int kMinTemplateSize = 4;    // 저해상도에서 이보다 작은 박스는 추적하지 않음
+
+} // namespace
+
+const InferenceResult& BoxPropagator::propagate(const std::shared_ptr<const InferenceResult>& result, const Frame& frame) {
+    if (source_ != result) {
+        // 새 추론 결과: 박스 위치를 추론 시점으로 되돌리고 다시 추적
+        source_ = result;
+        propagated_ = *result;
+    }
+    if (result->reference_luma.empty()) return propagated_;
+
+    luma_thumbnail(frame.image, frame.format, kScale, current_luma_);
+    if (current_luma_.size() != result->reference_luma.size()) return propagated_;
+
+    const cv::Size size = frame_size(frame.image, frame.format);
+    for (size_t i = 0; i < propagated_.detections.size(); ++i) {
+        track_box(result->reference_luma, result->detections[i].box, propagated_.detections[i].box, size);
+    }
+    for (size_t i = 0; i < propagated_.segmentation.boxes.size(); ++i) {
+        track_box(result->reference_luma, result->segmentation.boxes[i], propagated_.segmentation.boxes[i], size);
+    }
+    return propagated_;
+}
+
+void BoxPropagator::track_box(const cv::Mat& reference, const cv::Rect& origin, cv::Rect& box, const cv::Size& frame_size) {
+    const cv::Rect bounds(0, 0, current_luma_.cols, current_luma_.rows);
+    const cv::Rect templ(origin.x / kScale, origin.y / kScale, origin.width / kScale, origin.height / kScale);
+    const cv::Rect clipped = templ & bounds;
+    if (clipped.width < kMinTemplateSize || clipped.height < kMinTemplateSize) return;
+
+    // 직전 프레임에서 찾은 위치 주변만 탐색 (박스 크기의 절반까지)
+    const cv::Point last = clipped.tl() + (box.tl() - origin.tl()) / kScale;
+    const int margin = std::max(3, std::min(clipped.width, clipped.height) / 2);
+    const cv::Rect search = cv::Rect(last.x - margin, last.y - margin,
+                                     clipped.width + 2 * margin, clipped.height + 2 * margin) & bounds;
+    if (search.width < clipped.width || search.height < clipped.height) return;
+
+    cv::matchTemplate(current_luma_(search), reference(clipped), match_, cv::TM_CCOEFF_NORMED);
+    double score = 0.0;
+    cv::Point best;
+    cv::minMaxLoc(match_, nullptr, &score, nullptr, &best);
+    if (!(score >= kMinMatchScore)) return; // 평탄한 영역이면 NaN
+
+    const cv::Point shift = (search.tl() + best - clipped.tl()) * kScale;
+    cv::Rect moved = origin + shift;
+    const cv::Rect frame_rect(0, 0, frame_size.width, frame_size.height);
+    if ((origin & frame_rect) == origin) {
+        // 블러 마스크는 박스와 크기가 같아야 적용되므로 프레임 안에 있던 박스는 밖으로 밀려나지 않게 고정
+        moved.x = std::max(0, std::min(moved.x, frame_size.width - moved.width));
+        moved.y = std::max(0, std::min(moved.y, frame_size.height - moved.height));
+    }
+    box = moved;
+}
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <memory>
+#include <opencv2/opencv.hpp>
+#include "Frame.h"
+#include "InferenceResult.h"
+
+// 추론을 건너뛴 프레임에서 마지막 추론 결과의 박스를 움직임만큼 옮겨 그리기 위한 도구.
+// 추론한 프레임의 저해상도 휘도(InferenceResult::reference_luma)에서 박스 영역을 떼어 내
+// 현재 프레임의 저해상도 휘도에서 직전에 찾은 위치 주변을 템플릿 매칭으로 찾습니다.
+// 렌더 스레드에서만 사용합니다.
+class BoxPropagator {
+public:
+    static constexpr int kScale = 4; // 움직임 추정 해상도 (1/kScale)
+
+    // result의 박스(검출 박스와 블러 영역)를 frame 시점으로 옮긴 사본을 돌려줍니다.
+    // 같은 결과로 반복 호출하면 이전 프레임에서 찾은 위치부터 이어서 찾습니다.
+    const InferenceResult& propagate(const std::shared_ptr<const InferenceResult>& result, const Frame& frame);
+
+private:
+    void track_box(const cv::Mat& reference, const cv::Rect& origin, cv::Rect& box, const cv::Size& frame_size);
+
+    std::shared_ptr<const InferenceResult> source_;
+    InferenceResult propagated_;
+    cv::Mat current_luma_;
+    cv::Mat match_;
+};
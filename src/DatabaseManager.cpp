@@ -66,15 +66,15 @@ std::string DatabaseManager::get_current_timestamp() {
 }
 
 // ★ 수정: 전역 변수 대신 멤버 변수를 사용하도록 전체 로직 구현
-std::optional<DetectionData> DatabaseManager::saveDetectionLog(int camera_id, const std::vector<DetectionResult>& results, const cv::Mat& frame, Detector& detector) {
+std::optional<DetectionData> DatabaseManager::saveDetectionLog(int camera_id, const std::vector<DetectionResult>& results, const cv::Mat& frame, const std::vector<std::string>& class_names) {
     if (results.empty()) return std::nullopt;
 
     int person_count = 0, helmet_count = 0, safety_vest_count = 0;
     double total_confidence = 0;
     std::set<std::string> unique_objects;
 
-    const auto& class_names = detector.get_class_names();
     for(const auto& res : results) {
+        if (res.class_id < 0 || res.class_id >= static_cast<int>(class_names.size())) continue;
         std::string class_name = class_names[res.class_id];
         if (class_name == "person") person_count++;
         else if (class_name == "helmet") helmet_count++;
@@ -90,7 +90,7 @@ std::optional<DetectionData> DatabaseManager::saveDetectionLog(int camera_id, co
         std::string timestamp_file = timestamp_str;
         std::replace(timestamp_file.begin(), timestamp_file.end(), ':', '-');
         std::replace(timestamp_file.begin(), timestamp_file.end(), ' ', '_');
-        image_path = image_save_dir_ + "/" + timestamp_file + ".jpg";
+        image_path = image_save_dir_ + "/cam" + std::to_string(camera_id) + "_" + timestamp_file + ".jpg";
         cv::imwrite(image_path, frame);
     }
 
@@ -212,7 +212,7 @@ std::optional<FallCountData> DatabaseManager::saveFallLog(int camera_id, int fal
     std::string timestamp_file = timestamp_str;
     std::replace(timestamp_file.begin(), timestamp_file.end(), ':', '-');
     std::replace(timestamp_file.begin(), timestamp_file.end(), ' ', '_');
-    std::string image_path = image_save_dir_ + "/" + timestamp_file + "_fall.jpg";
+    std::string image_path = image_save_dir_ + "/cam" + std::to_string(camera_id) + "_" + timestamp_file + "_fall.jpg";
     cv::imwrite(image_path, frame);
 
     sqlite3* db;
@@ -246,7 +246,7 @@ std::optional<TrespassLogData> DatabaseManager::saveTrespassLog(int camera_id, i
     std::string timestamp_file = timestamp_str;
     std::replace(timestamp_file.begin(), timestamp_file.end(), ':', '-');
     std::replace(timestamp_file.begin(), timestamp_file.end(), ' ', '_');
-    std::string image_path = image_save_dir_ + "/" + timestamp_file + "_trespass.jpg";
+    std::string image_path = image_save_dir_ + "/cam" + std::to_string(camera_id) + "_" + timestamp_file + "_trespass.jpg";
     cv::imwrite(image_path, frame);
 
     // 2. DB에 로그 저장
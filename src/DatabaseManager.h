@@ -6,7 +6,7 @@
 #include <optional> 
 
 #include "DetectionData.h"
-#include "detector.h"
+#include "types.h"
 
 class DatabaseManager {
 public:
@@ -21,7 +21,7 @@ public:
     bool getFallLogs(std::vector<FallCountData>& logs);
     bool getTrespassLogs(std::vector<TrespassLogData>& logs);
 
-    std::optional<DetectionData> saveDetectionLog(int camera_id, const std::vector<DetectionResult>& results, const cv::Mat& frame, Detector& detector);
+    std::optional<DetectionData> saveDetectionLog(int camera_id, const std::vector<DetectionResult>& results, const cv::Mat& frame, const std::vector<std::string>& class_names);
     std::optional<PersonCountData> saveBlurLog(int camera_id, int person_count);
     std::optional<FallCountData> saveFallLog(int camera_id, int fall_count, const cv::Mat& frame);
     std::optional<TrespassLogData> saveTrespassLog(int camera_id, int person_count, const cv::Mat& frame);
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <opencv2/opencv.hpp>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+
+// 프레임 버퍼의 픽셀 형식
+enum class PixelFormat {
+    Bgr,  // CV_8UC3 (height x width)
+    I420, // CV_8UC1 (height*3/2 x width): Y 평면 + U 평면 + V 평면
+    Nv12  // CV_8UC1 (height*3/2 x width): Y 평면 + UV 인터리브 평면
+};
+
+// 파이프라인 단계(캡처 → 추론 → 렌더/인코딩) 사이를 오가는 프레임
+struct Frame {
+    cv::Mat image;
+    PixelFormat format = PixelFormat::Bgr;
+    uint64_t seq = 0;                                   // 캡처 순번
+    std::chrono::steady_clock::time_point captured_at;  // 캡처 시각 (소스가 채우지 않으면 캡처 단계가 기록)
+    int64_t pts_ns = -1;                                // 소스 버퍼 PTS (없으면 -1)
+    std::shared_ptr<void> buffer_ref;                   // image가 소스 버퍼를 빌려 쓰는 뷰일 때 그 수명을 유지
+};
+
+// YUV 420 프레임은 버퍼 높이가 실제 영상 높이의 1.5배이므로 영상 크기를 따로 계산합니다.
+inline cv::Size frame_size(const cv::Mat& image, PixelFormat format) {
+    if (format == PixelFormat::Bgr) return image.size();
+    return cv::Size(image.cols, image.rows * 2 / 3);
+}
@@ -0,0 +1,40 @@
+#include "FramePool.h"
+
+void FramePool::acquire(Frame& frame, int rows, int cols, int type) {
+    std::shared_ptr<cv::Mat> free_buffer;
+    size_t in_use = 0;
+    for (const auto& buffer : buffers_) {
+        // 풀만 참조하고 있으면 모든 Frame이 놓아준 버퍼
+        if (buffer.use_count() == 1) {
+            if (!free_buffer) free_buffer = buffer;
+        } else {
+            ++in_use;
+        }
+    }
+    // 다른 스레드가 놓아주기 전에 쓴 내용을 덮어쓰지 않도록 참조 해제와 순서를 맞춤
+    std::atomic_thread_fence(std::memory_order_acquire);
+
+    if (!free_buffer) {
+        free_buffer = std::make_shared<cv::Mat>();
+        buffers_.push_back(free_buffer);
+        buffer_count_ = buffers_.size();
+    }
+    if (free_buffer->rows != rows || free_buffer->cols != cols || free_buffer->type() != type) {
+        // 처음 쓰는 버퍼이거나 캡처 해상도가 바뀐 경우에만 할당
+        free_buffer->create(rows, cols, type);
+        ++allocations_;
+    }
+    in_use_ = in_use + 1;
+
+    // frame.image는 풀 버퍼를 가리키는 뷰 (Mat 참조 카운트 없이 buffer_ref로 수명 관리)
+    frame.image = cv::Mat(rows, cols, type, free_buffer->data, free_buffer->step);
+    frame.buffer_ref = std::move(free_buffer);
+}
+
+FramePoolStats FramePool::stats() const {
+    FramePoolStats stats;
+    stats.buffers = buffer_count_.load();
+    stats.in_use = in_use_.load();
+    stats.allocations = allocations_.load();
+    return stats;
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <opencv2/opencv.hpp>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "Frame.h"
+
+// 프레임 풀 상태 스냅샷 (모니터링용)
+struct FramePoolStats {
+    size_t buffers = 0;      // 지금까지 만든 버퍼 수
+    size_t in_use = 0;       // 마지막 acquire 시점에 파이프라인이 붙잡고 있던 버퍼 수
+    uint64_t allocations = 0; // 버퍼를 새로 할당한 횟수 (워밍업 뒤에는 늘지 않아야 함)
+};
+
+// 캡처 단계가 매 프레임 쓰는 이미지 버퍼를 재사용하기 위한 풀.
+// acquire()는 아무 Frame도 참조하지 않는 버퍼를 골라 frame.image를 그 버퍼의 뷰로 만들고
+// frame.buffer_ref로 수명을 묶습니다. 프레임이 큐와 단계를 거쳐 마지막 사본까지 사라지면
+// 버퍼는 자동으로 풀에 돌아옵니다. 버퍼 수는 동시에 살아 있는 프레임 수(큐 용량 + 단계 수)까지만
+// 늘어나므로 워밍업이 끝나면 더 이상 할당하지 않습니다.
+// acquire()는 한 스레드(캡처 스레드)에서만 호출해야 합니다. 버퍼 반환은 어느 스레드에서나 됩니다.
+class FramePool {
+public:
+    FramePool() = default;
+    FramePool(const FramePool&) = delete;
+    FramePool& operator=(const FramePool&) = delete;
+
+    // rows x cols, type 크기의 버퍼를 frame에 연결합니다. 내용은 초기화하지 않습니다.
+    void acquire(Frame& frame, int rows, int cols, int type);
+
+    FramePoolStats stats() const;
+
+private:
+    std::vector<std::shared_ptr<cv::Mat>> buffers_;
+    std::atomic<size_t> buffer_count_{0};
+    std::atomic<size_t> in_use_{0};
+    std::atomic<uint64_t> allocations_{0};
+};
@@ -0,0 +1,123 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+// 큐가 가득 찼을 때의 동작
+enum class QueuePolicy {
+    DropOldest, // 가장 오래된 항목을 버리고 새 항목을 넣음 (생산자는 절대 멈추지 않음)
+    Block       // 소비자가 꺼내갈 때까지 생산자가 대기
+};
+
+// 큐 상태 스냅샷 (모니터링용)
+struct QueueStats {
+    size_t capacity = 0;
+    size_t depth = 0;
+    uint64_t pushed = 0;
+    uint64_t popped = 0;
+    uint64_t dropped = 0;
+};
+
+// 파이프라인 단계 사이를 잇는 고정 크기 링 버퍼.
+// 생산자 1개 / 소비자 1개 사용을 전제로 하며, drop-oldest 시 생산자가 head를
+// 밀어내야 하므로 슬롯 접근은 짧은 뮤텍스로 보호합니다.
+template <typename T>
+class FrameQueue {
+public:
+    explicit FrameQueue(size_t capacity, QueuePolicy policy = QueuePolicy::DropOldest)
+        : slots_(capacity > 0 ? capacity : 1), policy_(policy) {}
+
+    FrameQueue(const FrameQueue&) = delete;
+    FrameQueue& operator=(const FrameQueue&) = delete;
+
+    // 항목을 넣습니다. 큐가 닫혀 있으면 false를 반환합니다.
+    bool push(T item) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        if (policy_ == QueuePolicy::Block) {
+            not_full_.wait(lock, [this] { return closed_ || count_ < slots_.size(); });
+        }
+        if (closed_) return false;
+
+        if (count_ == slots_.size()) {
+            // DropOldest: head 슬롯을 덮어쓰고 head를 한 칸 전진
+            head_ = (head_ + 1) % slots_.size();
+            --count_;
+            ++dropped_;
+        }
+        slots_[(head_ + count_) % slots_.size()] = std::move(item);
+        ++count_;
+        ++pushed_;
+        lock.unlock();
+        not_empty_.notify_one();
+        return true;
+    }
+
+    // 항목이 들어오거나 큐가 닫힐 때까지 대기합니다.
+    // 닫힌 뒤 남은 항목이 없으면 false를 반환합니다.
+    bool pop(T& out) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        not_empty_.wait(lock, [this] { return closed_ || count_ > 0; });
+        return take_locked(out, lock);
+    }
+
+    // pop과 같지만 timeout이 지나도록 항목이 없으면 false를 반환합니다.
+    template <typename Rep, typename Period>
+    bool pop_for(T& out, const std::chrono::duration<Rep, Period>& timeout) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        not_empty_.wait_for(lock, timeout, [this] { return closed_ || count_ > 0; });
+        return take_locked(out, lock);
+    }
+
+    // 대기하지 않고 꺼낼 수 있는 항목이 있을 때만 꺼냅니다.
+    bool try_pop(T& out) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        return take_locked(out, lock);
+    }
+
+    // 대기 중인 생산자/소비자를 모두 깨우고 이후 push를 거부합니다.
+    void close() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            closed_ = true;
+        }
+        not_empty_.notify_all();
+        not_full_.notify_all();
+    }
+
+    QueueStats stats() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return {slots_.size(), count_, pushed_, popped_, dropped_};
+    }
+
+private:
+    bool take_locked(T& out, std::unique_lock<std::mutex>& lock) {
+        if (count_ == 0) return false;
+        out = std::move(slots_[head_]);
+        slots_[head_] = T(); // 버퍼 참조를 즉시 놓아줌
+        head_ = (head_ + 1) % slots_.size();
+        --count_;
+        ++popped_;
+        lock.unlock();
+        not_full_.notify_one();
+        return true;
+    }
+
+    std::vector<T> slots_;
+    const QueuePolicy policy_;
+    size_t head_ = 0;
+    size_t count_ = 0;
+    bool closed_ = false;
+
+    uint64_t pushed_ = 0;
+    uint64_t popped_ = 0;
+    uint64_t dropped_ = 0;
+
+    mutable std::mutex mutex_;
+    std::condition_variable not_empty_;
+    std::condition_variable not_full_;
+};
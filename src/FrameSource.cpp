@@ -0,0 +1,234 @@
+#include "FrameSource.h"
+#include "V4l2FrameSource.h"
+#include "YuvImage.h"
+#ifdef HAVE_GST_APPSINK
+#include "AppsinkFrameSource.h"
+#endif
+
+#include <algorithm>
+#include <filesystem>
+#include <iostream>
+#include <stdexcept>
+#include <thread>
+
+namespace fs = std::filesystem;
+
+// --- FramePacer ---
+
+FramePacer::FramePacer(int framerate, bool enabled)
+    : enabled_(enabled && framerate > 0),
+      interval_(std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+          std::chrono::duration<double>(1.0 / std::max(framerate, 1)))),
+      next_(std::chrono::steady_clock::now()) {}
+
+void FramePacer::wait() {
+    if (!enabled_) return;
+    auto now = std::chrono::steady_clock::now();
+    if (next_ > now) {
+        std::this_thread::sleep_until(next_);
+        next_ += interval_;
+    } else {
+        // 뒤처졌으면 밀린 만큼 몰아서 보내지 않고 기준 시각을 다시 잡음
+        next_ = now + interval_;
+    }
+}
+
+// --- GStreamerFrameSource ---
+
+std::string camera_source_pipeline(const CaptureConfig& config) {
+    std::string caps = "video/x-raw, width=" + std::to_string(config.width) +
+                       ", height=" + std::to_string(config.height) +
+                       ", framerate=" + std::to_string(config.framerate) + "/1";
+
+    // YUV 형식은 카메라 출력을 그대로 appsink로 넘김 (OpenCV는 height*3/2 x width 단일 채널 Mat으로 전달)
+    std::string convert;
+    switch (config.format) {
+        case PixelFormat::I420: caps += ", format=I420"; break;
+        case PixelFormat::Nv12: caps += ", format=NV12"; break;
+        case PixelFormat::Bgr:  convert = "videoconvert ! video/x-raw, format=BGR ! "; break;
+    }
+    return "libcamerasrc ! " + caps + " ! " + convert;
+}
+
+GStreamerFrameSource::GStreamerFrameSource(const CaptureConfig& config) : config_(config) {}
+
+bool GStreamerFrameSource::open() {
+    // Python의 picam2 설정과 유사한 최적화된 파이프라인
+    // sync=false, max-buffers=1, drop=true로 설정하여 최대한 딜레이 감소
+    cap_.open(camera_source_pipeline(config_) + "appsink sync=false max-buffers=1 drop=true", cv::CAP_GSTREAMER);
+    return cap_.isOpened();
+}
+
+bool GStreamerFrameSource::read(Frame& frame) {
+    if (!cap_.read(frame.image)) return false;
+    frame.format = config_.format;
+    return true;
+}
+
+void GStreamerFrameSource::close() {
+    if (cap_.isOpened()) cap_.release();
+}
+
+// --- FileFrameSource ---
+
+FileFrameSource::FileFrameSource(const CaptureConfig& config)
+    : config_(config), pacer_(config.framerate, config.paced) {}
+
+bool FileFrameSource::open() {
+    const cv::Size target(config_.width, config_.height);
+
+    if (fs::is_directory(config_.path)) {
+        std::vector<fs::path> files;
+        for (const auto& entry : fs::directory_iterator(config_.path)) {
+            std::string ext = entry.path().extension().string();
+            std::transform(ext.begin(), ext.end(), ext.begin(), ::tolower);
+            if (ext == ".jpg" || ext == ".jpeg" || ext == ".png" || ext == ".bmp") {
+                files.push_back(entry.path());
+            }
+        }
+        // 실행할 때마다 같은 순서로 재생되도록 정렬
+        std::sort(files.begin(), files.end());
+
+        for (const auto& file : files) {
+            cv::Mat image = cv::imread(file.string(), cv::IMREAD_COLOR);
+            if (image.empty()) {
+                std::cerr << "[WARN] 이미지를 읽을 수 없습니다: " << file << std::endl;
+                continue;
+            }
+            if (image.size() != target) cv::resize(image, image, target);
+            // 재생 중 변환하지 않도록 미리 캡처 형식으로 바꿔 둠
+            if (config_.format != PixelFormat::Bgr) bgr_to_yuv420(image, config_.format, image);
+            images_.push_back(image);
+        }
+        if (images_.empty()) {
+            std::cerr << "오류: 디렉터리에 재생할 이미지가 없습니다: " << config_.path << std::endl;
+            return false;
+        }
+        std::cout << "[INFO] 이미지 " << images_.size() << "장을 반복 재생합니다: " << config_.path << std::endl;
+        return true;
+    }
+
+    cap_.open(config_.path);
+    if (!cap_.isOpened()) {
+        std::cerr << "오류: 동영상 파일을 열 수 없습니다: " << config_.path << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool FileFrameSource::read(Frame& frame) {
+    if (finished_) {
+        // 반복 재생을 끈 경우 마지막 이후로는 프레임을 내보내지 않음
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        return false;
+    }
+
+    pacer_.wait();
+
+    if (!images_.empty()) {
+        // 캡처 단계는 원본을 조건화해 별도 버퍼에 옮기므로 복사 없이 그대로 넘김
+        frame.image = images_[image_index_];
+        frame.format = config_.format;
+        if (++image_index_ == images_.size()) {
+            image_index_ = 0;
+            finished_ = !config_.loop;
+        }
+        return true;
+    }
+    if (config_.format == PixelFormat::Bgr) {
+        if (!read_video(frame.image)) return false;
+    } else {
+        // 디코더 출력은 BGR이므로 YUV 형식이면 여기서 한 번 변환 (디코드 버퍼는 재사용)
+        if (!read_video(decoded_)) return false;
+        bgr_to_yuv420(decoded_, config_.format, frame.image);
+    }
+    frame.format = config_.format;
+    return true;
+}
+
+bool FileFrameSource::read_video(cv::Mat& image) {
+    if (!cap_.read(image)) {
+        if (!config_.loop) {
+            finished_ = true;
+            return false;
+        }
+        // 처음으로 되감기 (되감기를 지원하지 않는 컨테이너는 다시 열기)
+        if (!cap_.set(cv::CAP_PROP_POS_FRAMES, 0) || !cap_.read(image)) {
+            cap_.release();
+            cap_.open(config_.path);
+            if (!cap_.read(image)) return false;
+        }
+    }
+    const cv::Size target(config_.width, config_.height);
+    if (image.size() != target) cv::resize(image, image, target);
+    return true;
+}
+
+void FileFrameSource::close() {
+    if (cap_.isOpened()) cap_.release();
+    images_.clear();
+}
+
+// --- SyntheticFrameSource ---
+
+SyntheticFrameSource::SyntheticFrameSource(const CaptureConfig& config)
+    : config_(config), pacer_(config.framerate, config.paced) {}
+
+bool SyntheticFrameSource::open() {
+    // 가로 그라디언트 배경을 한 번만 만들어 둠
+    background_.create(config_.height, config_.width, CV_8UC3);
+    for (int y = 0; y < background_.rows; ++y) {
+        cv::Vec3b* row = background_.ptr<cv::Vec3b>(y);
+        for (int x = 0; x < background_.cols; ++x) {
+            row[x] = cv::Vec3b(static_cast<uchar>(x * 255 / background_.cols),
+                               static_cast<uchar>(y * 255 / background_.rows),
+                               96);
+        }
+    }
+    if (config_.format != PixelFormat::Bgr) bgr_to_yuv420(background_, config_.format, background_);
+    return true;
+}
+
+bool SyntheticFrameSource::read(Frame& frame) {
+    pacer_.wait();
+
+    // 호출자가 같은 Frame을 계속 넘기면 이전 버퍼에 덮어씀
+    background_.copyTo(frame.image);
+    frame.format = config_.format;
+
+    // 프레임 번호에만 의존하는 위치로 박스를 움직여 매 실행 결과가 동일하도록 함
+    const int box_w = config_.width / 6;
+    const int box_h = config_.height / 3;
+    const int travel = std::max(config_.width - box_w, 1);
+    const int step = static_cast<int>((frame_index_ * 4) % (2 * travel));
+    const int x = step < travel ? step : 2 * travel - step;
+    const cv::Rect box(x, config_.height / 3, box_w, box_h);
+    const std::string label = "SYNTHETIC #" + std::to_string(frame_index_);
+    if (config_.format == PixelFormat::Bgr) {
+        cv::rectangle(frame.image, box, cv::Scalar(40, 40, 220), -1);
+        cv::putText(frame.image, label, cv::Point(10, 30), cv::FONT_HERSHEY_SIMPLEX, 0.7, cv::Scalar(255, 255, 255), 2);
+    } else {
+        yuv420_rectangle(frame.image, config_.format, box, cv::Scalar(40, 40, 220), -1);
+        yuv420_text(frame.image, label, cv::Point(10, 30), 0.7, cv::Scalar(255, 255, 255), 2);
+    }
+
+    ++frame_index_;
+    return true;
+}
+
+// --- factory ---
+
+std::unique_ptr<FrameSource> createFrameSource(const CaptureConfig& config) {
+    if (config.backend == "gstreamer") return std::make_unique<GStreamerFrameSource>(config);
+    if (config.backend == "appsink") {
+#ifdef HAVE_GST_APPSINK
+        return std::make_unique<AppsinkFrameSource>(config);
+#else
+        throw std::runtime_error("appsink 백엔드는 gstreamer-app-1.0 없이 빌드되었습니다");
+#endif
+    }
+    if (config.backend == "v4l2") return std::make_unique<V4l2FrameSource>(config);
+    if (config.backend == "file") return std::make_unique<FileFrameSource>(config);
+    if (config.backend == "synthetic") return std::make_unique<SyntheticFrameSource>(config);
+    throw std::runtime_error("지원하지 않는 캡처 백엔드: " + config.backend);
+}
@@ -0,0 +1,100 @@
+#pragma once
+
+#include <opencv2/opencv.hpp>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+#include "Frame.h"
+#include "ServerConfig.h"
+
+// 소스 단계 통계 (모니터링용)
+struct CaptureStats {
+    uint64_t delivered = 0; // 파이프라인에 넘긴 프레임 수
+    uint64_t dropped = 0;   // 소스에서 버려진 프레임 수 (PTS 간격으로 추정)
+};
+
+// 캡처 단계가 프레임을 받아오는 곳. 카메라 없이도 파이프라인 전체를
+// 돌릴 수 있도록 백엔드를 설정으로 고릅니다.
+class FrameSource {
+public:
+    virtual ~FrameSource() = default;
+
+    virtual bool open() = 0;
+
+    // 다음 프레임을 frame.image에 채웁니다. 아직 프레임이 없으면 false를 반환하며
+    // 캡처 루프가 잠시 후 다시 시도합니다. 소스가 버퍼 시각을 알면 captured_at/pts_ns도 채웁니다.
+    virtual bool read(Frame& frame) = 0;
+
+    virtual void close() {}
+    virtual std::string name() const = 0;
+    virtual CaptureStats stats() const { return {}; }
+};
+
+// 설정된 framerate에 맞춰 프레임 전달 간격을 맞추는 헬퍼
+class FramePacer {
+public:
+    FramePacer(int framerate, bool enabled);
+    void wait();
+
+private:
+    bool enabled_;
+    std::chrono::steady_clock::duration interval_;
+    std::chrono::steady_clock::time_point next_;
+};
+
+// libcamerasrc부터 appsink 직전까지의 GStreamer 파이프라인 문자열 ("... ! " 로 끝남)
+std::string camera_source_pipeline(const CaptureConfig& config);
+
+// libcamerasrc GStreamer 파이프라인 (라즈베리파이 카메라, OpenCV VideoCapture 사용)
+class GStreamerFrameSource : public FrameSource {
+public:
+    explicit GStreamerFrameSource(const CaptureConfig& config);
+    bool open() override;
+    bool read(Frame& frame) override;
+    void close() override;
+    std::string name() const override { return "gstreamer"; }
+
+private:
+    CaptureConfig config_;
+    cv::VideoCapture cap_;
+};
+
+// 동영상 파일 또는 이미지 디렉터리를 반복 재생
+class FileFrameSource : public FrameSource {
+public:
+    explicit FileFrameSource(const CaptureConfig& config);
+    bool open() override;
+    bool read(Frame& frame) override;
+    void close() override;
+    std::string name() const override { return "file"; }
+
+private:
+    bool read_video(cv::Mat& image);
+
+    CaptureConfig config_;
+    FramePacer pacer_;
+    cv::VideoCapture cap_;
+    std::vector<cv::Mat> images_; // 이미지 디렉터리는 미리 메모리에 올려둠
+    cv::Mat decoded_;             // YUV 출력일 때 BGR 디코드 버퍼 (재사용)
+    size_t image_index_ = 0;
+    bool finished_ = false;
+};
+
+// 움직이는 박스가 그려진 결정적(deterministic) 테스트 패턴
+class SyntheticFrameSource : public FrameSource {
+public:
+    explicit SyntheticFrameSource(const CaptureConfig& config);
+    bool open() override;
+    bool read(Frame& frame) override;
+    std::string name() const override { return "synthetic"; }
+
+private:
+    CaptureConfig config_;
+    FramePacer pacer_;
+    cv::Mat background_; // config_.format 형식으로 미리 변환된 배경
+    uint64_t frame_index_ = 0;
+};
+
+// config.backend 값에 맞는 프레임 소스를 생성합니다.
+std::unique_ptr<FrameSource> createFrameSource(const CaptureConfig& config);
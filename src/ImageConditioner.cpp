@@ -0,0 +1,135 @@
+#include "ImageConditioner.h"
+
+#include <opencv2/core/hal/intrin.hpp>
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+// 3x3 가우시안(σ 자동 = [1 2 1]/4 ⊗ [1 2 1]/4)과 LUT를 한 행씩 처리합니다.
+// 경계는 cv::GaussianBlur 기본값과 같은 BORDER_REFLECT_101.
+// 세로 합을 uint16 행 버퍼에 만든 뒤 가로 합/반올림/팩을 같은 행에서 이어 하므로
+// 한 행의 데이터가 캐시에 있는 동안 블러와 곡선이 모두 끝납니다.
+void blur3x3_lut(const cv::Mat& src, cv::Mat& dst, const uchar* lut, std::vector<uint16_t>& vertical_sum) {
+    const int rows = src.rows;
+    const int cn = src.channels();
+    const int n = src.cols * cn;
+    vertical_sum.resize(n);
+    uint16_t* v = vertical_sum.data();
+
+    for (int y = 0; y < rows; ++y) {
+        const uchar* r0 = src.ptr<uchar>(y > 0 ? y - 1 : std::min(1, rows - 1));
+        const uchar* r1 = src.ptr<uchar>(y);
+        const uchar* r2 = src.ptr<uchar>(y < rows - 1 ? y + 1 : std::max(rows - 2, 0));
+        uchar* out = dst.ptr<uchar>(y);
+
+        // 세로: r0 + 2*r1 + r2 (최대 1020)
+        int i = 0;
+#if CV_SIMD
+        constexpr int kLanes8 = CV_SIMD_WIDTH;
+        for (; i <= n - kLanes8; i += kLanes8) {
+            cv::v_uint16 a0, a1, b0, b1, c0, c1;
+            cv::v_expand(cv::vx_load(r0 + i), a0, a1);
+            cv::v_expand(cv::vx_load(r1 + i), b0, b1);
+            cv::v_expand(cv::vx_load(r2 + i), c0, c1);
+            cv::v_store(v + i, a0 + (b0 << 1) + c0);
+            cv::v_store(v + i + kLanes8 / 2, a1 + (b1 << 1) + c1);
+        }
+#endif
+        for (; i < n; ++i) v[i] = static_cast<uint16_t>(r0[i] + 2 * r1[i] + r2[i]);
+
+        // 가로: (v[x-1] + 2*v[x] + v[x+1] + 8) >> 4, 이웃 픽셀은 채널 수만큼 떨어져 있음
+        const int left_end = std::min(cn, n);
+        int k = 0;
+        for (; k < left_end; ++k) {
+            const int side = n > cn ? v[k + cn] : v[k];
+            out[k] = static_cast<uchar>((2 * side + 2 * v[k] + 8) >> 4);
+        }
+        const int interior_end = n - cn;
+#if CV_SIMD
+        constexpr int kLanes16 = CV_SIMD_WIDTH / 2;
+        const cv::v_uint16 round = cv::vx_setall_u16(8);
+        for (; k <= interior_end - 2 * kLanes16; k += 2 * kLanes16) {
+            const cv::v_uint16 s0 = cv::vx_load(v + k - cn) + (cv::vx_load(v + k) << 1) + cv::vx_load(v + k + cn) + round;
+            const cv::v_uint16 s1 = cv::vx_load(v + k + kLanes16 - cn) + (cv::vx_load(v + k + kLanes16) << 1) +
+                                    cv::vx_load(v + k + kLanes16 + cn) + round;
+            cv::v_store(out + k, cv::v_pack(s0 >> 4, s1 >> 4));
+        }
+#endif
+        for (; k < interior_end; ++k) {
+            out[k] = static_cast<uchar>((v[k - cn] + 2 * v[k] + v[k + cn] + 8) >> 4);
+        }
+        for (; k < n; ++k) {
+            const int side = k >= cn ? v[k - cn] : v[k];
+            out[k] = static_cast<uchar>((2 * side + 2 * v[k] + 8) >> 4);
+        }
+
+        // 곡선: 방금 쓴 행이 캐시에 있을 때 바로 LUT 적용
+        if (lut) {
+            for (int j = 0; j < n; ++j) out[j] = lut[out[j]];
+        }
+    }
+#if CV_SIMD
+    cv::vx_cleanup();
+#endif
+}
+
+} // namespace
+
+ImageConditioner::ImageConditioner(Kernel kernel) : kernel_(kernel), lut_(1, 256, CV_8UC1) {
+    for (int i = 0; i < 256; ++i) lut_.at<uchar>(i) = static_cast<uchar>(i);
+}
+
+void ImageConditioner::set_curve(int beta, double contrast, double gamma) {
+    if (beta == beta_ && contrast == contrast_ && gamma == gamma_) return;
+    beta_ = beta;
+    contrast_ = contrast;
+    gamma_ = gamma > 0.0 ? gamma : 1.0;
+
+    identity_ = true;
+    for (int i = 0; i < 256; ++i) {
+        double value = std::min(255.0, std::max(0.0, contrast_ * i + beta_));
+        if (gamma_ != 1.0) value = 255.0 * std::pow(value / 255.0, 1.0 / gamma_);
+        const uchar mapped = cv::saturate_cast<uchar>(value);
+        lut_.at<uchar>(i) = mapped;
+        if (mapped != i) identity_ = false;
+    }
+}
+
+void ImageConditioner::apply(const cv::Mat& src, PixelFormat format, cv::Mat& dst) {
+    dst.create(src.size(), src.type());
+    if (format == PixelFormat::Bgr) {
+        apply_plane(src, dst);
+        return;
+    }
+
+    // YUV: 블러와 곡선은 휘도(Y) 평면에만 적용하고 색차 평면은 그대로 복사합니다.
+    const int luma_rows = src.rows * 2 / 3;
+    cv::Mat dst_luma = dst.rowRange(0, luma_rows);
+    apply_plane(src.rowRange(0, luma_rows), dst_luma);
+    src.rowRange(luma_rows, src.rows).copyTo(dst.rowRange(luma_rows, dst.rows));
+}
+
+void ImageConditioner::apply_plane(const cv::Mat& src, cv::Mat& dst) {
+    if (kernel_ == Kernel::Fused && src.depth() == CV_8U && src.data != dst.data) {
+        blur3x3_lut(src, dst, identity_ ? nullptr : lut_.ptr<uchar>(), vertical_sum_);
+        return;
+    }
+    cv::GaussianBlur(src, dst, cv::Size(3, 3), 0);
+    if (!identity_) cv::LUT(dst, lut_, dst);
+}
+
+bool ImageConditioner::parse_kernel(const std::string& name, Kernel& kernel) {
+    if (name == "fused") {
+        kernel = Kernel::Fused;
+    } else if (name == "opencv") {
+        kernel = Kernel::OpenCv;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+const char* ImageConditioner::kernel_name(Kernel kernel) {
+    return kernel == Kernel::Fused ? "fused" : "opencv";
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <opencv2/opencv.hpp>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "Frame.h"
+
+// 캡처 프레임 조건화: 3x3 가우시안 블러 + 밝기/대비/감마 곡선.
+//  - Fused:  블러와 곡선(256칸 LUT)을 행 단위로 한 번에 처리하는 커널.
+//            OpenCV universal intrinsics로 작성해 Pi에서는 NEON, x86에서는 SSE/AVX로 컴파일됩니다.
+//  - OpenCv: cv::GaussianBlur 뒤에 곡선이 항등이 아니면 cv::LUT를 따로 돌리는 기존 방식.
+// 캡처 스레드 전용이며 LUT와 행 버퍼를 재사용합니다.
+class ImageConditioner {
+public:
+    enum class Kernel { Fused, OpenCv };
+
+    explicit ImageConditioner(Kernel kernel = Kernel::Fused);
+
+    // 곡선 y = 255 * ((contrast * x + beta) / 255)^(1/gamma). 값이 바뀐 경우에만 LUT를 다시 만듭니다.
+    void set_curve(int beta, double contrast, double gamma);
+
+    // src를 조건화해 dst에 씁니다. dst가 이미 같은 크기/형식이면 그 버퍼를 그대로 사용합니다.
+    // YUV 420 프레임은 휘도 평면에만 블러/곡선을 적용하고 색차 평면은 복사합니다.
+    void apply(const cv::Mat& src, PixelFormat format, cv::Mat& dst);
+
+    Kernel kernel() const { return kernel_; }
+
+    // "fused" / "opencv"
+    static bool parse_kernel(const std::string& name, Kernel& kernel);
+    static const char* kernel_name(Kernel kernel);
+
+private:
+    void apply_plane(const cv::Mat& src, cv::Mat& dst); // 8비트 1채널 또는 인터리브 다채널 평면
+
+    Kernel kernel_;
+    cv::Mat lut_;          // 1x256 CV_8UC1
+    bool identity_ = true; // 곡선이 항등이면 LUT 단계를 건너뜀
+    int beta_ = 0;
+    double contrast_ = 1.0;
+    double gamma_ = 1.0;
+    std::vector<uint16_t> vertical_sum_; // Fused: 세로 [1 2 1] 합 한 행
+};
@@ -0,0 +1,536 @@
+#include "InferenceEngine.h"
+#include "InferenceResult.h"
+#include "YuvImage.h"
+#include "detector.h"
+#include "fall.h"
+#include "segmenter.h"
+
+#include <algorithm>
+#include <atomic>
+#include <iostream>
+
+namespace {
+
+bool uses_detector(const std::string& mode) { return mode == "detect" || mode == "trespass"; }
+
+// 같은 모델 인스턴스를 쓰는 모드끼리만 한 배치로 묶을 수 있음
+std::string model_group(const std::string& mode) {
+    if (uses_detector(mode)) return "detector";
+    if (mode == "fall") return "fall";
+    if (mode == "blur") return "segmenter";
+    return "";
+}
+
+// 여러 크롭에서 합친 검출을 클래스별로 다시 NMS
+void suppress_duplicates(std::vector<DetectionResult>& detections, float nms_threshold) {
+    // 워커 스레드에서만 호출되므로 스레드별 버퍼를 재사용
+    thread_local std::vector<DetectionResult> kept;
+    thread_local std::vector<int> class_ids;
+    thread_local std::vector<cv::Rect> boxes;
+    thread_local std::vector<float> scores;
+    thread_local std::vector<size_t> index;
+    thread_local std::vector<int> keep;
+    kept.clear();
+    class_ids.clear();
+    for (const auto& det : detections) {
+        if (std::find(class_ids.begin(), class_ids.end(), det.class_id) == class_ids.end()) class_ids.push_back(det.class_id);
+    }
+    for (int class_id : class_ids) {
+        boxes.clear();
+        scores.clear();
+        index.clear();
+        keep.clear();
+        for (size_t i = 0; i < detections.size(); ++i) {
+            if (detections[i].class_id != class_id) continue;
+            boxes.push_back(detections[i].box);
+            scores.push_back(detections[i].confidence);
+            index.push_back(i);
+        }
+        cv::dnn::NMSBoxes(boxes, scores, 0.0f, nms_threshold, keep);
+        for (int k : keep) kept.push_back(detections[index[k]]);
+    }
+    detections.swap(kept);
+}
+
+} // namespace
+
+InferenceEngine::InferenceEngine(const ModelConfig& config, const InferenceConfig& inference)
+    : max_batch_(static_cast<size_t>(std::max(1, inference.max_batch))),
+      batch_window_(std::max(0, inference.batch_window_ms)),
+      prewarm_(config.prewarm),
+      batch_wait_hist_({0.5, 1, 2, 5, 10, 20, 50, 100}),
+      models_(config) {
+    // 모델을 만들기 전에 스레드 수를 정해 둠
+    InferenceThreadPool::configure(inference);
+    std::vector<double> sizes;
+    for (size_t n = 1; n <= max_batch_; ++n) sizes.push_back(static_cast<double>(n));
+    batch_size_hist_ = Histogram(sizes);
+}
+
+InferenceEngine::~InferenceEngine() {
+    stop();
+}
+
+void InferenceEngine::start() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (running_) return;
+        running_ = true;
+        if (prewarm_) {
+            // 아무 카메라도 쓰지 않는 모델도 미리 올려, 처음 모드를 바꿀 때도 기다리지 않게 함
+            for (const char* group : {"detector", "fall", "segmenter"}) request_load_locked(group);
+        }
+        worker_ = std::thread(&InferenceEngine::worker_loop, this);
+        loader_ = std::thread(&InferenceEngine::loader_loop, this);
+    }
+    loader_cv_.notify_one();
+}
+
+void InferenceEngine::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!running_) return;
+        running_ = false;
+        // 기다리던 카메라는 nullptr을 받고 돌아감
+        for (auto& slot : slots_) slot->done.notify_all();
+    }
+    work_cv_.notify_all();
+    loader_cv_.notify_all();
+    if (worker_.joinable()) worker_.join();
+    // 로드 중인 모델이 있으면 끝날 때까지 기다림
+    if (loader_.joinable()) loader_.join();
+}
+
+void InferenceEngine::registerCamera(int camera_id, const std::string& mode) {
+    std::vector<ModelLoadEvent> events;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto slot = std::make_unique<CameraSlot>();
+        slot->camera_id = camera_id;
+        slot->mode = "raw"; // 시작 모드의 모델이 준비될 때까지는 원본 송출
+        apply_mode_locked(*slot, mode, events);
+        slots_.push_back(std::move(slot));
+        models_dirty_ = true;
+    }
+    loader_cv_.notify_one();
+    emit(events);
+}
+
+void InferenceEngine::setCameraMode(int camera_id, const std::string& mode) {
+    std::vector<ModelLoadEvent> events;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (auto& slot : slots_) {
+            if (slot->camera_id == camera_id) apply_mode_locked(*slot, mode, events);
+        }
+    }
+    work_cv_.notify_one();
+    loader_cv_.notify_one();
+    emit(events);
+}
+
+std::string InferenceEngine::activeMode(int camera_id) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto& slot : slots_) {
+        if (slot->camera_id == camera_id) return slot->mode;
+    }
+    return "stop";
+}
+
+void InferenceEngine::onModelLoad(std::function<void(const ModelLoadEvent&)> callback) {
+    model_load_callback_ = std::move(callback);
+}
+
+void InferenceEngine::apply_mode_locked(CameraSlot& slot, const std::string& mode, std::vector<ModelLoadEvent>& events) {
+    slot.requested_mode = mode;
+    const std::string group = model_group(mode);
+    const auto& loaded = model_pool_stats_.loaded;
+    if (group.empty() || std::find(loaded.begin(), loaded.end(), group) != loaded.end()) {
+        if (slot.mode != mode) {
+            slot.mode = mode;
+            models_dirty_ = true;
+        }
+        return;
+    }
+    // 이전 모드는 새 모델이 준비될 때까지 그대로 추론
+    std::cout << "[CAM " << slot.camera_id << "] 모델 로드를 기다리는 동안 '" << slot.mode << "' 모드를 유지합니다: "
+              << mode << std::endl;
+    request_load_locked(group);
+    ModelLoadEvent event;
+    event.model = group;
+    event.state = "loading";
+    event.camera_ids.push_back(slot.camera_id);
+    events.push_back(std::move(event));
+}
+
+void InferenceEngine::request_load_locked(const std::string& group) {
+    if (std::find(loading_.begin(), loading_.end(), group) != loading_.end()) return;
+    loading_.push_back(group);
+    load_queue_.push_back(group);
+}
+
+void InferenceEngine::emit(const std::vector<ModelLoadEvent>& events) const {
+    if (!model_load_callback_) return;
+    for (const auto& event : events) model_load_callback_(event);
+}
+
+std::shared_ptr<InferenceResult> InferenceEngine::infer(int camera_id, const Frame& frame, const std::string& mode,
+                                                        const std::vector<cv::Rect>& rois) {
+    // 모델이 필요 없는 모드는 워커를 거치지 않음
+    if (mode != "detect" && mode != "trespass" && mode != "fall" && mode != "blur") return nullptr;
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    auto it = std::find_if(slots_.begin(), slots_.end(),
+                           [camera_id](const auto& slot) { return slot->camera_id == camera_id; });
+    if (it == slots_.end() || !running_) return nullptr;
+
+    CameraSlot& slot = **it;
+    slot.frame = &frame;
+    slot.request_mode = mode;
+    slot.request_rois = rois;
+    slot.result.reset();
+    slot.pending = true;
+    slot.requested_at = std::chrono::steady_clock::now();
+    ++slot.requests;
+    work_cv_.notify_one();
+
+    slot.done.wait(lock, [&] { return !slot.pending || !running_; });
+    slot.pending = false;
+    slot.frame = nullptr;
+    return std::move(slot.result);
+}
+
+EngineStats InferenceEngine::getStats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    EngineStats stats;
+    for (const auto& slot : slots_) {
+        stats.cameras.push_back({slot->camera_id, slot->mode, slot->requested_mode, slot->requests, slot->served});
+    }
+    stats.loaded_models = model_pool_stats_.loaded;
+    stats.model_pool = model_pool_stats_;
+    stats.threads = InferenceThreadPool::instance().stats();
+    stats.max_batch = static_cast<int>(max_batch_);
+    stats.batch_window_ms = static_cast<int>(batch_window_.count());
+    stats.batches = batches_;
+    stats.batch_size = batch_size_hist_;
+    stats.batch_wait_ms = batch_wait_hist_;
+    return stats;
+}
+
+const InferenceEngine::CameraSlot* InferenceEngine::peek_pending_locked() const {
+    const size_t count = slots_.size();
+    for (size_t i = 0; i < count; ++i) {
+        const CameraSlot* slot = slots_[(next_slot_ + i) % count].get();
+        if (slot->pending) return slot;
+    }
+    return nullptr;
+}
+
+bool InferenceEngine::batch_ready_locked(const std::string& group) const {
+    size_t pending = 0;
+    size_t users = 0; // 지금 이 모델을 쓰는 모드의 카메라 수 (카메라당 요청은 하나뿐)
+    for (const auto& slot : slots_) {
+        if (slot->pending && model_group(slot->request_mode) == group) ++pending;
+        if (model_group(slot->mode) == group) ++users;
+    }
+    return pending >= max_batch_ || pending >= users;
+}
+
+void InferenceEngine::take_batch_locked(std::vector<CameraSlot*>& batch) {
+    batch.clear();
+    const size_t count = slots_.size();
+    std::string group;
+    size_t last = next_slot_;
+    for (size_t i = 0; i < count && batch.size() < max_batch_; ++i) {
+        const size_t index = (next_slot_ + i) % count;
+        CameraSlot* slot = slots_[index].get();
+        if (!slot->pending) continue;
+        if (batch.empty()) {
+            group = model_group(slot->request_mode);
+        } else if (model_group(slot->request_mode) != group) {
+            continue;
+        }
+        batch.push_back(slot);
+        last = index;
+    }
+    // 마지막으로 묶은 카메라 다음부터 다시 찾도록 커서를 옮겨 공정하게 돌아가게 함
+    if (!batch.empty()) next_slot_ = (last + 1) % count;
+}
+
+void InferenceEngine::worker_loop() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (running_) {
+        work_cv_.wait(lock, [this] {
+            if (!running_ || models_dirty_ || !ready_models_.empty()) return true;
+            return std::any_of(slots_.begin(), slots_.end(), [](const auto& slot) { return slot->pending; });
+        });
+        if (!running_) break;
+
+        // 로드가 끝난 모델은 배치 사이에서만 풀에 넣으므로 추론 중인 모델이 바뀌는 일이 없음
+        if (!ready_models_.empty()) {
+            install_ready_models(lock);
+            continue;
+        }
+
+        if (models_dirty_) {
+            models_dirty_ = false;
+            std::vector<std::string> modes;
+            for (const auto& slot : slots_) modes.push_back(slot->mode);
+            lock.unlock();
+            update_models(modes);
+            lock.lock();
+            continue;
+        }
+
+        const CameraSlot* first = peek_pending_locked();
+        if (!first) continue;
+
+        // 배치 창: 가장 먼저 들어온 요청 기준으로 같은 모델을 쓰는 다른 카메라의 요청을 잠시 기다림
+        if (batch_window_.count() > 0 && max_batch_ > 1) {
+            const std::string group = model_group(first->request_mode);
+            const auto deadline = first->requested_at + batch_window_;
+            work_cv_.wait_until(lock, deadline, [&] { return !running_ || batch_ready_locked(group); });
+            if (!running_) break;
+        }
+
+        std::vector<CameraSlot*>& batch = batch_slots_;
+        take_batch_locked(batch);
+        if (batch.empty()) continue;
+
+        const auto started_at = std::chrono::steady_clock::now();
+        ++batches_;
+        batch_size_hist_.record(static_cast<double>(batch.size()));
+
+        // 요청한 카메라는 결과를 받을 때까지 프레임을 붙잡고 대기하므로 잠금 없이 읽어도 안전
+        batch_frames_.clear();
+        batch_modes_.resize(batch.size());
+        batch_rois_.resize(batch.size());
+        for (size_t i = 0; i < batch.size(); ++i) {
+            CameraSlot* slot = batch[i];
+            batch_wait_hist_.record(std::chrono::duration<double, std::milli>(started_at - slot->requested_at).count());
+            batch_frames_.push_back(slot->frame);
+            batch_modes_[i] = slot->request_mode;
+            batch_rois_[i] = slot->request_rois;
+        }
+        lock.unlock();
+        std::vector<std::shared_ptr<InferenceResult>>& results = batch_results_;
+        run_batch(batch_frames_, batch_modes_, batch_rois_, results);
+        lock.lock();
+
+        for (size_t i = 0; i < batch.size(); ++i) {
+            batch[i]->result = std::move(results[i]);
+            batch[i]->pending = false;
+            ++batch[i]->served;
+            batch[i]->done.notify_one();
+        }
+    }
+}
+
+void InferenceEngine::loader_loop() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (running_) {
+        loader_cv_.wait(lock, [this] { return !running_ || !load_queue_.empty(); });
+        if (!running_) break;
+        const std::string group = load_queue_.front();
+        load_queue_.pop_front();
+        lock.unlock();
+
+        // 모델 생성과 워밍업은 몇 초 걸릴 수 있으므로 워커(다른 카메라의 추론)를 막지 않고 여기서 함
+        const auto started = std::chrono::steady_clock::now();
+        LoadedModel model;
+        std::string error;
+        try {
+            model = models_.build(group);
+        } catch (const std::exception& e) {
+            // Ort::Exception(segmenter)과 std::runtime_error(TFLite 모델) 모두 여기서 처리
+            error = e.what();
+        }
+
+        lock.lock();
+        if (error.empty()) {
+            ready_models_.push_back(std::move(model));
+            work_cv_.notify_one();
+            continue;
+        }
+
+        // 실패해도 서버는 계속 동작. 기다리던 카메라는 이전 모드로 남음
+        std::cerr << "[WARN] 모델 로딩 중 오류 발생 (" << group << "): " << error << std::endl;
+        loading_.erase(std::remove(loading_.begin(), loading_.end(), group), loading_.end());
+        ModelLoadEvent event;
+        event.model = group;
+        event.state = "failed";
+        event.elapsed_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - started).count();
+        event.error = error;
+        for (auto& slot : slots_) {
+            if (model_group(slot->requested_mode) == group && slot->mode != slot->requested_mode) {
+                slot->requested_mode = slot->mode;
+                event.camera_ids.push_back(slot->camera_id);
+            }
+        }
+        lock.unlock();
+        emit({event});
+        lock.lock();
+    }
+}
+
+void InferenceEngine::install_ready_models(std::unique_lock<std::mutex>& lock) {
+    std::vector<LoadedModel> ready;
+    ready.swap(ready_models_);
+    lock.unlock();
+    for (auto& model : ready) models_.install(std::move(model));
+    publish_model_stats();
+    lock.lock();
+
+    // 모델을 기다리던 카메라를 요청한 모드로 바꿈 (다음 프레임부터 새 모델로 추론)
+    std::vector<ModelLoadEvent> events;
+    for (const auto& model : ready) {
+        loading_.erase(std::remove(loading_.begin(), loading_.end(), model.group), loading_.end());
+        ModelLoadEvent event;
+        event.model = model.group;
+        event.state = "ready";
+        event.elapsed_ms = model.load_ms;
+        for (auto& slot : slots_) {
+            if (model_group(slot->requested_mode) == model.group && slot->mode != slot->requested_mode) {
+                slot->mode = slot->requested_mode;
+                event.camera_ids.push_back(slot->camera_id);
+            }
+        }
+        events.push_back(std::move(event));
+    }
+    models_dirty_ = true;
+    lock.unlock();
+    emit(events);
+    lock.lock();
+}
+
+void InferenceEngine::update_models(const std::vector<std::string>& modes) {
+    // 카메라가 쓰는 모델은 풀에서 내리지 않게 표시. 쓰지 않는 모델은 예산을 넘을 때만 LRU로 내림
+    std::vector<std::string> groups;
+    for (const auto& mode : modes) {
+        const std::string group = model_group(mode);
+        if (!group.empty()) groups.push_back(group);
+    }
+    models_.set_in_use(groups);
+    publish_model_stats();
+}
+
+bool InferenceEngine::ensure_model(const std::string& mode) {
+    const std::string group = model_group(mode);
+    if (group.empty()) return false; // "raw", "stop": 모델 없음
+    if (models_.acquire(group)) return true;
+
+    // 모드가 바뀌기 직전에 낸 요청이거나 모델이 내려간 경우: 이번 요청은 결과 없이 돌려보내고 다시 올림
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        request_load_locked(group);
+    }
+    loader_cv_.notify_one();
+    return false;
+}
+
+void InferenceEngine::publish_model_stats() {
+    ModelPoolStats stats = models_.stats();
+    std::lock_guard<std::mutex> lock(mutex_);
+    model_pool_stats_ = std::move(stats);
+}
+
+std::shared_ptr<InferenceResult> InferenceEngine::acquire_result() {
+    for (const auto& pooled : result_pool_) {
+        // 풀만 참조하면 카메라의 최신 결과와 렌더 단계의 박스 전파 기준에서 모두 빠진 결과
+        if (pooled.use_count() != 1) continue;
+        std::atomic_thread_fence(std::memory_order_acquire);
+        pooled->detections.clear();
+        pooled->segmentation.person_count = 0;
+        pooled->segmentation.boxes.clear();
+        pooled->segmentation.masks.clear();
+        return pooled;
+    }
+    result_pool_.push_back(std::make_shared<InferenceResult>());
+    return result_pool_.back();
+}
+
+void InferenceEngine::run_batch(const std::vector<const Frame*>& frames, const std::vector<std::string>& modes,
+                                const std::vector<std::vector<cv::Rect>>& rois, std::vector<std::shared_ptr<InferenceResult>>& results) {
+    const size_t count = frames.size();
+    results.assign(count, nullptr);
+    if (count == 0 || !ensure_model(modes[0])) return;
+
+    for (size_t i = 0; i < count; ++i) {
+        results[i] = acquire_result();
+        results[i]->mode = modes[i];
+        results[i]->frame_seq = frames[i]->seq;
+    }
+
+    // Detector와 Fall은 같은 입력/출력 형식을 가짐.
+    // 요청마다 전체 프레임 하나, 또는 구역 크롭마다 하나씩 배치 항목을 만듦
+    auto detect_batch = [&](auto& model) {
+        std::vector<size_t>& owners = item_owners_;
+        std::vector<cv::Rect>& crops = item_crops_;
+        owners.clear();
+        crops.clear();
+        for (size_t i = 0; i < count; ++i) {
+            const cv::Size size = frame_size(frames[i]->image, frames[i]->format);
+            const cv::Rect frame_rect(0, 0, size.width, size.height);
+            if (rois[i].empty()) {
+                owners.push_back(i);
+                crops.push_back(frame_rect);
+                continue;
+            }
+            for (const cv::Rect& roi : rois[i]) {
+                const cv::Rect crop = roi & frame_rect;
+                if (crop.width < 2 || crop.height < 2) continue;
+                owners.push_back(i);
+                crops.push_back(crop);
+            }
+        }
+
+        // 전처리는 모델이 프레임에서 입력 텐서로 바로 씀 (중간 RGB 버퍼 없음)
+        const size_t items = crops.size();
+        item_regions_.resize(items);
+        for (size_t k = 0; k < items; ++k) {
+            item_regions_[k].image = &frames[owners[k]]->image;
+            item_regions_[k].format = frames[owners[k]]->format;
+            item_regions_[k].roi = crops[k];
+        }
+        std::vector<std::vector<DetectionResult>>& detections = item_detections_;
+        model.detect_regions(item_regions_, model.default_conf_threshold, model.default_nms_threshold, detections);
+
+        // 크롭 좌표 → 프레임 좌표
+        for (size_t k = 0; k < items; ++k) {
+            auto& merged = results[owners[k]]->detections;
+            for (DetectionResult& det : detections[k]) {
+                det.box += crops[k].tl();
+                merged.push_back(det);
+            }
+        }
+        for (size_t i = 0; i < count; ++i) {
+            // 크롭이 겹치면 같은 물체가 두 번 잡히므로 모델과 같은 문턱으로 다시 NMS
+            if (rois[i].size() > 1) suppress_duplicates(results[i]->detections, model.default_nms_threshold);
+            results[i]->class_names = model.get_class_names();
+        }
+    };
+
+    const std::string group = model_group(modes[0]);
+    if (group == "detector") {
+        detect_batch(*models_.detector());
+    } else if (group == "fall") {
+        detect_batch(*models_.fall());
+    } else if (group == "segmenter") {
+        // 세그멘테이션 모델은 레터박스 전처리가 BGR 기준이므로 YUV 프레임은 변환이 필요함
+        if (batch_inputs_.size() < count) batch_inputs_.resize(count);
+        batch_views_.resize(count);
+        for (size_t i = 0; i < count; ++i) {
+            if (frames[i]->format != PixelFormat::Bgr) {
+                yuv420_to_bgr(frames[i]->image, frames[i]->format, batch_inputs_[i]);
+                batch_views_[i] = batch_inputs_[i];
+            } else {
+                batch_views_[i] = frames[i]->image;
+            }
+        }
+        models_.segmenter()->segment_batch(batch_views_, batch_segmentations_);
+        for (size_t i = 0; i < count; ++i) {
+            // 맞바꿔서 결과 객체와 작업 목록 양쪽의 벡터 용량을 모두 유지
+            std::swap(results[i]->segmentation, batch_segmentations_[i]);
+        }
+    }
+}
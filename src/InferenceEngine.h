@@ -0,0 +1,163 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "Frame.h"
+#include "PipelineMetrics.h"
+#include "InputQuantizer.h"
+#include "ModelPool.h"
+#include "InferenceThreadPool.h"
+#include "ServerConfig.h"
+#include "segmenter.h"
+#include "types.h"
+
+struct InferenceResult;
+
+// 카메라별 스케줄링 통계 (/api/pipeline/stats)
+struct EngineCameraStats {
+    int camera_id = 0;
+    std::string mode;           // 지금 추론하는 모드
+    std::string requested_mode; // 모델 로드를 기다리는 중이면 mode와 다름
+    uint64_t requests = 0; // 제출한 추론 요청 수
+    uint64_t served = 0;   // 모델을 실제로 실행한 횟수
+};
+
+// 모델 백그라운드 로드 알림 (WebSocket "model_load")
+struct ModelLoadEvent {
+    std::string model;           // "detector", "fall", "segmenter"
+    std::string state;           // "loading", "ready", "failed"
+    std::vector<int> camera_ids; // 이 모델을 기다리던 카메라 (미리 올리기면 비어 있음)
+    double elapsed_ms = 0.0;     // ready/failed: 로드와 워밍업에 걸린 시간
+    std::string error;           // failed: 오류 메시지
+};
+
+struct EngineStats {
+    std::vector<EngineCameraStats> cameras;
+    std::vector<std::string> loaded_models;
+    ModelPoolStats model_pool;
+    InferenceThreadStats threads;
+    int max_batch = 1;
+    int batch_window_ms = 0;
+    uint64_t batches = 0;      // 모델 실행(Invoke/Run) 횟수
+    Histogram batch_size;      // 한 번에 묶인 요청 수
+    Histogram batch_wait_ms;   // 요청부터 배치 실행 시작까지 대기 시간
+};
+
+// 모든 카메라가 하나의 Detector/Fall/Segmenter 인스턴스를 공유하도록 하는 추론 엔진.
+// 모델은 전용 워커 스레드에서만 실행되고, 각 카메라의 추론 스레드는 infer()로 요청을 넣고
+// 결과를 기다립니다. 워커는 대기 중인 카메라를 라운드 로빈으로 골라 한 카메라가 모델을
+// 독점하지 못하게 합니다. 같은 모델을 쓰는 카메라의 요청이 동시에 대기 중이면 (또는 배치 창 안에
+// 들어오면) 입력 텐서의 배치 차원에 쌓아 한 번에 실행하고 결과를 카메라별로 나눠 돌려줍니다.
+// 모델은 ModelPool이 관리해 모드를 바꿔도 메모리 예산 안에서는 내리지 않습니다.
+// 없는 모델은 로더 스레드가 올리고, 그동안 카메라는 이전 모드로 계속 추론하다가
+// 준비가 끝나면 워커가 배치 사이에서 모델을 풀에 넣고 카메라 모드를 바꿉니다.
+class InferenceEngine {
+public:
+    InferenceEngine(const ModelConfig& config, const InferenceConfig& inference);
+    ~InferenceEngine();
+
+    void start();
+    void stop();
+
+    void registerCamera(int camera_id, const std::string& mode);
+
+    // 카메라 모드 변경을 요청합니다. 모델이 올라와 있으면 바로 바뀌고, 아니면 백그라운드 로드가
+    // 끝날 때 바뀝니다. 로드에 실패하면 이전 모드로 남습니다. 블로킹하지 않습니다.
+    void setCameraMode(int camera_id, const std::string& mode);
+    // 지금 추론에 쓰는 모드 (요청한 모드의 모델이 아직 로드 중이면 이전 모드)
+    std::string activeMode(int camera_id) const;
+
+    // 모델 로드 시작/완료/실패 알림. start() 전에 등록하며, 엔진 스레드나 setCameraMode()를
+    // 부른 스레드에서 호출됩니다.
+    void onModelLoad(std::function<void(const ModelLoadEvent&)> callback);
+
+    // 차례가 돌아와 추론이 끝날 때까지 대기합니다. "raw"/"stop"이거나 모델이 없으면 nullptr.
+    // rois가 있으면 (검출 모드) 전체 프레임 대신 각 영역만 모델 입력 크기로 잘라 추론하고
+    // 박스를 프레임 좌표로 되돌려 합칩니다. 크롭 하나가 배치 항목 하나가 됩니다.
+    std::shared_ptr<InferenceResult> infer(int camera_id, const Frame& frame, const std::string& mode,
+                                           const std::vector<cv::Rect>& rois = {});
+
+    EngineStats getStats() const;
+
+private:
+    struct CameraSlot {
+        int camera_id = 0;
+        std::string mode;           // 지금 쓰는 모드 (모델이 올라와 있음)
+        std::string requested_mode; // 마지막으로 요청된 모드
+        const Frame* frame = nullptr; // 요청 중인 프레임 (infer()가 반환할 때까지 유효)
+        std::string request_mode;
+        std::vector<cv::Rect> request_rois;
+        bool pending = false;
+        std::chrono::steady_clock::time_point requested_at;
+        std::shared_ptr<InferenceResult> result;
+        std::condition_variable done;
+        uint64_t requests = 0;
+        uint64_t served = 0;
+    };
+
+    void worker_loop();
+    void loader_loop();
+    void apply_mode_locked(CameraSlot& slot, const std::string& mode, std::vector<ModelLoadEvent>& events);
+    void request_load_locked(const std::string& group); // 이미 대기/로드 중이면 무시
+    void install_ready_models(std::unique_lock<std::mutex>& lock);
+    void emit(const std::vector<ModelLoadEvent>& events) const;
+    const CameraSlot* peek_pending_locked() const;       // 라운드 로빈 커서 기준 다음 요청
+    bool batch_ready_locked(const std::string& group) const; // 더 기다려도 배치가 커질 수 없는지
+    void take_batch_locked(std::vector<CameraSlot*>& batch); // 다음 요청과 같은 모델을 쓰는 요청들을 묶음
+    void update_models(const std::vector<std::string>& modes);
+    bool ensure_model(const std::string& mode);
+    void publish_model_stats();
+    void run_batch(const std::vector<const Frame*>& frames, const std::vector<std::string>& modes,
+                   const std::vector<std::vector<cv::Rect>>& rois, std::vector<std::shared_ptr<InferenceResult>>& results);
+    std::shared_ptr<InferenceResult> acquire_result();
+
+    const size_t max_batch_;
+    const std::chrono::milliseconds batch_window_;
+    const bool prewarm_;
+
+    mutable std::mutex mutex_;
+    std::condition_variable work_cv_;
+    std::vector<std::unique_ptr<CameraSlot>> slots_;
+    size_t next_slot_ = 0;
+    bool models_dirty_ = false;
+    ModelPoolStats model_pool_stats_; // 통계용 (mutex_ 보호)
+    uint64_t batches_ = 0;
+    Histogram batch_size_hist_;
+    Histogram batch_wait_hist_;
+    bool running_ = false;
+    std::thread worker_;
+
+    // 백그라운드 모델 로드 (mutex_ 보호)
+    std::thread loader_;
+    std::condition_variable loader_cv_;
+    std::deque<std::string> load_queue_;
+    std::vector<std::string> loading_;       // 대기 또는 로드 중인 모델
+    std::vector<LoadedModel> ready_models_;  // 로더가 만들어 워커가 풀에 넣을 모델
+    std::function<void(const ModelLoadEvent&)> model_load_callback_;
+
+    // 워커 스레드에서만 접근
+    ModelPool models_;
+    std::vector<cv::Mat> batch_inputs_; // 블러 모드: YUV 프레임을 변환한 BGR 입력 (재사용)
+    std::vector<cv::Mat> batch_views_;  // 블러 모드: segmenter에 넘기는 프레임 (BGR 원본 또는 batch_inputs_)
+    std::vector<SegmentationResult> batch_segmentations_;
+    // 배치마다 비워 다시 쓰는 목록 (워밍업 뒤에는 할당하지 않음)
+    std::vector<CameraSlot*> batch_slots_;
+    std::vector<const Frame*> batch_frames_;
+    std::vector<std::string> batch_modes_;
+    std::vector<std::vector<cv::Rect>> batch_rois_;
+    std::vector<std::shared_ptr<InferenceResult>> batch_results_;
+    std::vector<size_t> item_owners_;   // 배치 항목(프레임 또는 크롭) → 요청 인덱스
+    std::vector<cv::Rect> item_crops_;
+    std::vector<FrameRegion> item_regions_;
+    std::vector<std::vector<DetectionResult>> item_detections_;
+    // 카메라와 렌더 단계가 모두 놓아준 결과 객체는 벡터 용량째로 다시 씀
+    std::vector<std::shared_ptr<InferenceResult>> result_pool_;
+};
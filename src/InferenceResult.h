@@ -0,0 +1,18 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "types.h"
+#include "segmenter.h"
+
+// 추론 단계가 렌더 단계에 넘겨주는 결과.
+// 렌더 단계는 다음 결과가 나올 때까지 이 값을 매 프레임 다시 그립니다.
+struct InferenceResult {
+    std::string mode;
+    uint64_t frame_seq = 0;
+    std::vector<DetectionResult> detections;
+    std::vector<std::string> class_names; // 모델이 교체돼도 그릴 수 있도록 복사본 보관
+    SegmentationResult segmentation;
+    cv::Mat reference_luma; // 추론한 프레임의 저해상도 휘도 (BoxPropagator의 움직임 추정 기준)
+};
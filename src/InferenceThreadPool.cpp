@@ -0,0 +1,77 @@
+#include "InferenceThreadPool.h"
+
+#include <opencv2/core.hpp>
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+
+namespace {
+
+std::mutex g_instance_mutex;
+std::unique_ptr<InferenceThreadPool> g_instance;
+
+} // namespace
+
+void InferenceThreadPool::configure(const InferenceConfig& config) {
+    std::lock_guard<std::mutex> lock(g_instance_mutex);
+    if (g_instance) {
+        std::cerr << "[WARN] 추론 스레드 풀이 이미 만들어져 설정을 바꾸지 않습니다." << std::endl;
+        return;
+    }
+    g_instance.reset(new InferenceThreadPool(config.threads, config.opencv_threads));
+}
+
+InferenceThreadPool& InferenceThreadPool::instance() {
+    std::lock_guard<std::mutex> lock(g_instance_mutex);
+    if (!g_instance) {
+        const InferenceConfig defaults;
+        g_instance.reset(new InferenceThreadPool(defaults.threads, defaults.opencv_threads));
+    }
+    return *g_instance;
+}
+
+InferenceThreadPool::InferenceThreadPool(int threads, int opencv_threads)
+    : threads_(std::max(1, threads)),
+      opencv_threads_(opencv_threads),
+      wait_hist_({0.5, 1, 2, 5, 10, 20, 50, 100}) {
+    // 게이트 때문에 한 번에 한 세션만 돌므로 inter-op 병렬은 쓰지 않고,
+    // 작업이 끝난 스레드가 코어를 붙잡고 도는(spin) 대신 바로 쉬게 해 TFLite 쪽에 코어를 넘김
+    Ort::ThreadingOptions threading;
+    threading.SetGlobalIntraOpNumThreads(threads_);
+    threading.SetGlobalInterOpNumThreads(1);
+    threading.SetGlobalSpinControl(0);
+    ort_env_ = Ort::Env(threading, ORT_LOGGING_LEVEL_WARNING, "pi_server");
+
+    if (opencv_threads_ >= 0) cv::setNumThreads(opencv_threads_);
+
+    std::cout << "[INFO] 추론 스레드 " << threads_ << "개 (TFLite/ONNX Runtime 공유), OpenCV 스레드 "
+              << (opencv_threads_ >= 0 ? std::to_string(opencv_threads_) : std::string("기본값")) << std::endl;
+}
+
+std::unique_lock<std::mutex> InferenceThreadPool::enter() {
+    std::unique_lock<std::mutex> lock(gate_, std::try_to_lock);
+    double waited_ms = -1.0;
+    if (!lock.owns_lock()) {
+        const auto started = std::chrono::steady_clock::now();
+        lock.lock();
+        waited_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - started).count();
+    }
+    std::lock_guard<std::mutex> stats_lock(stats_mutex_);
+    ++runs_;
+    if (waited_ms >= 0.0) {
+        ++contended_;
+        wait_hist_.record(waited_ms);
+    }
+    return lock;
+}
+
+InferenceThreadStats InferenceThreadPool::stats() const {
+    std::lock_guard<std::mutex> lock(stats_mutex_);
+    InferenceThreadStats stats;
+    stats.threads = threads_;
+    stats.opencv_threads = opencv_threads_;
+    stats.runs = runs_;
+    stats.contended = contended_;
+    stats.wait_ms = wait_hist_;
+    return stats;
+}
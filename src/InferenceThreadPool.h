@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <onnxruntime_cxx_api.h>
+#include <tensorflow/lite/external_cpu_backend_context.h>
+#include "PipelineMetrics.h"
+#include "ServerConfig.h"
+
+// 공유 추론 스레드 상태 스냅샷 (/api/pipeline/stats)
+struct InferenceThreadStats {
+    int threads = 0;        // TFLite/ONNX Runtime 추론 스레드 수
+    int opencv_threads = 0; // cv::setNumThreads 값 (-1이면 OpenCV 기본값)
+    uint64_t runs = 0;      // 게이트를 지난 추론 횟수
+    uint64_t contended = 0; // 다른 모델이 실행 중이라 기다린 횟수
+    Histogram wait_ms;      // 기다린 경우의 대기 시간
+};
+
+// 프로세스 전체가 함께 쓰는 추론 CPU 스레드 설정.
+// Detector/Fall(TFLite)과 Segmenter(ONNX Runtime), OpenCV가 각자 코어 수만큼 스레드를 띄우면
+// Pi의 4코어를 서로 빼앗으므로 스레드 수를 inference.threads 하나로 정하고 풀을 공유합니다.
+//  - TFLite: 모든 인터프리터가 ExternalCpuBackendContext 하나(ruy 스레드 풀)를 쓰고,
+//    XNNPACK 델리게이트도 같은 스레드 수로 만듭니다.
+//  - ONNX Runtime: 전역 스레드 풀을 가진 Env 하나를 쓰고 세션별 스레드는 끕니다 (DisablePerSessionThreads).
+//  - OpenCV: cv::setNumThreads(inference.opencv_threads).
+// 모델 실행(Invoke/Run)은 게이트(enter())를 지나야 해서 두 엔진의 풀이 동시에 돌지 않으며,
+// 게이트에서 기다린 횟수와 시간이 경합 지표로 남습니다. 공유 ruy 컨텍스트도 스레드 안전하지 않아
+// 게이트 안에서만 씁니다.
+class InferenceThreadPool {
+public:
+    // 모델을 만들기 전에 한 번 부릅니다. 이미 만들어졌으면 무시하고 경고를 남깁니다.
+    static void configure(const InferenceConfig& config);
+    // configure() 전에 부르면 기본 설정으로 만듭니다.
+    static InferenceThreadPool& instance();
+
+    InferenceThreadPool(const InferenceThreadPool&) = delete;
+    InferenceThreadPool& operator=(const InferenceThreadPool&) = delete;
+
+    int threads() const { return threads_; }
+    tflite::ExternalCpuBackendContext* tflite_context() { return &tflite_context_; }
+    Ort::Env& ort_env() { return ort_env_; }
+
+    // 모델 실행 구간을 감싸는 잠금. 반환된 잠금을 쥔 동안에만 Invoke()/Run()을 부릅니다.
+    std::unique_lock<std::mutex> enter();
+
+    InferenceThreadStats stats() const;
+
+private:
+    InferenceThreadPool(int threads, int opencv_threads);
+
+    const int threads_;
+    const int opencv_threads_;
+    tflite::ExternalCpuBackendContext tflite_context_;
+    Ort::Env ort_env_{nullptr};
+
+    std::mutex gate_;
+    mutable std::mutex stats_mutex_;
+    uint64_t runs_ = 0;
+    uint64_t contended_ = 0;
+    Histogram wait_hist_;
+};
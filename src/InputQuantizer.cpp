@@ -0,0 +1,66 @@
+#include "InputQuantizer.h"
+#include "YuvImage.h"
+
+#include <algorithm>
+#include <cmath>
+
+void InputQuantizer::configure(float scale, int zero_point) {
+    for (int i = 0; i < 256; ++i) {
+        const float normalized = static_cast<float>(i) / 255.0f;
+        const int32_t quant = static_cast<int32_t>(std::round(normalized / scale + zero_point));
+        lut_[i] = static_cast<int8_t>(std::max(-128, std::min(quant, 127)));
+    }
+}
+
+void InputQuantizer::write(const FrameRegion& region, const cv::Size& out_size, int8_t* dst) {
+    if (region.format == PixelFormat::Bgr) {
+        write_bgr(*region.image, region.roi, out_size, dst);
+    } else {
+        yuv420_resize_to_int8_rgb(*region.image, region.format, region.roi, out_size, lut_, dst);
+    }
+}
+
+void InputQuantizer::write_bgr(const cv::Mat& bgr, const cv::Rect& roi, const cv::Size& out_size, int8_t* dst) {
+    // yuv420_resize_to_rgb와 같은 픽셀 중심 정렬, 11비트 고정소수점 쌍선형 보간
+    constexpr int kShift = 11;
+    constexpr int kOne = 1 << kShift;
+    constexpr int kRound = 1 << (2 * kShift - 1);
+    const float scale_x = static_cast<float>(roi.width) / out_size.width;
+    const float scale_y = static_cast<float>(roi.height) / out_size.height;
+
+    x_offsets_.resize(out_size.width);
+    x_weights_.resize(out_size.width);
+    for (int ox = 0; ox < out_size.width; ++ox) {
+        float fx = (ox + 0.5f) * scale_x - 0.5f;
+        int x0 = static_cast<int>(std::floor(fx));
+        float ax = fx - x0;
+        if (x0 < 0) { x0 = 0; ax = 0.f; }
+        if (x0 >= roi.width - 1) { x0 = roi.width - 2; ax = 1.f; }
+        x_offsets_[ox] = (roi.x + x0) * 3;
+        x_weights_[ox] = static_cast<int>(ax * kOne + 0.5f);
+    }
+
+    for (int oy = 0; oy < out_size.height; ++oy) {
+        float fy = (oy + 0.5f) * scale_y - 0.5f;
+        int y0 = static_cast<int>(std::floor(fy));
+        float ay = fy - y0;
+        if (y0 < 0) { y0 = 0; ay = 0.f; }
+        if (y0 >= roi.height - 1) { y0 = roi.height - 2; ay = 1.f; }
+        const int wy = static_cast<int>(ay * kOne + 0.5f);
+        const uchar* row0 = bgr.ptr<uchar>(roi.y + y0);
+        const uchar* row1 = bgr.ptr<uchar>(roi.y + y0 + 1);
+        int8_t* out = dst + static_cast<size_t>(oy) * out_size.width * 3;
+
+        for (int ox = 0; ox < out_size.width; ++ox) {
+            const uchar* p0 = row0 + x_offsets_[ox];
+            const uchar* p1 = row1 + x_offsets_[ox];
+            const int wx = x_weights_[ox];
+            // BGR 입력의 채널 c를 RGB 출력의 2 - c 자리에 씀
+            for (int c = 0; c < 3; ++c) {
+                const int top = p0[c] * (kOne - wx) + p0[c + 3] * wx;
+                const int bottom = p1[c] * (kOne - wx) + p1[c + 3] * wx;
+                out[ox * 3 + 2 - c] = lut_[(top * (kOne - wy) + bottom * wy + kRound) >> (2 * kShift)];
+            }
+        }
+    }
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <opencv2/opencv.hpp>
+#include <cstdint>
+#include <vector>
+#include "Frame.h"
+
+// 모델 입력으로 쓸 프레임 영역. 전처리 커널이 프레임(BGR 또는 YUV 420)에서 직접 샘플링합니다.
+struct FrameRegion {
+    const cv::Mat* image = nullptr;
+    PixelFormat format = PixelFormat::Bgr;
+    cv::Rect roi; // 프레임 좌표 (2x2 이상, 프레임 안)
+};
+
+// int8 양자화 TFLite 모델의 입력 전처리 커널 (Detector/Fall 공용).
+// 리샘플(cv::resize INTER_LINEAR와 같은 정렬) + BGR→RGB + 양자화를 출력 픽셀당 한 번에 처리하고
+// 결과를 입력 텐서(HWC int8)에 바로 씁니다. 양자화는 픽셀 값 256가지를 미리 계산한 LUT로 합니다:
+//   q = clamp(round(x / 255 / scale + zero_point), -128, 127)
+// 예전 경로(cv::resize → cvtColor → 스칼라 양자화)와의 차이(BGR 1 LSB 이내, YUV는 같음)는 tests/test_input_quantizer로 확인합니다.
+class InputQuantizer {
+public:
+    void configure(float scale, int zero_point);
+
+    // region을 out_size로 샘플링해 dst(out_size.area() * 3 바이트)에 씁니다.
+    void write(const FrameRegion& region, const cv::Size& out_size, int8_t* dst);
+
+    const int8_t* lut() const { return lut_; }
+
+private:
+    void write_bgr(const cv::Mat& bgr, const cv::Rect& roi, const cv::Size& out_size, int8_t* dst);
+
+    int8_t lut_[256] = {};
+    std::vector<int> x_offsets_; // 열 좌표표 (출력 열 → 입력 바이트 오프셋, 가중치), 호출마다 재사용
+    std::vector<int> x_weights_;
+};
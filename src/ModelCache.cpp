@@ -0,0 +1,66 @@
+#include "ModelCache.h"
+
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+uint64_t fnv1a64(const void* data, size_t bytes, uint64_t seed) {
+    // 모델 파일(수 MB)을 한 번 훑는 비용은 캐시로 아끼는 작업보다 훨씬 작음
+    const auto* p = static_cast<const unsigned char*>(data);
+    uint64_t hash = seed;
+    for (size_t i = 0; i < bytes; ++i) {
+        hash ^= p[i];
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+bool hash_file(const std::string& path, uint64_t& hash) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) return false;
+    std::vector<char> buffer(1 << 16);
+    hash = kFnvOffsetBasis;
+    while (file) {
+        file.read(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+        hash = fnv1a64(buffer.data(), static_cast<size_t>(file.gcount()), hash);
+    }
+    return file.eof();
+}
+
+std::string prepare_cache_file(const std::string& cache_dir, const std::string& model_path, const std::string& key,
+                               uint64_t model_hash, const std::string& suffix, bool& exists) {
+    exists = false;
+    std::error_code ec;
+    fs::create_directories(cache_dir, ec);
+    if (ec) {
+        std::cerr << "[WARN] 캐시 디렉터리를 만들 수 없습니다: " << cache_dir << " (" << ec.message() << ")" << std::endl;
+        return "";
+    }
+
+    // 상대 경로로 열어도 같은 파일이면 같은 키가 되도록 절대 경로로 바꿈
+    fs::path full_path = fs::absolute(model_path, ec);
+    if (ec) full_path = model_path;
+    const uint64_t key_hash = fnv1a64(key, fnv1a64(full_path.lexically_normal().string()));
+
+    char key_hex[17], model_hex[17];
+    std::snprintf(key_hex, sizeof(key_hex), "%016llx", static_cast<unsigned long long>(key_hash));
+    std::snprintf(model_hex, sizeof(model_hex), "%016llx", static_cast<unsigned long long>(model_hash));
+    const std::string prefix = fs::path(model_path).stem().string() + "-" + key_hex + "-";
+    const fs::path path = fs::path(cache_dir) / (prefix + model_hex + suffix);
+    exists = fs::exists(path, ec);
+    if (exists) return path.string();
+
+    // 같은 경로, 같은 설정에서 모델만 바뀐 예전 캐시는 다시 쓰일 일이 없으므로 정리
+    for (const auto& entry : fs::directory_iterator(cache_dir, ec)) {
+        const std::string name = entry.path().filename().string();
+        if (name.size() == prefix.size() + 16 + suffix.size() && name.rfind(prefix, 0) == 0 &&
+            name.compare(name.size() - suffix.size(), suffix.size(), suffix) == 0) {
+            fs::remove(entry.path(), ec);
+        }
+    }
+    return path.string();
+}
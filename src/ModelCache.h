@@ -0,0 +1,27 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// 모델에서 만들어 디스크에 남기는 캐시 파일 (ONNX Runtime 최적화 그래프) 공용 도우미.
+// 캐시 파일 이름은 cache_dir/<모델 이름>-<키 해시 16자리>-<모델 해시 16자리><suffix>입니다.
+//  - 키 해시: 모델 파일의 전체 경로 + 캐시 내용을 바꾸는 설정(key). 다른 디렉터리의 같은 이름 모델이나
+//    설정이 다른 캐시는 서로 다른 파일이 되어 함께 남습니다.
+//  - 모델 해시: 모델 내용. 같은 키에서 모델만 바뀌면 새 파일을 쓰고 예전 파일을 지웁니다.
+
+constexpr uint64_t kFnvOffsetBasis = 14695981039346656037ull;
+
+// FNV-1a 64비트. seed에 이전 결과를 넘기면 이어서 해시합니다.
+uint64_t fnv1a64(const void* data, size_t bytes, uint64_t seed = kFnvOffsetBasis);
+inline uint64_t fnv1a64(const std::string& text, uint64_t seed = kFnvOffsetBasis) {
+    return fnv1a64(text.data(), text.size(), seed);
+}
+
+// 파일 내용을 해시합니다. 읽지 못하면 false.
+bool hash_file(const std::string& path, uint64_t& hash);
+
+// 캐시 파일 경로를 정하고 디렉터리를 만듭니다. 파일이 이미 있으면 exists를 true로 하고,
+// 없으면 같은 키의 예전 캐시(같은 suffix, 다른 모델 해시)만 지웁니다. 디렉터리를 만들 수 없으면 빈 문자열.
+std::string prepare_cache_file(const std::string& cache_dir, const std::string& model_path, const std::string& key,
+                               uint64_t model_hash, const std::string& suffix, bool& exists);
@@ -0,0 +1,189 @@
+#include "ModelPool.h"
+#include "detector.h"
+#include "fall.h"
+#include "segmenter.h"
+
+#include <unistd.h>
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+
+namespace {
+
+// 현재 프로세스의 상주 메모리 (바이트). 읽지 못하면 0.
+size_t resident_bytes() {
+    std::ifstream statm("/proc/self/statm");
+    size_t total_pages = 0, resident_pages = 0;
+    if (!(statm >> total_pages >> resident_pages)) return 0;
+    return resident_pages * static_cast<size_t>(sysconf(_SC_PAGESIZE));
+}
+
+size_t file_bytes(const std::string& path) {
+    std::error_code ec;
+    const auto size = std::filesystem::file_size(path, ec);
+    return ec ? 0 : static_cast<size_t>(size);
+}
+
+} // namespace
+
+ModelPool::ModelPool(const ModelConfig& config)
+    : onnx_(config.onnx),
+      budget_bytes_(static_cast<size_t>(std::max(0, config.memory_budget_mb)) * 1024 * 1024) {
+    entries_[kDetector].name = "detector";
+    entries_[kDetector].path = config.detection_path;
+    entries_[kFall].name = "fall";
+    entries_[kFall].path = config.fall_path;
+    entries_[kSegmenter].name = "segmenter";
+    entries_[kSegmenter].path = config.segmentation_path;
+}
+
+ModelPool::~ModelPool() = default;
+
+int ModelPool::kind_of(const std::string& group) {
+    if (group == "detector") return kDetector;
+    if (group == "fall") return kFall;
+    if (group == "segmenter") return kSegmenter;
+    return -1;
+}
+
+bool ModelPool::loaded(int kind) const {
+    switch (kind) {
+        case kDetector: return detector_ != nullptr;
+        case kFall: return fall_ != nullptr;
+        case kSegmenter: return segmenter_ != nullptr;
+        default: return false;
+    }
+}
+
+LoadedModel::LoadedModel() = default;
+LoadedModel::~LoadedModel() = default;
+LoadedModel::LoadedModel(LoadedModel&&) noexcept = default;
+LoadedModel& LoadedModel::operator=(LoadedModel&&) noexcept = default;
+
+LoadedModel ModelPool::build(const std::string& group) const {
+    const int kind = kind_of(group);
+    if (kind < 0) throw std::invalid_argument("알 수 없는 모델: " + group);
+    const Entry& entry = entries_[kind];
+
+    LoadedModel model;
+    model.group = group;
+    const auto started = std::chrono::steady_clock::now();
+    // 다른 스레드도 할당하므로 RSS 차이는 대략적인 값
+    const size_t rss_before = resident_bytes();
+    // 교체 전에 더미 입력으로 한 번 추론해 첫 Invoke()/Run()의 할당과 델리게이트 준비를 미리 치름.
+    // 그 작업 버퍼도 모델 메모리로 치도록 같은 구간에서 측정
+    const cv::Mat dummy(cv::Size(640, 480), CV_8UC3, cv::Scalar::all(0));
+    double construct_ms = 0.0, delegate_ms = 0.0; // detector/fall 생성자 안의 시간
+    switch (kind) {
+        case kDetector:
+            model.detector = std::make_unique<Detector>(entry.path);
+            construct_ms = model.detector->get_construct_ms();
+            delegate_ms = model.detector->get_delegate_ms();
+            model.detector->detect(dummy);
+            break;
+        case kFall:
+            model.fall = std::make_unique<Fall>(entry.path);
+            construct_ms = model.fall->get_construct_ms();
+            delegate_ms = model.fall->get_delegate_ms();
+            model.fall->detect(dummy);
+            break;
+        case kSegmenter:
+            model.segmenter = std::make_unique<Segmenter>(entry.path, onnx_);
+            model.segmenter->segment(dummy);
+            break;
+    }
+    const size_t rss_after = resident_bytes();
+    model.bytes = std::max(file_bytes(entry.path), rss_after > rss_before ? rss_after - rss_before : 0);
+    model.load_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - started).count();
+
+    // 생성 시간과 그중 XNNPACK 델리게이트 시간은 시작(prewarm)과 모드 전환 로드 모두의 기준값
+    const std::string construct_detail =
+        construct_ms > 0.0 ? ", 생성 " + std::to_string(static_cast<int>(construct_ms)) + " ms 중 XNNPACK 델리게이트 " +
+                                 std::to_string(static_cast<int>(delegate_ms)) + " ms"
+                           : "";
+    std::cout << "[INFO] 모델 로드: " << entry.name << " (" << static_cast<int>(model.load_ms) << " ms, 약 "
+              << model.bytes / (1024 * 1024) << " MB" << construct_detail << ")" << std::endl;
+    return model;
+}
+
+void ModelPool::install(LoadedModel&& model) {
+    const int kind = kind_of(model.group);
+    if (kind < 0 || loaded(kind)) return;
+    switch (kind) {
+        case kDetector: detector_ = std::move(model.detector); break;
+        case kFall: fall_ = std::move(model.fall); break;
+        case kSegmenter: segmenter_ = std::move(model.segmenter); break;
+    }
+    entries_[kind].bytes = model.bytes;
+    entries_[kind].last_used = ++clock_;
+    ++loads_;
+    evict_to_budget(kind);
+}
+
+bool ModelPool::acquire(const std::string& group) {
+    const int kind = kind_of(group);
+    if (!loaded(kind)) return false;
+    entries_[kind].last_used = ++clock_;
+    ++hits_;
+    return true;
+}
+
+void ModelPool::unload(int kind) {
+    switch (kind) {
+        case kDetector: detector_.reset(); break;
+        case kFall: fall_.reset(); break;
+        case kSegmenter: segmenter_.reset(); break;
+    }
+    entries_[kind].bytes = 0;
+}
+
+void ModelPool::set_in_use(const std::vector<std::string>& groups) {
+    for (auto& entry : entries_) {
+        entry.in_use = std::find(groups.begin(), groups.end(), entry.name) != groups.end();
+    }
+    evict_to_budget(-1);
+}
+
+void ModelPool::evict_to_budget(int keep) {
+    if (budget_bytes_ == 0) return;
+    while (true) {
+        size_t total = 0;
+        int victim = -1;
+        for (int kind = 0; kind < kKindCount; ++kind) {
+            if (!loaded(kind)) continue;
+            total += entries_[kind].bytes;
+            if (kind == keep || entries_[kind].in_use) continue;
+            if (victim < 0 || entries_[kind].last_used < entries_[victim].last_used) victim = kind;
+        }
+        if (total <= budget_bytes_) return;
+        if (victim < 0) {
+            std::cerr << "[WARN] 사용 중인 모델만으로 모델 풀 예산을 넘었습니다 (약 " << total / (1024 * 1024)
+                      << " MB)." << std::endl;
+            return;
+        }
+        unload(victim);
+        ++evictions_;
+        std::cout << "[INFO] 모델 풀 예산 초과로 해제: " << entries_[victim].name << std::endl;
+    }
+}
+
+ModelPoolStats ModelPool::stats() const {
+    ModelPoolStats stats;
+    std::vector<int> order;
+    for (int kind = 0; kind < kKindCount; ++kind) {
+        if (!loaded(kind)) continue;
+        order.push_back(kind);
+        stats.resident_bytes += entries_[kind].bytes;
+    }
+    std::sort(order.begin(), order.end(),
+              [this](int a, int b) { return entries_[a].last_used > entries_[b].last_used; });
+    for (int kind : order) stats.loaded.push_back(entries_[kind].name);
+    stats.budget_bytes = budget_bytes_;
+    stats.loads = loads_;
+    stats.hits = hits_;
+    stats.evictions = evictions_;
+    return stats;
+}
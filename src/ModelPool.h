@@ -0,0 +1,103 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include "ServerConfig.h"
+
+class Detector;
+class Segmenter;
+class Fall;
+
+// 모델 풀 상태 스냅샷 (/api/pipeline/stats)
+struct ModelPoolStats {
+    std::vector<std::string> loaded; // 최근에 쓴 순서
+    size_t resident_bytes = 0;       // 로드된 모델의 추정 메모리 합
+    size_t budget_bytes = 0;         // 0이면 무제한
+    uint64_t loads = 0;              // 디스크에서 모델을 올린 횟수
+    uint64_t hits = 0;               // 이미 올라와 있어 바로 쓴 횟수
+    uint64_t evictions = 0;          // 예산 때문에 내린 횟수
+};
+
+// 로더 스레드가 만들어 아직 풀에 넣지 않은 모델 (group에 맞는 포인터 하나만 채워짐)
+struct LoadedModel {
+    std::string group;
+    std::unique_ptr<Detector> detector;
+    std::unique_ptr<Fall> fall;
+    std::unique_ptr<Segmenter> segmenter;
+    size_t bytes = 0;     // 추정 메모리
+    double load_ms = 0.0; // 로드와 워밍업에 걸린 시간
+
+    LoadedModel();
+    ~LoadedModel();
+    LoadedModel(LoadedModel&&) noexcept;
+    LoadedModel& operator=(LoadedModel&&) noexcept;
+};
+
+// Detector/Fall/Segmenter 인스턴스를 모드가 바뀌어도 메모리에 남겨 두는 풀.
+// 어느 카메라도 쓰지 않는 모델도 바로 내리지 않고, 로드된 모델의 추정 메모리 합이
+// models.memory_budget_mb를 넘을 때만 가장 오래 쓰지 않은 모델부터 내립니다 (LRU).
+// 카메라가 쓰고 있는 모델은 예산을 넘어도 내리지 않습니다.
+// 모델 메모리는 로드 전후의 RSS 차이로 추정하며, 최소한 모델 파일 크기로 잡습니다.
+// 모델 생성(build)은 아무 스레드에서나 할 수 있고, 풀 상태를 바꾸거나 읽는 나머지 함수는
+// 추론 엔진 워커 스레드 전용입니다. 그래서 추론 중에 모델이 바뀌는 일이 없습니다.
+class ModelPool {
+public:
+    explicit ModelPool(const ModelConfig& config);
+    ~ModelPool();
+
+    ModelPool(const ModelPool&) = delete;
+    ModelPool& operator=(const ModelPool&) = delete;
+
+    // group("detector", "fall", "segmenter") 모델을 디스크에서 만들고 더미 입력으로 한 번 추론해
+    // (할당, 델리게이트 준비) 바로 쓸 수 있는 상태로 돌려줍니다. 풀은 건드리지 않습니다.
+    // 로드에 실패하거나 알 수 없는 group이면 예외(std::exception)를 던집니다.
+    LoadedModel build(const std::string& group) const;
+
+    // build()로 만든 모델을 풀에 넣고 예산을 맞춥니다. 같은 모델이 이미 있으면 새 모델을 버립니다.
+    void install(LoadedModel&& model);
+
+    // 로드돼 있으면 LRU 순서를 갱신하고 true를 반환합니다.
+    bool acquire(const std::string& group);
+
+    // 카메라가 쓰고 있는 모델 목록을 알리고, 예산을 넘었으면 쓰지 않는 모델부터 내립니다.
+    void set_in_use(const std::vector<std::string>& groups);
+
+    bool is_loaded(const std::string& group) const { return loaded(kind_of(group)); }
+
+    Detector* detector() const { return detector_.get(); }
+    Fall* fall() const { return fall_.get(); }
+    Segmenter* segmenter() const { return segmenter_.get(); }
+
+    ModelPoolStats stats() const;
+
+private:
+    enum Kind { kDetector, kFall, kSegmenter, kKindCount };
+
+    struct Entry {
+        const char* name = "";
+        std::string path;
+        size_t bytes = 0;       // 추정 메모리 (로드 중일 때만 의미 있음)
+        uint64_t last_used = 0; // LRU 시계
+        bool in_use = false;
+    };
+
+    static int kind_of(const std::string& group);
+    bool loaded(int kind) const;
+    void unload(int kind);
+    void evict_to_budget(int keep);
+
+    std::array<Entry, kKindCount> entries_;
+    std::unique_ptr<Detector> detector_;
+    std::unique_ptr<Fall> fall_;
+    std::unique_ptr<Segmenter> segmenter_;
+    const OnnxSessionConfig onnx_;
+    const size_t budget_bytes_;
+    uint64_t clock_ = 0;
+    uint64_t loads_ = 0;
+    uint64_t hits_ = 0;
+    uint64_t evictions_ = 0;
+};
@@ -0,0 +1,36 @@
+#include "MotionGate.h"
+#include "YuvImage.h"
+
+MotionGate::MotionGate(const MotionGateConfig& config) : config_(config) {}
+
+void MotionGate::reset() {
+    background_.release();
+    last_changed_ratio_ = 0.0;
+    last_pass_ = {};
+}
+
+bool MotionGate::should_infer(const Frame& frame) {
+    luma_thumbnail(frame.image, frame.format, config_.scale, luma_);
+
+    if (background_.empty() || background_.size() != luma_.size()) {
+        // 첫 프레임: 비교할 배경이 없으므로 배경만 만들고 추론
+        luma_.convertTo(background_, CV_32F);
+        last_changed_ratio_ = 1.0;
+        last_pass_ = frame.captured_at;
+        return true;
+    }
+
+    background_.convertTo(background_u8_, CV_8U);
+    cv::absdiff(luma_, background_u8_, diff_);
+    cv::threshold(diff_, diff_, config_.pixel_threshold, 255, cv::THRESH_BINARY);
+    last_changed_ratio_ = static_cast<double>(cv::countNonZero(diff_)) / diff_.total();
+    cv::accumulateWeighted(luma_, background_, config_.background_rate);
+
+    const bool moving = last_changed_ratio_ >= config_.min_changed_ratio;
+    const bool overdue = frame.captured_at - last_pass_ >= std::chrono::milliseconds(config_.max_skip_ms);
+    if (moving || overdue) {
+        last_pass_ = frame.captured_at;
+        return true;
+    }
+    return false;
+}
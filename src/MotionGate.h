@@ -0,0 +1,29 @@
+#pragma once
+
+#include <chrono>
+#include <opencv2/opencv.hpp>
+#include "Frame.h"
+#include "ServerConfig.h"
+
+// 추론 앞단의 움직임 게이트. 저해상도 휘도를 천천히 갱신되는 배경과 비교해
+// 변한 픽셀이 거의 없으면 추론을 건너뛰게 합니다. 움직임이 없어도 max_skip_ms마다
+// 한 번은 통과시켜 가만히 서 있는 사람도 놓치지 않게 합니다. 카메라 추론 스레드 전용입니다.
+class MotionGate {
+public:
+    explicit MotionGate(const MotionGateConfig& config);
+
+    // 추론이 필요하면 true. 매 프레임 호출해야 배경이 갱신됩니다.
+    bool should_infer(const Frame& frame);
+    void reset();
+
+    double last_changed_ratio() const { return last_changed_ratio_; }
+
+private:
+    MotionGateConfig config_;
+    cv::Mat luma_;          // 현재 프레임 (CV_8UC1)
+    cv::Mat background_;    // 배경 (CV_32FC1, 누적 평균)
+    cv::Mat background_u8_;
+    cv::Mat diff_;
+    double last_changed_ratio_ = 0.0;
+    std::chrono::steady_clock::time_point last_pass_;
+};
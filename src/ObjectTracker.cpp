@@ -0,0 +1,162 @@
+#include "ObjectTracker.h"
+
+#include <algorithm>
+#include <tuple>
+
+namespace {
+
+// ByteTrack과 같은 방식으로 노이즈를 박스 높이에 비례하게 둠
+constexpr float kStdPosition = 1.0f / 20.0f;
+constexpr float kStdVelocity = 1.0f / 160.0f;
+constexpr float kLowMatchIou = 0.5f; // 낮은 신뢰도 검출은 더 확실히 겹칠 때만 이어 붙임
+
+float iou(const cv::Rect& a, const cv::Rect& b) {
+    const int inter = (a & b).area();
+    const int uni = a.area() + b.area() - inter;
+    return uni > 0 ? static_cast<float>(inter) / uni : 0.0f;
+}
+
+float sq(float v) { return v * v; }
+
+} // namespace
+
+void ObjectTracker::AxisFilter::init(float z, float pos_var, float vel_var) {
+    x = z;
+    v = 0.0f;
+    p00 = pos_var;
+    p01 = 0.0f;
+    p11 = vel_var;
+}
+
+void ObjectTracker::AxisFilter::predict(float pos_var, float vel_var) {
+    // F = [1 1; 0 1], P = F P F^T + Q
+    x += v;
+    p00 += 2.0f * p01 + p11 + pos_var;
+    p01 += p11;
+    p11 += vel_var;
+}
+
+void ObjectTracker::AxisFilter::update(float z, float meas_var) {
+    // H = [1 0]
+    const float s = p00 + meas_var;
+    const float k0 = p00 / s;
+    const float k1 = p01 / s;
+    const float y = z - x;
+    x += k0 * y;
+    v += k1 * y;
+    p11 -= k1 * p01;
+    p01 -= k0 * p01;
+    p00 -= k0 * p00;
+}
+
+cv::Rect ObjectTracker::Track::box() const {
+    const float width = std::max(1.0f, w.x);
+    const float height = std::max(1.0f, h.x);
+    return cv::Rect(static_cast<int>(cx.x - width / 2), static_cast<int>(cy.x - height / 2),
+                    static_cast<int>(width), static_cast<int>(height));
+}
+
+ObjectTracker::ObjectTracker(const TrackerConfig& config) : config_(config) {}
+
+void ObjectTracker::reset() {
+    tracks_.clear();
+}
+
+bool ObjectTracker::isAlive(int track_id) const {
+    return std::any_of(tracks_.begin(), tracks_.end(), [track_id](const Track& t) { return t.id == track_id; });
+}
+
+void ObjectTracker::update(std::vector<DetectionResult>& detections) {
+    // 1. 모든 트랙을 이번 추론 프레임 위치로 예측
+    for (Track& track : tracks_) {
+        const float pos_var = sq(kStdPosition * track.h.x);
+        const float vel_var = sq(kStdVelocity * track.h.x);
+        track.cx.predict(pos_var, vel_var);
+        track.cy.predict(pos_var, vel_var);
+        track.w.predict(pos_var, vel_var);
+        track.h.predict(pos_var, vel_var);
+    }
+
+    // 2. 신뢰도 높은 검출을 먼저, 남은 트랙을 낮은 검출과 매칭
+    std::vector<size_t> high, low;
+    for (size_t i = 0; i < detections.size(); ++i) {
+        detections[i].track_id = -1;
+        (detections[i].confidence >= config_.high_threshold ? high : low).push_back(i);
+    }
+    std::vector<int> det_to_track(detections.size(), -1);
+    std::vector<bool> track_matched(tracks_.size(), false);
+    match(detections, high, config_.match_iou, det_to_track, track_matched);
+    match(detections, low, std::max(config_.match_iou, kLowMatchIou), det_to_track, track_matched);
+
+    // 3. 매칭된 트랙 보정, 놓친 트랙 나이 증가
+    for (size_t i = 0; i < detections.size(); ++i) {
+        if (det_to_track[i] < 0) continue;
+        Track& track = tracks_[det_to_track[i]];
+        correct(track, detections[i]);
+        detections[i].track_id = track.id > 0 ? track.id : -1;
+    }
+    for (size_t t = 0; t < track_matched.size(); ++t) {
+        if (!track_matched[t]) ++tracks_[t].time_since_update;
+    }
+
+    // 4. 확정되지 않은 채 놓친 트랙과 오래 놓친 트랙 삭제
+    tracks_.erase(std::remove_if(tracks_.begin(), tracks_.end(), [this](const Track& t) {
+        return t.time_since_update > 0 && (t.id == 0 || t.time_since_update > config_.max_age);
+    }), tracks_.end());
+
+    // 5. 매칭되지 않은 높은 신뢰도 검출로 새 트랙 시작
+    for (size_t i : high) {
+        if (det_to_track[i] >= 0) continue;
+        start_track(detections[i]);
+        if (tracks_.back().id > 0) detections[i].track_id = tracks_.back().id;
+    }
+}
+
+void ObjectTracker::match(const std::vector<DetectionResult>& detections, const std::vector<size_t>& det_indices,
+                          float min_iou, std::vector<int>& det_to_track, std::vector<bool>& track_matched) const {
+    // (IoU, 검출, 트랙) 후보를 IoU 내림차순으로 훑으며 둘 다 비어 있으면 짝지음
+    std::vector<std::tuple<float, size_t, size_t>> candidates;
+    for (size_t i : det_indices) {
+        for (size_t t = 0; t < tracks_.size(); ++t) {
+            if (track_matched[t] || tracks_[t].class_id != detections[i].class_id) continue;
+            const float overlap = iou(detections[i].box, tracks_[t].box());
+            if (overlap >= min_iou) candidates.emplace_back(overlap, i, t);
+        }
+    }
+    std::sort(candidates.begin(), candidates.end(),
+              [](const auto& a, const auto& b) { return std::get<0>(a) > std::get<0>(b); });
+    for (const auto& [overlap, i, t] : candidates) {
+        if (det_to_track[i] >= 0 || track_matched[t]) continue;
+        det_to_track[i] = static_cast<int>(t);
+        track_matched[t] = true;
+    }
+}
+
+void ObjectTracker::start_track(const DetectionResult& detection) {
+    const cv::Rect& b = detection.box;
+    const float height = static_cast<float>(std::max(1, b.height));
+    const float pos_var = sq(2.0f * kStdPosition * height);
+    const float vel_var = sq(10.0f * kStdVelocity * height);
+
+    Track track;
+    track.class_id = detection.class_id;
+    track.cx.init(b.x + b.width / 2.0f, pos_var, vel_var);
+    track.cy.init(b.y + b.height / 2.0f, pos_var, vel_var);
+    track.w.init(static_cast<float>(b.width), pos_var, vel_var);
+    track.h.init(height, pos_var, vel_var);
+    track.hits = 1;
+    if (track.hits >= config_.min_hits) track.id = next_id_++;
+    tracks_.push_back(track);
+}
+
+void ObjectTracker::correct(Track& track, const DetectionResult& detection) {
+    const cv::Rect& b = detection.box;
+    const float meas_var = sq(kStdPosition * std::max(1, b.height));
+    track.cx.update(b.x + b.width / 2.0f, meas_var);
+    track.cy.update(b.y + b.height / 2.0f, meas_var);
+    track.w.update(static_cast<float>(b.width), meas_var);
+    track.h.update(static_cast<float>(b.height), meas_var);
+    track.time_since_update = 0;
+    ++track.hits;
+    if (track.id == 0 && track.hits >= config_.min_hits) track.id = next_id_++;
+}
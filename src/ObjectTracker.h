@@ -0,0 +1,51 @@
+#pragma once
+
+#include <vector>
+#include "ServerConfig.h"
+#include "types.h"
+
+// 추론 프레임 사이에서 검출에 같은 ID를 이어 붙이는 가벼운 다중 객체 추적기 (SORT/ByteTrack 방식).
+// 트랙마다 박스 중심/크기를 등속 칼만 필터로 예측하고, 예측 박스와 검출을 같은 클래스끼리
+// IoU가 큰 순서대로 탐욕적으로 매칭합니다. 신뢰도가 높은 검출을 먼저 매칭한 뒤 남은 트랙을
+// 낮은 검출로 이어 가려짐/흔들림에도 ID가 유지되게 합니다. 카메라 추론 스레드에서만 사용합니다.
+class ObjectTracker {
+public:
+    explicit ObjectTracker(const TrackerConfig& config);
+
+    // detections에 track_id를 채웁니다. 아직 확정되지 않은 트랙의 검출은 -1로 남습니다.
+    void update(std::vector<DetectionResult>& detections);
+    // 모드가 바뀌는 등 이전 트랙을 이어 쓸 수 없을 때 호출
+    void reset();
+
+    bool isAlive(int track_id) const;
+
+private:
+    // 한 축의 위치/속도 칼만 필터. 상태 전이와 관측이 축마다 독립이라 4개로 나눠도 결과가 같음
+    struct AxisFilter {
+        float x = 0.0f, v = 0.0f;
+        float p00 = 0.0f, p01 = 0.0f, p11 = 0.0f;
+
+        void init(float z, float pos_var, float vel_var);
+        void predict(float pos_var, float vel_var);
+        void update(float z, float meas_var);
+    };
+
+    struct Track {
+        int id = 0;          // 확정 전에는 0
+        int class_id = 0;
+        AxisFilter cx, cy, w, h;
+        int hits = 0;
+        int time_since_update = 0;
+
+        cv::Rect box() const;
+    };
+
+    void match(const std::vector<DetectionResult>& detections, const std::vector<size_t>& det_indices,
+               float min_iou, std::vector<int>& det_to_track, std::vector<bool>& track_matched) const;
+    void start_track(const DetectionResult& detection);
+    void correct(Track& track, const DetectionResult& detection);
+
+    TrackerConfig config_;
+    std::vector<Track> tracks_;
+    int next_id_ = 1;
+};
@@ -0,0 +1,138 @@
+#include "Overlay.h"
+#include "InferenceResult.h"
+#include "YuvImage.h"
+
+#include <cstdio>
+
+namespace {
+
+// 라벨 "클래스 [#트랙] 신뢰도"를 스레드별 버퍼에 만들어 프레임마다 문자열을 할당하지 않도록 함
+const std::string& format_label(const std::string& class_name, int track_id, float confidence) {
+    thread_local std::string label;
+    char text[96];
+    if (track_id >= 0) {
+        std::snprintf(text, sizeof(text), "%s #%d %.2f", class_name.c_str(), track_id, confidence);
+    } else {
+        std::snprintf(text, sizeof(text), "%s %.2f", class_name.c_str(), confidence);
+    }
+    label.assign(text);
+    return label;
+}
+
+} // namespace
+
+void draw_rect(cv::Mat& image, PixelFormat format, const cv::Rect& rect, const cv::Scalar& color, int thickness) {
+    if (format == PixelFormat::Bgr) {
+        cv::rectangle(image, rect, color, thickness);
+    } else {
+        yuv420_rectangle(image, format, rect, color, thickness);
+    }
+}
+
+void draw_text(cv::Mat& image, PixelFormat format, const std::string& text, const cv::Point& org,
+               double font_scale, const cv::Scalar& color, int thickness) {
+    if (format == PixelFormat::Bgr) {
+        cv::putText(image, text, org, cv::FONT_HERSHEY_SIMPLEX, font_scale, color, thickness);
+    } else {
+        yuv420_text(image, text, org, font_scale, color, thickness);
+    }
+}
+
+void draw_polygon(cv::Mat& image, PixelFormat format, const std::vector<cv::Point>& points, const cv::Scalar& color, int thickness) {
+    if (format == PixelFormat::Bgr) {
+        const cv::Point* pts = points.data();
+        const int count = static_cast<int>(points.size());
+        cv::polylines(image, &pts, &count, 1, true, color, thickness);
+    } else {
+        yuv420_polylines(image, format, points, color, thickness);
+    }
+}
+
+void draw_overlays(cv::Mat& frame, PixelFormat format, const InferenceResult& result,
+                   const std::map<std::string, cv::Scalar>& colors, const std::vector<Zone>& zones, PrivacyBlur& blur) {
+    const std::string& active_mode = result.mode;
+    const auto& results = result.detections;
+    const auto& class_names = result.class_names;
+
+    if (active_mode == "detect") {
+        for (const auto& res : results) {
+            if (res.class_id < class_names.size()) {
+                const std::string& class_name = class_names[res.class_id];
+                auto color_it = colors.find(class_name);
+                cv::Scalar color = color_it != colors.end() ? color_it->second : cv::Scalar(0, 0, 255);
+                    
+                // 사각형 그리기
+                draw_rect(frame, format, res.box, color, 2);
+
+                // 텍스트 그리기 로직 
+                const std::string& label = format_label(class_name, res.track_id, res.confidence);
+                    
+                int baseLine;
+                cv::Size label_size = cv::getTextSize(label, cv::FONT_HERSHEY_SIMPLEX, 0.5, 1, &baseLine);
+
+                int text_y = res.box.y - 10;
+                if (text_y < label_size.height) {
+                    text_y = res.box.y + label_size.height + 10;
+                }
+
+                draw_rect(frame, format,
+                          cv::Rect(cv::Point(res.box.x, text_y - label_size.height - 5),
+                                   cv::Point(res.box.x + label_size.width, text_y + baseLine - 5)),
+                          color, -1);
+                draw_text(frame, format, label, cv::Point(res.box.x, text_y - 5), 0.5, cv::Scalar(255, 255, 255), 1);
+            }
+        }
+    } else if (active_mode == "trespass") {
+        for (const Zone& zone : zones) {
+            draw_polygon(frame, format, zone, cv::Scalar(0, 255, 255), 2);
+        }
+        // 결과 그리기 (person만 빨간색으로)
+        for (const auto& res : results) {
+            if (res.class_id < class_names.size() && class_names[res.class_id] == "person") {
+                draw_rect(frame, format, res.box, cv::Scalar(0, 0, 255), 2);
+                // 1. 표시할 라벨 생성 ("person" + 신뢰도 점수)
+                const std::string& label = format_label(class_names[res.class_id], res.track_id, res.confidence);
+                cv::Scalar color = cv::Scalar(0, 0, 255); // 빨간색
+
+                // 2. 텍스트 배경을 위한 설정
+                int baseLine;
+                cv::Size label_size = cv::getTextSize(label, cv::FONT_HERSHEY_SIMPLEX, 0.5, 1, &baseLine);
+                int text_y = res.box.y - 10;
+                if (text_y < label_size.height) {
+                    text_y = res.box.y + res.box.height + label_size.height + 5;
+                }
+
+                // 3. 텍스트 배경 사각형 그리기
+                draw_rect(frame, format,
+                          cv::Rect(cv::Point(res.box.x, text_y - label_size.height - 5),
+                                   cv::Point(res.box.x + label_size.width, text_y + baseLine - 5)),
+                          color, -1);
+
+                // 4. 실제 텍스트 그리기
+                draw_text(frame, format, label, cv::Point(res.box.x, text_y - 5), 0.5, cv::Scalar(255, 255, 255), 1);
+            }
+        }
+    } else if (active_mode == "fall") {
+        for (const auto& res : results) {
+            if (res.class_id < class_names.size()) {
+                const std::string& class_name = class_names[res.class_id];
+                auto color_it = colors.find(class_name);
+                cv::Scalar color = color_it != colors.end() ? color_it->second : cv::Scalar(255, 255, 255);
+                    
+                draw_rect(frame, format, res.box, color, 2);
+                const std::string& label = format_label(class_name, res.track_id, res.confidence);
+                
+                int baseLine;
+                cv::Size label_size = cv::getTextSize(label, cv::FONT_HERSHEY_SIMPLEX, 0.5, 1, &baseLine);
+                int text_y = res.box.y - 10;
+                if (text_y < label_size.height) {
+                    text_y = res.box.y + label_size.height + 10;
+                }
+                draw_rect(frame, format, cv::Rect(cv::Point(res.box.x, text_y - label_size.height - 5), cv::Point(res.box.x + label_size.width, text_y + baseLine)), color, -1);
+                draw_text(frame, format, label, cv::Point(res.box.x, text_y - 5), 0.5, cv::Scalar(255, 255, 255), 1);
+            }
+        }
+    } else if (active_mode == "blur") {
+        blur.apply(frame, format, result.segmentation);
+    }
+}
@@ -0,0 +1,22 @@
+#pragma once
+
+#include <opencv2/opencv.hpp>
+#include <map>
+#include <string>
+#include <vector>
+#include "Frame.h"
+#include "PrivacyBlur.h"
+#include "Zone.h"
+
+struct InferenceResult;
+
+// 프레임 형식에 맞춰 사각형/글자/다각형을 그립니다. YUV 프레임은 BGR 변환 없이 평면에 직접 그립니다.
+void draw_rect(cv::Mat& image, PixelFormat format, const cv::Rect& rect, const cv::Scalar& color, int thickness);
+void draw_text(cv::Mat& image, PixelFormat format, const std::string& text, const cv::Point& org,
+               double font_scale, const cv::Scalar& color, int thickness);
+void draw_polygon(cv::Mat& image, PixelFormat format, const std::vector<cv::Point>& points, const cv::Scalar& color, int thickness);
+
+// 모드별 오버레이(박스/라벨, 침입 구역, 블러)를 프레임에 그립니다.
+// colors는 클래스별 박스 색 (없는 클래스는 모드 기본색), zones는 trespass 모드에서 그릴 구역입니다.
+void draw_overlays(cv::Mat& frame, PixelFormat format, const InferenceResult& result,
+                   const std::map<std::string, cv::Scalar>& colors, const std::vector<Zone>& zones, PrivacyBlur& blur);
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+// 지연 시간 요약 (모니터링용, 밀리초)
+struct LatencyStats {
+    uint64_t samples = 0;
+    double last_ms = 0.0;
+    double avg_ms = 0.0; // 지수 이동 평균
+    double max_ms = 0.0;
+};
+
+// 고정 구간 히스토그램 (모니터링용). counts[i]는 bounds[i] 이하(이전 구간 초과) 값의 개수이고,
+// 마지막 칸은 bounds.back()을 넘는 값입니다. 동기화는 기록하는 쪽에서 합니다.
+struct Histogram {
+    std::vector<double> bounds;
+    std::vector<uint64_t> counts;
+    uint64_t samples = 0;
+    double sum = 0.0;
+
+    Histogram() = default;
+    explicit Histogram(std::vector<double> upper_bounds)
+        : bounds(std::move(upper_bounds)), counts(bounds.size() + 1, 0) {}
+
+    void record(double value) {
+        const size_t index = std::lower_bound(bounds.begin(), bounds.end(), value) - bounds.begin();
+        ++counts[index];
+        ++samples;
+        sum += value;
+    }
+};
+
+// 프레임 캡처 시각으로부터의 지연을 누적합니다. 한 단계에서 기록하고 API 스레드에서 읽습니다.
+class LatencyTracker {
+public:
+    void record(std::chrono::steady_clock::time_point captured_at) {
+        const double ms = std::chrono::duration<double, std::milli>(
+            std::chrono::steady_clock::now() - captured_at).count();
+        std::lock_guard<std::mutex> lock(mutex_);
+        stats_.avg_ms = stats_.samples == 0 ? ms : stats_.avg_ms * 0.95 + ms * 0.05;
+        stats_.last_ms = ms;
+        stats_.max_ms = std::max(stats_.max_ms, ms);
+        ++stats_.samples;
+    }
+
+    LatencyStats stats() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return stats_;
+    }
+
+private:
+    LatencyStats stats_;
+    mutable std::mutex mutex_;
+};
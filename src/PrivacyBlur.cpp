@@ -0,0 +1,155 @@
+#include "PrivacyBlur.h"
+#include "YuvImage.h"
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+namespace {
+
+int align_down(int v, int align) { return v / align * align; }
+int align_up(int v, int align) { return (v + align - 1) / align * align; }
+
+} // namespace
+
+PrivacyBlur::PrivacyBlur(const BlurConfig& config)
+    : method_(Method::Pyramid),
+      downscale_(std::max(1, config.downscale)),
+      kernel_(std::max(1, config.kernel)),
+      gaussian_ksize_(std::max(1, config.gaussian_ksize) | 1) {
+    if (!parse_method(config.method, method_)) {
+        std::cerr << "[WARN] 알 수 없는 블러 방식 '" << config.method << "', pyramid를 사용합니다." << std::endl;
+    }
+}
+
+void PrivacyBlur::apply(cv::Mat& image, PixelFormat format, const SegmentationResult& result) {
+    const cv::Size size = frame_size(image, format);
+    const cv::Rect frame_rect(0, 0, size.width, size.height);
+
+    if (method_ == Method::Gaussian) {
+        for (size_t i = 0; i < result.boxes.size(); ++i) {
+            const cv::Rect box = result.boxes[i] & frame_rect;
+            if (box.empty() || box.size() != result.masks[i].size()) continue;
+            if (format == PixelFormat::Bgr) {
+                cv::Mat roi = image(box);
+                cv::GaussianBlur(roi, obscured_, cv::Size(gaussian_ksize_, gaussian_ksize_), 0);
+                obscured_.copyTo(roi, result.masks[i]);
+            } else {
+                yuv420_masked_blur(image, format, box, result.masks[i], gaussian_ksize_);
+            }
+        }
+        return;
+    }
+
+    // 사람 박스의 합집합. 모자이크 블록과 크로마(2x2) 격자에 맞춰 바깥쪽으로 넓힘
+    cv::Rect region;
+    for (size_t i = 0; i < result.boxes.size(); ++i) {
+        const cv::Rect box = result.boxes[i] & frame_rect;
+        if (box.empty() || box.size() != result.masks[i].size()) continue;
+        region = region.empty() ? box : (region | box);
+    }
+    if (region.empty()) return;
+    int align = method_ == Method::Pixelate ? downscale_ : 1;
+    if (format != PixelFormat::Bgr && align % 2 != 0) align *= 2;
+    const cv::Point tl(align_down(region.x, align), align_down(region.y, align));
+    const cv::Point br(std::min(size.width, align_up(region.x + region.width, align)),
+                       std::min(size.height, align_up(region.y + region.height, align)));
+    region = cv::Rect(tl, br);
+
+    // 모든 사람 마스크를 영역 크기 마스크 하나로 합침
+    mask_.create(region.size(), CV_8UC1);
+    mask_.setTo(cv::Scalar::all(0));
+    for (size_t i = 0; i < result.boxes.size(); ++i) {
+        const cv::Rect box = result.boxes[i] & frame_rect;
+        if (box.empty() || box.size() != result.masks[i].size()) continue;
+        cv::Mat dst = mask_(box - region.tl());
+        cv::bitwise_or(dst, result.masks[i], dst);
+    }
+
+    if (format == PixelFormat::Bgr) {
+        composite(image(region), mask_, downscale_);
+        return;
+    }
+    composite(yuv420_luma(image)(region), mask_, downscale_);
+
+    // 색차도 같은 모양으로 가려야 얼굴 윤곽이 색 경계로 남지 않음 (색차는 가로세로 절반 해상도)
+    ChromaPlanes planes = yuv420_chroma_planes(image, format);
+    const cv::Rect chroma_region = yuv420_chroma_rect(region) & cv::Rect(0, 0, size.width / 2, size.height / 2);
+    if (chroma_region.empty()) return;
+    cv::resize(mask_, chroma_mask_, chroma_region.size(), 0, 0, cv::INTER_NEAREST);
+    const int chroma_downscale = std::max(1, downscale_ / 2);
+    if (format == PixelFormat::Nv12) {
+        composite(planes.uv(chroma_region), chroma_mask_, chroma_downscale);
+    } else {
+        composite(planes.u(chroma_region), chroma_mask_, chroma_downscale);
+        composite(planes.v(chroma_region), chroma_mask_, chroma_downscale);
+    }
+}
+
+void PrivacyBlur::composite(cv::Mat plane, const cv::Mat& mask, int downscale) {
+    if (method_ == Method::Pixelate) {
+        pixelate(plane, downscale);
+    } else {
+        const cv::Size small_size(std::max(1, (plane.cols + downscale - 1) / downscale),
+                                  std::max(1, (plane.rows + downscale - 1) / downscale));
+        cv::resize(plane, small_, small_size, 0, 0, cv::INTER_AREA);
+        if (kernel_ > 1) cv::blur(small_, small_, cv::Size(kernel_, kernel_), cv::Point(-1, -1), cv::BORDER_REPLICATE);
+        cv::resize(small_, obscured_, plane.size(), 0, 0, cv::INTER_LINEAR);
+    }
+    obscured_.copyTo(plane, mask);
+}
+
+void PrivacyBlur::pixelate(const cv::Mat& plane, int block) {
+    // 영역이 프레임 끝에서 잘리면 plane 크기가 block의 배수가 아님. 완전한 블록은 INTER_AREA(정수 배율이면
+    // 블록 평균)로, 오른쪽 열과 아래 행의 부분 블록은 남은 픽셀의 평균으로 한 칸씩 채움
+    const int cn = plane.channels();
+    const cv::Size blocks((plane.cols + block - 1) / block, (plane.rows + block - 1) / block);
+    const cv::Size full(plane.cols / block, plane.rows / block);
+    small_.create(blocks, plane.type());
+    if (full.width > 0 && full.height > 0) {
+        cv::Mat small_full = small_(cv::Rect(0, 0, full.width, full.height));
+        cv::resize(plane(cv::Rect(0, 0, full.width * block, full.height * block)), small_full, full, 0, 0, cv::INTER_AREA);
+    }
+    for (int by = 0; by < blocks.height; ++by) {
+        for (int bx = by < full.height ? full.width : 0; bx < blocks.width; ++bx) {
+            const cv::Rect rect(bx * block, by * block, std::min(block, plane.cols - bx * block),
+                                std::min(block, plane.rows - by * block));
+            const cv::Scalar mean = cv::mean(plane(rect));
+            uchar* dst = small_.ptr<uchar>(by) + bx * cn;
+            for (int c = 0; c < cn; ++c) dst[c] = cv::saturate_cast<uchar>(mean[c]);
+        }
+    }
+
+    // 정수 반복으로 키움. INTER_NEAREST는 배율이 정수가 아니면 블록 폭이 들쭉날쭉해짐
+    obscured_.create(plane.size(), plane.type());
+    for (int by = 0; by < blocks.height; ++by) {
+        const int y0 = by * block;
+        const uchar* src = small_.ptr<uchar>(by);
+        uchar* first = obscured_.ptr<uchar>(y0);
+        for (int x = 0; x < plane.cols; ++x) std::memcpy(first + x * cn, src + (x / block) * cn, cn);
+        for (int y = y0 + 1; y < std::min(plane.rows, y0 + block); ++y) {
+            std::memcpy(obscured_.ptr<uchar>(y), first, static_cast<size_t>(plane.cols) * cn);
+        }
+    }
+}
+
+bool PrivacyBlur::parse_method(const std::string& name, Method& method) {
+    if (name == "pyramid") {
+        method = Method::Pyramid;
+    } else if (name == "pixelate") {
+        method = Method::Pixelate;
+    } else if (name == "gaussian") {
+        method = Method::Gaussian;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+const char* PrivacyBlur::method_name(Method method) {
+    switch (method) {
+    case Method::Pixelate: return "pixelate";
+    case Method::Gaussian: return "gaussian";
+    default: return "pyramid";
+    }
+}
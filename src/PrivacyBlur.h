@@ -0,0 +1,47 @@
+#pragma once
+
+#include <opencv2/opencv.hpp>
+#include <string>
+#include "Frame.h"
+#include "ServerConfig.h"
+#include "segmenter.h"
+
+// blur 모드 렌더러: 사람 마스크 영역을 가립니다.
+//  - Pyramid:  사람 박스의 합집합 영역을 1/downscale로 줄여(INTER_AREA) kernel 크기 box blur 후 쌍선형으로 키움.
+//              큰 가우시안과 비슷한 흐림을 작은 영상에서 계산하므로 비용이 흐림 반경과 거의 무관합니다.
+//  - Pixelate: 합집합 영역의 downscale 크기 블록마다 평균을 구해 정수 반복으로 키운 블록 모자이크.
+//              블록 격자는 프레임 좌표에 맞춰 사람이 움직여도 블록이 흔들리지 않고, 프레임 크기가
+//              downscale의 배수가 아니면 오른쪽/아래 끝은 남은 크기의 부분 블록이 됩니다.
+//  - Gaussian: 사람마다 gaussian_ksize 가우시안 후 마스크 복사 (기존 방식, 비교용).
+// Pyramid/Pixelate는 가린 영상을 프레임마다 한 번만 만들고, 모든 사람 마스크를 합친 마스크로 한 번에 합성합니다.
+// YUV 420 프레임은 휘도/색차 평면에 직접 적용합니다. 작업 버퍼를 재사용하므로 스레드마다 하나씩 씁니다.
+class PrivacyBlur {
+public:
+    enum class Method { Pyramid, Pixelate, Gaussian };
+
+    explicit PrivacyBlur(const BlurConfig& config = BlurConfig());
+
+    // result의 마스크 영역을 가립니다. 박스는 프레임 좌표, 마스크는 박스 크기의 CV_8UC1입니다.
+    void apply(cv::Mat& image, PixelFormat format, const SegmentationResult& result);
+
+    Method method() const { return method_; }
+
+    // "pyramid" / "pixelate" / "gaussian"
+    static bool parse_method(const std::string& name, Method& method);
+    static const char* method_name(Method method);
+
+private:
+    // 한 평면의 region을 가린 뒤 mask 모양대로 되돌려 씁니다. downscale은 그 평면 해상도 기준
+    void composite(cv::Mat plane, const cv::Mat& mask, int downscale);
+    // plane을 block 크기 블록 모자이크로 obscured_에 씁니다 (끝의 부분 블록 포함)
+    void pixelate(const cv::Mat& plane, int block);
+
+    Method method_;
+    int downscale_;
+    int kernel_;
+    int gaussian_ksize_;
+    cv::Mat mask_;        // 합집합 영역 크기의 합친 마스크
+    cv::Mat chroma_mask_; // 크로마 해상도로 줄인 mask_
+    cv::Mat small_;       // 축소 영상
+    cv::Mat obscured_;    // 가린 영상 (영역 크기)
+};
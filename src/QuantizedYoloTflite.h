@@ -0,0 +1,217 @@
+#pragma once
+
+#include "types.h"
+#include "InputQuantizer.h"
+#include "YoloDecoder.h"
+#include "InferenceThreadPool.h"
+#include <opencv2/opencv.hpp>
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <tensorflow/lite/interpreter.h>
+#include <tensorflow/lite/kernels/register.h>
+#include <tensorflow/lite/model.h>
+#include <tensorflow/lite/interpreter_builder.h>
+#include <tensorflow/lite/delegates/xnnpack/xnnpack_delegate.h>
+
+// int8 양자화 YOLO TFLite 모델 공용 엔진 (Detector, Fall).
+// 인터프리터/XNNPACK 설정(스레드는 InferenceThreadPool 공유), 입력 전처리(InputQuantizer), 배치 추론, 출력 디코드(YoloInt8Decoder)를 담당하고
+// 모델마다 다른 부분은 Traits로 컴파일 타임에 받습니다. 새 모델은 Traits 구조체만 만들면 됩니다:
+//
+//   struct MyTraits {
+//       static constexpr const char* kDefaultModelPath = "../my_192.tflite";
+//       static constexpr std::array<const char*, 2> kClassNames = {"a", "b"};
+//       static constexpr std::array<int, 1> kTargetClasses = {0}; // 비어 있으면 모든 클래스
+//       static constexpr float kConfThreshold = 0.4f;
+//       static constexpr float kNmsThreshold = 0.45f;
+//   };
+//
+// 출력 텐서의 속성 수가 4 + 클래스 수와 다르거나 모델을 열 수 없으면 std::runtime_error를 던집니다.
+template <typename Traits>
+class QuantizedYoloTflite {
+public:
+    static constexpr size_t kNumClasses = Traits::kClassNames.size();
+    static constexpr float default_conf_threshold = Traits::kConfThreshold;
+    static constexpr float default_nms_threshold = Traits::kNmsThreshold;
+
+    explicit QuantizedYoloTflite(const std::string& model_path)
+        : xnnpack_delegate(nullptr, &TfLiteXNNPackDelegateDelete),
+          class_names(Traits::kClassNames.begin(), Traits::kClassNames.end())
+    {
+        static_assert(kNumClasses > 0 && kNumClasses <= 128, "클래스 id는 int8 레인에 담겨야 합니다");
+        static_assert(targets_valid(), "kTargetClasses는 클래스 범위 안에서 오름차순이어야 합니다");
+
+        const auto started = std::chrono::steady_clock::now();
+        model = tflite::FlatBufferModel::BuildFromFile(model_path.c_str());
+        if (!model) {
+            throw std::runtime_error("모델 로드 실패: " + model_path);
+        }
+        InferenceThreadPool& pool = InferenceThreadPool::instance();
+        tflite::ops::builtin::BuiltinOpResolver resolver;
+        tflite::InterpreterBuilder(*model, resolver)(&interpreter, pool.threads());
+        if (!interpreter) {
+            throw std::runtime_error("인터프리터 생성 실패: " + model_path);
+        }
+        interpreter->SetExternalContext(kTfLiteCpuBackendContext, pool.tflite_context());
+        TfLiteXNNPackDelegateOptions xnnpack_options = TfLiteXNNPackDelegateOptionsDefault();
+        xnnpack_options.num_threads = pool.threads();
+        xnnpack_delegate.reset(TfLiteXNNPackDelegateCreate(&xnnpack_options));
+        {
+            // 델리게이트 적용과 텐서 할당은 공유 CPU 백엔드 컨텍스트와 스레드 풀을 건드리므로
+            // 로더 스레드에서도 다른 모델의 추론과 겹치지 않게 함
+            auto gate = pool.enter();
+            // XNNPACK은 ModifyGraphWithDelegate() 안에서 가중치를 다시 포장하므로 생성 시간의 대부분이 이 구간
+            const auto delegate_started = std::chrono::steady_clock::now();
+            if (interpreter->ModifyGraphWithDelegate(xnnpack_delegate.get()) != kTfLiteOk) {
+                std::cerr << "XNNPACK 델리게이트 추가 실패!" << std::endl;
+            }
+            delegate_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - delegate_started).count();
+            if (interpreter->AllocateTensors() != kTfLiteOk) {
+                throw std::runtime_error("텐서 할당 실패: " + model_path);
+            }
+        }
+        input_idx = interpreter->inputs()[0];
+        TfLiteIntArray* in_dims = interpreter->tensor(input_idx)->dims;
+        in_h = in_dims->data[1];
+        in_w = in_dims->data[2];
+        in_c = in_dims->data[3];
+        input_scale = interpreter->tensor(input_idx)->params.scale;
+        input_zero_point = interpreter->tensor(input_idx)->params.zero_point;
+        output_idx = interpreter->outputs()[0];
+        TfLiteIntArray* out_dims = interpreter->tensor(output_idx)->dims;
+        out_num_attr = out_dims->data[1];
+        out_num_det = out_dims->data[2];
+        if (out_num_attr != 4 + static_cast<int>(kNumClasses)) {
+            throw std::runtime_error("출력 형식이 클래스 표와 맞지 않음: " + model_path + " (속성 " +
+                                     std::to_string(out_num_attr) + ", 클래스 " + std::to_string(kNumClasses) + ")");
+        }
+        output_scale = interpreter->tensor(output_idx)->params.scale;
+        output_zero_point = interpreter->tensor(output_idx)->params.zero_point;
+        input_quantizer.configure(input_scale, input_zero_point);
+        decoder.configure(output_scale, output_zero_point, static_cast<int>(kNumClasses), out_num_det,
+                          std::vector<int>(Traits::kTargetClasses.begin(), Traits::kTargetClasses.end()));
+        construct_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - started).count();
+    }
+
+    ~QuantizedYoloTflite() {
+        // 인터프리터 소멸자가 공유 CPU 백엔드 컨텍스트의 캐시를 비우므로 다른 모델의 추론과 겹치지 않게 함
+        auto gate = InferenceThreadPool::instance().enter();
+        interpreter.reset();
+    }
+
+    QuantizedYoloTflite(const QuantizedYoloTflite&) = delete;
+    QuantizedYoloTflite& operator=(const QuantizedYoloTflite&) = delete;
+
+    std::vector<DetectionResult> detect(const cv::Mat& image, float conf_threshold = default_conf_threshold,
+                                        float nms_threshold = default_nms_threshold) {
+        std::vector<FrameRegion> regions(1);
+        regions[0].image = &image;
+        regions[0].roi = cv::Rect(0, 0, image.cols, image.rows);
+        std::vector<std::vector<DetectionResult>> results;
+        detect_regions(regions, conf_threshold, nms_threshold, results);
+        return std::move(results[0]);
+    }
+
+    // 여러 프레임 영역을 입력 텐서의 배치 차원에 쌓아 Invoke() 한 번으로 추론하고 영역별 결과로 나눠 돌려줍니다.
+    // 전처리(리샘플 + BGR→RGB + 양자화)는 프레임에서 입력 텐서로 바로 쓰며, 박스 좌표는 각 roi 크기 기준입니다.
+    // 모델이 배치 크기 변경을 지원하지 않으면 한 장씩 나눠 실행합니다.
+    // results는 호출자가 계속 넘겨 재사용하는 버퍼로, 영역별 벡터의 용량이 유지됩니다.
+    void detect_regions(const std::vector<FrameRegion>& regions, float conf_threshold, float nms_threshold,
+                        std::vector<std::vector<DetectionResult>>& results) {
+        const int batch = static_cast<int>(regions.size());
+        if (results.size() < regions.size()) results.resize(regions.size());
+        if (batch == 0) return;
+
+        const cv::Size input_size(in_w, in_h);
+        if (batch == 1 || !resize_batch(batch)) {
+            if (batch_size != 1) resize_batch(1);
+            for (int b = 0; b < batch; ++b) {
+                input_quantizer.write(regions[b], input_size, interpreter->typed_tensor<int8_t>(input_idx));
+                invoke();
+                decoder.decode(interpreter->typed_tensor<int8_t>(output_idx), regions[b].roi.size(), conf_threshold, nms_threshold, results[b]);
+            }
+            return;
+        }
+
+        // 영역 b의 입력/출력은 배치 차원을 따라 연속으로 놓임
+        const size_t input_stride = static_cast<size_t>(in_h) * in_w * in_c;
+        const size_t output_stride = static_cast<size_t>(out_num_attr) * out_num_det;
+        int8_t* input_ptr = interpreter->typed_tensor<int8_t>(input_idx);
+        for (int b = 0; b < batch; ++b) {
+            input_quantizer.write(regions[b], input_size, input_ptr + b * input_stride);
+        }
+        invoke();
+        const int8_t* out_data_int8 = interpreter->typed_tensor<int8_t>(output_idx);
+        for (int b = 0; b < batch; ++b) {
+            decoder.decode(out_data_int8 + b * output_stride, regions[b].roi.size(), conf_threshold, nms_threshold, results[b]);
+        }
+    }
+
+    cv::Size get_input_size() const { return cv::Size(in_w, in_h); }
+    // 생성에 걸린 시간과 그중 XNNPACK 델리게이트 적용(가중치 포장)에 걸린 시간 (ModelPool 로드 로그)
+    double get_construct_ms() const { return construct_ms; }
+    double get_delegate_ms() const { return delegate_ms; }
+    const std::vector<std::string>& get_class_names() const { return class_names; }
+
+private:
+    static constexpr bool targets_valid() {
+        for (size_t i = 0; i < Traits::kTargetClasses.size(); ++i) {
+            if (Traits::kTargetClasses[i] < 0 || Traits::kTargetClasses[i] >= static_cast<int>(kNumClasses)) return false;
+            if (i > 0 && Traits::kTargetClasses[i - 1] >= Traits::kTargetClasses[i]) return false;
+        }
+        return true;
+    }
+
+    void invoke() {
+        auto gate = InferenceThreadPool::instance().enter();
+        interpreter->Invoke();
+    }
+
+    // 입력 텐서의 배치 차원을 바꿉니다. 실패하면 배치 1로 되돌리고 이후로는 시도하지 않습니다.
+    bool resize_batch(int batch) {
+        if (batch == batch_size) return true;
+        if (!batch_resizable) return false;
+
+        // AllocateTensors()가 연산 Prepare를 다시 돌리며 공유 CPU 백엔드 컨텍스트를 건드릴 수 있음
+        auto gate = InferenceThreadPool::instance().enter();
+        if (interpreter->ResizeInputTensor(input_idx, {batch, in_h, in_w, in_c}) == kTfLiteOk &&
+            interpreter->AllocateTensors() == kTfLiteOk &&
+            interpreter->tensor(output_idx)->dims->data[0] == batch) {
+            batch_size = batch;
+            return true;
+        }
+
+        std::cerr << "[WARN] 모델이 배치 크기 " << batch << "을(를) 지원하지 않아 한 장씩 추론합니다." << std::endl;
+        batch_resizable = false;
+        interpreter->ResizeInputTensor(input_idx, {1, in_h, in_w, in_c});
+        interpreter->AllocateTensors();
+        batch_size = 1;
+        return false;
+    }
+
+    // 델리게이트는 인터프리터보다 나중에 해제돼야 하므로 먼저 선언
+    std::unique_ptr<TfLiteDelegate, decltype(&TfLiteXNNPackDelegateDelete)> xnnpack_delegate;
+    std::unique_ptr<tflite::FlatBufferModel> model;
+    std::unique_ptr<tflite::Interpreter> interpreter;
+    float input_scale = 1.0f;
+    int input_zero_point = 0;
+    float output_scale = 1.0f;
+    int output_zero_point = 0;
+    int in_h = 0, in_w = 0, in_c = 0;
+    int out_num_attr = 0, out_num_det = 0;
+    int input_idx = 0, output_idx = 0;
+    std::vector<std::string> class_names; // InferenceResult로 복사해 가므로 문자열로 보관
+    int batch_size = 1;           // 현재 입력 텐서의 배치 차원
+    bool batch_resizable = true;  // ResizeInputTensor 실패 후에는 배치 1로 고정
+    double construct_ms = 0.0;
+    double delegate_ms = 0.0;
+
+    // 전처리 커널과 후처리 디코더 (둘 다 프레임마다 버퍼를 재사용)
+    InputQuantizer input_quantizer;
+    YoloInt8Decoder decoder;
+};
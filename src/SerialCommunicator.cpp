@@ -60,6 +60,7 @@ bool SerialCommunicator::isOpen() const {
 // 응답을 기다리지 않고 데이터 프레임을 보내기만 합니다.
 bool SerialCommunicator::send(const std::vector<uint8_t>& frame) {
     if (!isOpen()) return false;
+    std::lock_guard<std::mutex> lock(io_mutex_);
     ssize_t bytes_written = write(fd_, frame.data(), frame.size());
     return bytes_written == static_cast<ssize_t>(frame.size());
 }
@@ -67,6 +68,7 @@ bool SerialCommunicator::send(const std::vector<uint8_t>& frame) {
 // 요청 전송, 로그 출력, 응답 수신, 파싱, 로그 출력을 모두 처리하는 메인 함수
 std::optional<ParsedFrame> SerialCommunicator::sendAndReceive(const std::vector<uint8_t>& frame_to_send, const std::string& log_description) {
     if (!isOpen()) return std::nullopt;
+    std::lock_guard<std::mutex> lock(io_mutex_);
 
     std::cout << log_description << std::endl;
     std::cout << "[TX RAW] " << STM32Protocol::frameToString(frame_to_send) << std::endl;
@@ -140,6 +142,7 @@ std::vector<uint8_t> SerialCommunicator::read_raw_frame(int timeout_ms) {
 }
 
 uint8_t SerialCommunicator::getNextSeq() {
+    std::lock_guard<std::mutex> lock(io_mutex_);
     uint8_t current_seq = seq_;
     seq_ = (seq_ + 1) % 256; // 0~255 범위를 순환하도록 함
     return current_seq;
@@ -4,6 +4,7 @@
 #include <vector>
 #include <cstdint>
 #include <optional> // optional을 위해 포함
+#include <mutex>
 #include "STM32Protocol.h" // ParsedFrame을 위해 포함
 
 class SerialCommunicator {
@@ -22,6 +23,9 @@ private:
     bool is_open_ = false;
     uint8_t seq_ = 0;
 
+    // 추론/렌더/API 스레드가 같은 포트를 공유하므로 송수신 한 쌍을 직렬화
+    std::mutex io_mutex_;
+
     // 내부 헬퍼 함수
     int read_byte(uint8_t& out, int timeout_ms);
     std::vector<uint8_t> read_raw_frame(int timeout_ms);
@@ -0,0 +1,177 @@
+#include "ServerConfig.h"
+#include "json.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+
+namespace {
+
+QueuePolicy parse_queue_policy(const std::string& name, QueuePolicy fallback) {
+    if (name == "drop_oldest") return QueuePolicy::DropOldest;
+    if (name == "block") return QueuePolicy::Block;
+    std::cerr << "[WARN] 알 수 없는 큐 정책: " << name << " (기본값 사용)" << std::endl;
+    return fallback;
+}
+
+PixelFormat parse_pixel_format(const std::string& name, PixelFormat fallback) {
+    if (name == "bgr") return PixelFormat::Bgr;
+    if (name == "i420") return PixelFormat::I420;
+    if (name == "nv12") return PixelFormat::Nv12;
+    std::cerr << "[WARN] 알 수 없는 픽셀 형식: " << name << " (기본값 사용)" << std::endl;
+    return fallback;
+}
+
+void read_queue_config(const nlohmann::json& j, QueueConfig& out) {
+    out.capacity = j.value("capacity", out.capacity);
+    if (j.contains("policy")) {
+        out.policy = parse_queue_policy(j["policy"].get<std::string>(), out.policy);
+    }
+}
+
+void read_capture_config(const nlohmann::json& j, CaptureConfig& out) {
+    out.backend = j.value("backend", out.backend);
+    out.width = j.value("width", out.width);
+    out.height = j.value("height", out.height);
+    out.framerate = j.value("framerate", out.framerate);
+    if (j.contains("format")) {
+        out.format = parse_pixel_format(j["format"].get<std::string>(), out.format);
+    }
+    out.path = j.value("path", out.path);
+    out.loop = j.value("loop", out.loop);
+    out.paced = j.value("paced", out.paced);
+    out.device = j.value("device", out.device);
+    out.io_mode = j.value("io_mode", out.io_mode);
+    out.buffer_count = j.value("buffer_count", out.buffer_count);
+}
+
+void read_output_config(const nlohmann::json& j, OutputConfig& out) {
+    out.rtsp_url = j.value("rtsp_url", out.rtsp_url);
+    out.encoder = j.value("encoder", out.encoder);
+}
+
+// 카메라 목록이 비어 있으면 최상위 설정으로 단일 카메라를 구성 (기존 설정 파일 호환)
+void add_default_camera(ServerConfig& config) {
+    if (!config.cameras.empty()) return;
+    CameraConfig camera;
+    camera.capture = config.capture;
+    camera.output = config.output;
+    config.cameras.push_back(camera);
+}
+
+} // namespace
+
+ServerConfig loadServerConfig(const std::string& path) {
+    ServerConfig config;
+
+    std::ifstream file(path);
+    if (!file) {
+        std::cout << "[INFO] 설정 파일이 없어 기본값을 사용합니다: " << path << std::endl;
+        add_default_camera(config);
+        return config;
+    }
+
+    try {
+        nlohmann::json root = nlohmann::json::parse(file);
+
+        if (root.contains("capture")) read_capture_config(root["capture"], config.capture);
+        if (root.contains("output")) read_output_config(root["output"], config.output);
+        if (root.contains("pipeline")) {
+            const auto& pipeline = root["pipeline"];
+            if (pipeline.contains("inference_queue")) read_queue_config(pipeline["inference_queue"], config.pipeline.inference_queue);
+            if (pipeline.contains("render_queue")) read_queue_config(pipeline["render_queue"], config.pipeline.render_queue);
+            if (pipeline.contains("inference_cadence")) {
+                const auto& cadence = pipeline["inference_cadence"];
+                config.pipeline.infer_every_n_frames = std::max(1, cadence.value("every_n_frames", config.pipeline.infer_every_n_frames));
+                config.pipeline.infer_target_fps = std::max(0.0, cadence.value("target_fps", config.pipeline.infer_target_fps));
+                config.pipeline.propagate_boxes = cadence.value("propagate_boxes", config.pipeline.propagate_boxes);
+            }
+            if (pipeline.contains("tracking")) {
+                const auto& tracking = pipeline["tracking"];
+                TrackerConfig& tracker = config.pipeline.tracker;
+                tracker.enabled = tracking.value("enabled", tracker.enabled);
+                tracker.high_threshold = tracking.value("high_threshold", tracker.high_threshold);
+                tracker.match_iou = tracking.value("match_iou", tracker.match_iou);
+                tracker.min_hits = std::max(1, tracking.value("min_hits", tracker.min_hits));
+                tracker.max_age = std::max(0, tracking.value("max_age", tracker.max_age));
+            }
+            if (pipeline.contains("motion_gate")) {
+                const auto& gate_json = pipeline["motion_gate"];
+                MotionGateConfig& gate = config.pipeline.motion_gate;
+                gate.enabled = gate_json.value("enabled", gate.enabled);
+                gate.modes = gate_json.value("modes", gate.modes);
+                gate.scale = std::max(1, gate_json.value("scale", gate.scale));
+                gate.pixel_threshold = gate_json.value("pixel_threshold", gate.pixel_threshold);
+                gate.min_changed_ratio = gate_json.value("min_changed_ratio", gate.min_changed_ratio);
+                gate.max_skip_ms = std::max(0, gate_json.value("max_skip_ms", gate.max_skip_ms));
+                gate.background_rate = gate_json.value("background_rate", gate.background_rate);
+            }
+            if (pipeline.contains("conditioning")) {
+                const auto& cond_json = pipeline["conditioning"];
+                ConditioningConfig& cond = config.pipeline.conditioning;
+                cond.kernel = cond_json.value("kernel", cond.kernel);
+                cond.contrast = cond_json.value("contrast", cond.contrast);
+                cond.gamma = cond_json.value("gamma", cond.gamma);
+            }
+            if (pipeline.contains("blur")) {
+                const auto& blur_json = pipeline["blur"];
+                BlurConfig& blur = config.pipeline.blur;
+                blur.method = blur_json.value("method", blur.method);
+                blur.downscale = std::max(1, blur_json.value("downscale", blur.downscale));
+                blur.kernel = std::max(1, blur_json.value("kernel", blur.kernel));
+                blur.gaussian_ksize = std::max(1, blur_json.value("gaussian_ksize", blur.gaussian_ksize)) | 1;
+            }
+        }
+        if (root.contains("models")) {
+            const auto& models = root["models"];
+            config.models.detection_path = models.value("detection", config.models.detection_path);
+            config.models.segmentation_path = models.value("segmentation", config.models.segmentation_path);
+            config.models.fall_path = models.value("fall", config.models.fall_path);
+            config.models.memory_budget_mb = std::max(0, models.value("memory_budget_mb", config.models.memory_budget_mb));
+            config.models.prewarm = models.value("prewarm", config.models.prewarm);
+            if (models.contains("onnx")) {
+                const auto& onnx_json = models["onnx"];
+                auto& onnx = config.models.onnx;
+                onnx.intra_op_threads = std::max(0, onnx_json.value("intra_op_threads", onnx.intra_op_threads));
+                onnx.inter_op_threads = std::max(0, onnx_json.value("inter_op_threads", onnx.inter_op_threads));
+                onnx.graph_optimization = onnx_json.value("graph_optimization", onnx.graph_optimization);
+                onnx.execution_mode = onnx_json.value("execution_mode", onnx.execution_mode);
+                onnx.cpu_mem_arena = onnx_json.value("cpu_mem_arena", onnx.cpu_mem_arena);
+                onnx.mem_pattern = onnx_json.value("mem_pattern", onnx.mem_pattern);
+                onnx.optimized_model_dir = onnx_json.value("optimized_model_dir", onnx.optimized_model_dir);
+            }
+        }
+        if (root.contains("inference")) {
+            const auto& inference = root["inference"];
+            config.inference.max_batch = std::max(1, inference.value("max_batch", config.inference.max_batch));
+            config.inference.batch_window_ms = std::max(0, inference.value("batch_window_ms", config.inference.batch_window_ms));
+            config.inference.threads = std::max(1, inference.value("threads", config.inference.threads));
+            config.inference.opencv_threads = std::max(-1, inference.value("opencv_threads", config.inference.opencv_threads));
+        }
+        if (root.contains("cameras")) {
+            for (const auto& entry : root["cameras"]) {
+                CameraConfig camera;
+                camera.id = entry.value("id", static_cast<int>(config.cameras.size()) + 1);
+                camera.mode = entry.value("mode", camera.mode);
+                camera.capture = config.capture;
+                camera.output = config.output;
+                if (entry.contains("capture")) read_capture_config(entry["capture"], camera.capture);
+                if (entry.contains("output")) read_output_config(entry["output"], camera.output);
+                if (entry.contains("zones")) {
+                    std::string error;
+                    if (!zones_from_json(entry["zones"], camera.zones, error)) {
+                        std::cerr << "[WARN] 카메라 " << camera.id << " 구역 설정 무시: " << error << std::endl;
+                        camera.zones.clear();
+                    }
+                }
+                config.cameras.push_back(camera);
+            }
+        }
+        std::cout << "[INFO] 설정 파일 로드 완료: " << path << std::endl;
+    } catch (const std::exception& e) {
+        std::cerr << "[WARN] 설정 파일 파싱 실패 (기본값 사용): " << e.what() << std::endl;
+        config = ServerConfig{};
+    }
+    add_default_camera(config);
+    return config;
+}
@@ -0,0 +1,155 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstddef>
+#include "FrameQueue.h"
+#include "Frame.h"
+#include "Zone.h"
+
+// 단계 사이 큐 하나의 설정
+struct QueueConfig {
+    size_t capacity = 2;
+    QueuePolicy policy = QueuePolicy::DropOldest;
+};
+
+// 검출 추적 설정 (SORT/ByteTrack 방식)
+struct TrackerConfig {
+    bool enabled = true;
+    float high_threshold = 0.6f; // 이 이상의 검출만 새 트랙을 만들고 먼저 매칭 (낮은 검출은 기존 트랙 유지에만 사용)
+    float match_iou = 0.3f;      // 예측 박스와 검출의 최소 IoU
+    int min_hits = 2;            // 이만큼 연속으로 매칭돼야 트랙 ID를 부여 (순간 오검출로 알림이 나가지 않도록)
+    int max_age = 15;            // 추론 프레임 기준으로 이만큼 놓치면 트랙 삭제
+};
+
+// 움직임 게이트 설정: 장면이 정지해 있으면 추론을 건너뜀
+struct MotionGateConfig {
+    bool enabled = true;
+    std::vector<std::string> modes = {"trespass", "fall"}; // 게이트를 적용할 모드
+    int scale = 8;                  // 1/scale 해상도 휘도로 비교
+    int pixel_threshold = 20;       // 배경과 이보다 크게 다른 픽셀을 변화로 봄 (0~255)
+    double min_changed_ratio = 0.002; // 변한 픽셀 비율이 이 이상이면 추론
+    int max_skip_ms = 1000;         // 움직임이 없어도 이 간격마다 한 번은 추론 (안전 하한)
+    double background_rate = 0.05;  // 배경 갱신 비율 (지수 이동 평균)
+};
+
+// 캡처 프레임 조건화 (3x3 블러 + 밝기/대비/감마). 밝기는 클라이언트가 실행 중에 바꿉니다.
+struct ConditioningConfig {
+    std::string kernel = "fused";   // "fused" (블러+곡선 한 번에, SIMD) | "opencv" (GaussianBlur + LUT)
+    double contrast = 1.0;          // 곡선 기울기
+    double gamma = 1.0;             // 1보다 크면 어두운 부분을 밝힘
+};
+
+// blur 모드 렌더링 (사람 마스크 영역 가리기)
+struct BlurConfig {
+    std::string method = "pyramid"; // "pyramid" (축소 → box blur → 확대) | "pixelate" (모자이크) | "gaussian" (사람마다 가우시안, 기존 방식)
+    int downscale = 8;              // pyramid/pixelate: 축소 비율. pixelate에서는 블록 한 변(픽셀)
+    int kernel = 3;                 // pyramid: 축소 영상에서의 box blur 크기 (클수록 더 흐림)
+    int gaussian_ksize = 51;        // gaussian: 커널 크기 (홀수)
+};
+
+// 캡처 → 추론 → 렌더/인코딩 파이프라인 설정
+struct PipelineConfig {
+    // 추론 단계는 항상 최신 프레임만 보면 되므로 깊이 1
+    QueueConfig inference_queue{1, QueuePolicy::DropOldest};
+    // 렌더/인코딩 단계는 짧은 지터를 흡수할 정도만 보관
+    QueueConfig render_queue{4, QueuePolicy::DropOldest};
+
+    // 추론 주기. 건너뛴 프레임은 마지막 추론 결과를 다시 그립니다. (기본값: 매 프레임 시도)
+    int infer_every_n_frames = 1;  // N번째 프레임마다 추론
+    double infer_target_fps = 0.0; // 0보다 크면 초당 이 횟수 이하로만 추론
+    // 추론하지 않은 프레임에서 박스를 저해상도 템플릿 매칭으로 추정한 움직임만큼 옮겨 그림
+    bool propagate_boxes = true;
+
+    // 검출에 트랙 ID를 붙여 알림/DB 저장을 프레임이 아니라 사람(트랙)마다 한 번만 냄
+    TrackerConfig tracker;
+
+    MotionGateConfig motion_gate;
+
+    ConditioningConfig conditioning;
+
+    BlurConfig blur;
+};
+
+// 프레임 소스 설정
+struct CaptureConfig {
+    std::string backend = "gstreamer"; // "gstreamer" | "appsink" | "v4l2" | "file" | "synthetic"
+    int width = 640;
+    int height = 480;
+    int framerate = 30;
+    // 캡처 픽셀 형식. i420/nv12는 전체 프레임 videoconvert 없이 카메라 출력을 그대로 사용
+    PixelFormat format = PixelFormat::Bgr; // "bgr" | "i420" | "nv12"
+    std::string path;    // file: 동영상 파일 또는 이미지 디렉터리 경로
+    bool loop = true;    // file: 끝에 도달하면 처음부터 다시 재생
+    bool paced = true;   // file/synthetic: framerate에 맞춰 전달 (false면 최대 속도)
+    std::string device = "/dev/video0"; // v4l2: 캡처 장치
+    std::string io_mode = "mmap";       // v4l2: "mmap" | "dmabuf" (dma-heap 버퍼 가져오기)
+    int buffer_count = 4;               // v4l2: 드라이버 큐에 넣을 버퍼 수
+};
+
+// RTSP 출력 설정
+struct OutputConfig {
+    std::string rtsp_url = "rtsps://127.0.0.1:8555/processed";
+    std::string encoder = "h264_v4l2m2m"; // 라즈베리파이 하드웨어 인코더 (x86에서는 libx264)
+};
+
+// 카메라 한 대의 파이프라인 설정. capture/output은 최상위 값을 기본으로 항목별로 덮어씁니다.
+struct CameraConfig {
+    int id = 1;                 // DB의 camera_id
+    std::string mode = "raw";   // 시작 모드
+    CaptureConfig capture;
+    OutputConfig output;
+    std::vector<Zone> zones;    // 침입 감지 구역 (프레임 좌표 다각형, 비어 있으면 전체 프레임)
+};
+
+// segmenter의 ONNX Runtime 세션 프로필 (models.onnx)
+struct OnnxSessionConfig {
+    // 0이면 공유 추론 스레드 풀(inference.threads)을 씀. 양수면 이 세션만의 스레드 풀을 만듦
+    int intra_op_threads = 0;
+    int inter_op_threads = 0;
+    std::string graph_optimization = "all";    // "disabled", "basic", "extended", "all"
+    std::string execution_mode = "sequential"; // "sequential", "parallel"
+    bool cpu_mem_arena = true;
+    bool mem_pattern = true;
+    // 최적화된 그래프를 저장해 두고 다음 로드부터 그래프 최적화를 건너뜀 (비어 있으면 끔)
+    std::string optimized_model_dir = "cache/onnx";
+};
+
+// 모든 카메라가 공유하는 모델 파일 경로와 모델 풀 설정
+struct ModelConfig {
+    std::string detection_path = "models/detect_192.tflite";
+    std::string segmentation_path = "models/yolo11n-seg.onnx";
+    std::string fall_path = "models/fall_192.tflite";
+    // 로드된 모델의 추정 메모리 합 상한. 넘으면 쓰지 않는 모델부터 LRU로 내림 (0이면 무제한)
+    int memory_budget_mb = 256;
+    // 시작할 때 모든 모델을 올리고 더미 추론을 한 번씩 돌려 둠
+    bool prewarm = false;
+    OnnxSessionConfig onnx;
+};
+
+// 공유 추론 엔진 설정
+struct InferenceConfig {
+    // 여러 카메라의 요청을 한 번의 Invoke()/Run()으로 묶을 최대 배치 크기 (1이면 배치 끔)
+    int max_batch = 4;
+    // 첫 요청 이후 같은 모델을 쓰는 다른 카메라의 요청을 기다리는 시간.
+    // 0이면 이미 대기 중인 요청만 묶어 지연이 늘지 않고, 늘릴수록 배치가 커져 처리량이 늘어납니다.
+    int batch_window_ms = 0;
+    // TFLite(XNNPACK 포함)와 ONNX Runtime이 함께 쓰는 추론 스레드 수 (InferenceThreadPool)
+    int threads = 4;
+    // cv::setNumThreads 값. 카메라마다 스레드가 따로 있으므로 작게 둠 (-1이면 OpenCV 기본값)
+    int opencv_threads = 2;
+};
+
+// 서버 전체 설정 (config/server.json)
+struct ServerConfig {
+    CaptureConfig capture;
+    OutputConfig output;
+    PipelineConfig pipeline;
+    ModelConfig models;
+    InferenceConfig inference;
+    // "cameras" 배열이 없으면 최상위 capture/output으로 카메라 1대(id 1)를 구성합니다.
+    std::vector<CameraConfig> cameras;
+};
+
+// JSON 설정 파일을 읽습니다. 파일이 없거나 항목이 빠져 있으면 기본값을 사용합니다.
+ServerConfig loadServerConfig(const std::string& path);
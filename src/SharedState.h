@@ -4,12 +4,6 @@
 #include <mutex>
 #include <atomic>
 
-// 현재 작동 모드를 저장하는 전역 변수 (예: "detect", "blur")
-extern std::string g_current_mode;
-
-// g_current_mode에 대한 스레드 안전 접근을 보장하는 뮤텍스
-extern std::mutex g_mode_mutex;
-
 // 메인 루프를 종료시키기 위한 원자적 불리언 변수
 extern std::atomic<bool> g_keep_running;
 
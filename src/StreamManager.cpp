@@ -0,0 +1,196 @@
+#include "StreamManager.h"
+#include "SharedState.h"
+#include "AnomalyDetector.h"
+#include "DatabaseManager.h"
+#include "SerialCommunicator.h"
+#include "STM32Protocol.h"
+#include "driver/led_pwm/led_controller/led_pwm_controller.h"
+
+#include <iostream>
+#include <set>
+#include <stdexcept>
+#include <termios.h>
+#include <thread>
+
+StreamManager::StreamManager(DatabaseManager& dbManager, const ServerConfig& config) {
+    system_monitor_ = std::make_unique<SystemMonitor>();
+    // 시리얼 통신 객체 생성
+    serial_comm_ = std::make_unique<SerialCommunicator>("/dev/ttyACM0", B115200);
+    if (!serial_comm_->isOpen()) {
+        std::cerr << "경고: UART 통신을 시작할 수 없습니다." << std::endl;
+    }
+
+    // 이상탐지 객체 생성
+    try {
+        anomaly_detector_ = std::make_unique<AnomalyDetector>();
+        anomaly_detector_->start();
+        std::cout << "이상탐지 시스템 초기화 완료" << std::endl;
+    } catch (const std::exception& e) {
+        std::cerr << "이상탐지 시스템 초기화 실패: " << e.what() << std::endl;
+        anomaly_detector_ = nullptr;
+    }
+
+    try {
+        led_fade_controller_ = std::make_unique<DebouncedFadeController>(LedController::instance(), 3000);
+        std::cout << "[INFO] LED controller initialized successfully." << std::endl;
+    } catch (const std::exception& e) {
+        std::cerr << "[WARN] LED controller disabled: " << e.what() << std::endl;
+        led_fade_controller_ = nullptr;
+    }
+
+    engine_ = std::make_unique<InferenceEngine>(config.models, config.inference);
+    engine_->onModelLoad([this](const ModelLoadEvent& event) {
+        if (event.state == "failed") {
+            // 요청된 모드를 엔진이 유지한 이전 모드로 되돌려 API가 실제 상태를 보여주게 함
+            for (int camera_id : event.camera_ids) {
+                if (StreamProcessor* camera = getCamera(camera_id)) camera->setMode(engine_->activeMode(camera_id));
+            }
+        }
+        if (model_load_callback_) model_load_callback_(event);
+    });
+
+    AlertOutputs alerts;
+    alerts.serial = serial_comm_.get();
+    alerts.led = led_fade_controller_.get();
+    alerts.audio = &audio_notifier_;
+
+    std::set<int> camera_ids;
+    for (const auto& camera : config.cameras) {
+        if (!camera_ids.insert(camera.id).second) {
+            throw std::runtime_error("카메라 id가 중복되었습니다: " + std::to_string(camera.id));
+        }
+        cameras_.push_back(std::make_unique<StreamProcessor>(
+            dbManager, camera, config.pipeline, createFrameSource(camera.capture), *engine_, alerts));
+    }
+}
+
+StreamManager::~StreamManager() {
+    for (auto& camera : cameras_) camera->stop();
+    engine_->stop();
+    if (anomaly_detector_) {
+        anomaly_detector_->stop();
+    }
+}
+
+void StreamManager::run() {
+    engine_->start();
+
+    size_t started = 0;
+    for (auto& camera : cameras_) {
+        // 한 카메라가 실패해도 나머지는 계속 송출
+        if (camera->start()) ++started;
+    }
+    if (started == 0) {
+        std::cerr << "오류: 시작된 카메라가 없습니다." << std::endl;
+        g_keep_running = false;
+    }
+    std::cout << "[INFO] 카메라 " << started << "/" << cameras_.size() << "대 시작" << std::endl;
+
+    while (g_keep_running) {
+        // 이상탐지 처리
+        handle_anomaly_detection();
+
+        // 시스템 정보 모니터링 처리
+        handle_system_info_monitoring();
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    }
+
+    // 카메라 스레드를 먼저 정리한 뒤 엔진을 멈춰, 대기 중인 추론 요청이 모두 돌아가게 함
+    for (auto& camera : cameras_) camera->stop();
+    engine_->stop();
+}
+
+std::vector<StreamProcessor*> StreamManager::getCameras() const {
+    std::vector<StreamProcessor*> cameras;
+    for (const auto& camera : cameras_) cameras.push_back(camera.get());
+    return cameras;
+}
+
+StreamProcessor* StreamManager::getCamera(int camera_id) const {
+    for (const auto& camera : cameras_) {
+        if (camera->getCameraId() == camera_id) return camera.get();
+    }
+    return nullptr;
+}
+
+bool StreamManager::isAnomalyDetected() const {
+    // anomaly_detected_ 변수의 현재 값을 안전하게 읽어서 반환합니다.
+    return anomaly_detected_.load();
+}
+
+SerialCommunicator& StreamManager::getSerialCommunicator() {
+    // unique_ptr이 소유한 객체의 참조를 반환
+    return *serial_comm_;
+}
+
+// 콜백 등록 함수
+void StreamManager::onAnomalyStatusChanged(std::function<void(bool)> callback) { anomaly_callback_ = callback; }
+void StreamManager::onSystemInfoUpdate(std::function<void(double, double)> callback) { system_info_callback_ = callback; }
+void StreamManager::onModelLoad(std::function<void(const ModelLoadEvent&)> callback) { model_load_callback_ = callback; }
+
+void StreamManager::onNewDetection(std::function<void(const DetectionData&)> callback) {
+    for (auto& camera : cameras_) camera->onNewDetection(callback);
+}
+
+void StreamManager::onNewBlur(std::function<void(const PersonCountData&)> callback) {
+    for (auto& camera : cameras_) camera->onNewBlur(callback);
+}
+
+void StreamManager::onNewFall(std::function<void(const FallCountData&)> callback) {
+    for (auto& camera : cameras_) camera->onNewFall(callback);
+}
+
+void StreamManager::onNewTrespass(std::function<void(const TrespassLogData&)> callback) {
+    for (auto& camera : cameras_) camera->onNewTrespass(callback);
+}
+
+void StreamManager::handle_anomaly_detection() {
+    // 1초마다 이상탐지 상태 확인
+    time_t current_time = time(0);
+    if (current_time - last_anomaly_check_ >= ANOMALY_CHECK_INTERVAL) {
+        last_anomaly_check_ = current_time;
+        
+        if (anomaly_detector_) {
+            bool current_anomaly = anomaly_detector_->isAnomalyDetected();
+
+            // [핵심] 이전에 정상이였다가(false) 지금 이상이 감지된(true) 첫 순간에만 실행
+            if (current_anomaly && !anomaly_detected_.load()) {
+
+                // 등록된 콜백이 있으면 호출 
+                if (anomaly_callback_) {
+                anomaly_callback_(current_anomaly);
+                }
+                
+                std::cout << "🚨 이상탐지! 알람을 1회 울립니다." << std::endl;
+
+                if (serial_comm_ && serial_comm_->isOpen()) {
+                    // --- 1. 알람을 켜기 위해 첫 번째 TOGGLE 신호 전송 ---
+                    uint8_t seq1 = serial_comm_->getNextSeq();
+                    auto frame_on = STM32Protocol::buildToggleFrame(seq1);
+                    serial_comm_->sendAndReceive(frame_on, "Sent TOGGLE (ON)");
+                }
+            }
+
+            // 현재 상태를 마지막으로 업데이트
+            anomaly_detected_ = current_anomaly;
+        }
+    }
+}
+
+void StreamManager::handle_system_info_monitoring() {
+    static time_t last_system_info_check = 0;
+    constexpr static int SYSTEM_INFO_CHECK_INTERVAL = 1; // 5초마다 체크
+
+    time_t current_time = time(0);
+    if (current_time - last_system_info_check >= SYSTEM_INFO_CHECK_INTERVAL) {
+        last_system_info_check = current_time;
+
+        if (system_info_callback_ && system_monitor_) { // system_monitor_가 유효한지 확인
+            // CPU 및 메모리 사용률을 멤버 객체를 통해 계산
+            double cpu_usage = system_monitor_->getCpuUsage();
+            double memory_usage = system_monitor_->getMemoryUsage();
+            system_info_callback_(cpu_usage, memory_usage);
+        }
+    }
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+#include "AudioNotifier.h"
+#include "InferenceEngine.h"
+#include "ServerConfig.h"
+#include "StreamProcessor.h"
+#include "SystemMonitor.h"
+#include "driver/led_pwm/led_controller/led_fade_manager.h"
+
+class DatabaseManager;
+class SerialCommunicator;
+class AnomalyDetector;
+
+// 설정된 카메라마다 StreamProcessor를 하나씩 만들고, 모델(InferenceEngine)과
+// 알림 장치(UART, LED, 스피커), 이상음 탐지와 시스템 모니터링을 한 벌만 두어 공유합니다.
+class StreamManager {
+public:
+    // 카메라 프레임 소스를 만들 수 없으면 std::runtime_error를 던집니다.
+    StreamManager(DatabaseManager& dbManager, const ServerConfig& config);
+    ~StreamManager();
+
+    // 모든 카메라 파이프라인을 시작하고 g_keep_running이 false가 될 때까지 모니터링합니다.
+    void run();
+
+    std::vector<StreamProcessor*> getCameras() const;
+    StreamProcessor* getCamera(int camera_id) const;
+    const InferenceEngine& getEngine() const { return *engine_; }
+
+    bool isAnomalyDetected() const;
+    SerialCommunicator& getSerialCommunicator();
+
+    // 웹소켓 콜백 함수 등록 (카메라 이벤트는 모든 카메라에 연결됩니다)
+    void onAnomalyStatusChanged(std::function<void(bool)> callback);
+    void onNewDetection(std::function<void(const DetectionData&)> callback);
+    void onNewBlur(std::function<void(const PersonCountData&)> callback);
+    void onNewFall(std::function<void(const FallCountData&)> callback);
+    void onNewTrespass(std::function<void(const TrespassLogData&)> callback);
+    void onSystemInfoUpdate(std::function<void(double, double)> callback);
+    void onModelLoad(std::function<void(const ModelLoadEvent&)> callback);
+
+private:
+    void handle_anomaly_detection();  // 이상탐지 처리 함수
+    void handle_system_info_monitoring(); // 시스템 정보 모니터링 처리 함수
+
+    std::unique_ptr<SerialCommunicator> serial_comm_;
+    std::unique_ptr<AnomalyDetector> anomaly_detector_;
+    std::unique_ptr<SystemMonitor> system_monitor_;
+    std::unique_ptr<DebouncedFadeController> led_fade_controller_;
+    AudioNotifier audio_notifier_;
+
+    std::unique_ptr<InferenceEngine> engine_;
+    std::vector<std::unique_ptr<StreamProcessor>> cameras_;
+
+    // 이상탐지 관련
+    std::atomic<bool> anomaly_detected_{false};
+    time_t last_anomaly_check_ = 0;
+    constexpr static int ANOMALY_CHECK_INTERVAL = 1;  // 1초마다 체크
+
+    std::function<void(bool)> anomaly_callback_;
+    std::function<void(double, double)> system_info_callback_;
+    std::function<void(const ModelLoadEvent&)> model_load_callback_;
+};
@@ -1,24 +1,56 @@
 #include "StreamProcessor.h"
 #include "SharedState.h"
-#include "detector.h"
-#include "segmenter.h"
-#include "fall.h"
+#include "InferenceEngine.h"
+#include "InferenceResult.h"
 #include "DatabaseManager.h"
 #include "SerialCommunicator.h" 
 #include "STM32Protocol.h"    
-#include "AnomalyDetector.h"
-#include "driver/led_pwm/led_controller/led_pwm_controller.h"
+#include "Overlay.h"
+#include "YuvImage.h"
 
+#include <algorithm>
 #include <iostream>
 #include <thread>
-#include <iomanip>
-#include <sstream>
-#include <termios.h>
-#include <fstream>
-#include <sys/sysinfo.h>
+
+namespace {
+
+ImageConditioner::Kernel conditioning_kernel(const ConditioningConfig& config) {
+    ImageConditioner::Kernel kernel = ImageConditioner::Kernel::Fused;
+    if (!ImageConditioner::parse_kernel(config.kernel, kernel)) {
+        std::cerr << "[WARN] 알 수 없는 조건화 커널 '" << config.kernel << "', fused를 사용합니다." << std::endl;
+    }
+    return kernel;
+}
+
+} // namespace
 
 // 생성자
-StreamProcessor::StreamProcessor(DatabaseManager& dbManager) : db_manager_(dbManager), brightness_beta_(0) {
+StreamProcessor::StreamProcessor(DatabaseManager& dbManager, const CameraConfig& camera, const PipelineConfig& pipeline,
+                                 std::unique_ptr<FrameSource> frameSource, InferenceEngine& engine, const AlertOutputs& alerts)
+    : db_manager_(dbManager),
+      engine_(engine),
+      alerts_(alerts),
+      camera_id_(camera.id),
+      capture_width_(camera.capture.width),
+      capture_height_(camera.capture.height),
+      framerate_(camera.capture.framerate),
+      capture_format_(camera.capture.format),
+      frame_source_(std::move(frameSource)),
+      rtsp_url_(camera.output.rtsp_url),
+      encoder_(camera.output.encoder),
+      mode_(camera.mode),
+      zones_(camera.zones),
+      pipeline_config_(pipeline),
+      privacy_blur_(pipeline.blur),
+      snapshot_blur_(pipeline.blur),
+      brightness_beta_(0),
+      conditioner_(conditioning_kernel(pipeline.conditioning)),
+      tracker_(pipeline.tracker),
+      motion_gate_(pipeline.motion_gate) {
+
+    inference_queue_ = std::make_unique<FrameQueue<Frame>>(pipeline_config_.inference_queue.capacity, pipeline_config_.inference_queue.policy);
+    render_queue_ = std::make_unique<FrameQueue<Frame>>(pipeline_config_.render_queue.capacity, pipeline_config_.render_queue.policy);
+
     color_map_["person"] = cv::Scalar(0, 255, 0);
     color_map_["helmet"] = cv::Scalar(255, 178, 51);
     color_map_["safety-vest"] = cv::Scalar(0, 128, 255);
@@ -26,235 +58,263 @@ StreamProcessor::StreamProcessor(DatabaseManager& dbManager) : db_manager_(dbMan
     color_map_["fall"] = cv::Scalar(0, 0, 255); 
     color_map_["stand"] = cv::Scalar(255, 0, 0); 
 
-    system_monitor_ = std::make_unique<SystemMonitor>();
-    // 시리얼 통신 객체 생성
-    serial_comm_ = std::make_unique<SerialCommunicator>("/dev/ttyACM0", B115200);
-    if (!serial_comm_->isOpen()) {
-        std::cerr << "경고: UART 통신을 시작할 수 없습니다." << std::endl;
-    }
-    
-    // 이상탐지 객체 생성
-    try {
-        anomaly_detector_ = std::make_unique<AnomalyDetector>();
-        anomaly_detector_->start();
-        std::cout << "이상탐지 시스템 초기화 완료" << std::endl;
-    } catch (const std::exception& e) {
-        std::cerr << "이상탐지 시스템 초기화 실패: " << e.what() << std::endl;
-        anomaly_detector_ = nullptr;
-    }
-
-    try {
-        led_fade_controller_ = std::make_unique<DebouncedFadeController>(LedController::instance(), 3000);
-        std::cout << "[INFO] LED controller initialized successfully." << std::endl;
-    } catch (const std::exception& e) {
-        std::cerr << "[WARN] LED controller disabled: " << e.what() << std::endl;
-        led_fade_controller_ = nullptr; 
-    }
+    engine_.registerCamera(camera_id_, mode_);
 }
 
 // 소멸자
 StreamProcessor::~StreamProcessor() {
-    if (anomaly_detector_) {
-        anomaly_detector_->stop();
-    }
+    stop();
     if (proc_processed_) pclose(proc_processed_);
-    if (cap_.isOpened()) cap_.release();
+    if (frame_source_) frame_source_->close();
+}
+
+std::string StreamProcessor::getMode() const {
+    std::lock_guard<std::mutex> lock(mode_mutex_);
+    return mode_;
+}
+
+std::string StreamProcessor::getActiveMode() const {
+    std::lock_guard<std::mutex> lock(mode_mutex_);
+    return active_mode_;
 }
 
-bool StreamProcessor::isAnomalyDetected() const {
-    // anomaly_detected_ 변수의 현재 값을 안전하게 읽어서 반환합니다.
-    return anomaly_detected_.load();
+void StreamProcessor::setMode(const std::string& mode) {
+    {
+        std::lock_guard<std::mutex> lock(mode_mutex_);
+        mode_ = mode;
+    }
+    // 모델이 없으면 엔진이 백그라운드에서 올리고, 그동안 추론 스레드는 이전 모드를 계속 씀
+    engine_.setCameraMode(camera_id_, mode);
+    std::cout << "[CAM " << camera_id_ << "] 모드가 다음으로 변경되었습니다 : " << mode << std::endl;
 }
 
 void StreamProcessor::setBrightness(int beta) {
     std::lock_guard<std::mutex> lock(image_processing_settings_mutex_);
     brightness_beta_ = beta;
-    std::cout << "밝기 설정 변경: " << brightness_beta_ << std::endl;
+    std::cout << "[CAM " << camera_id_ << "] 밝기 설정 변경: " << brightness_beta_ << std::endl;
+}
+
+std::vector<Zone> StreamProcessor::getZones() const {
+    std::lock_guard<std::mutex> lock(zones_mutex_);
+    return zones_;
 }
 
-// 메인 루프 실행
-void StreamProcessor::run() {
+void StreamProcessor::setZones(const std::vector<Zone>& zones) {
+    {
+        std::lock_guard<std::mutex> lock(zones_mutex_);
+        zones_ = zones;
+    }
+    std::cout << "[CAM " << camera_id_ << "] 침입 감지 구역 " << zones.size() << "개 설정" << std::endl;
+}
+
+// 파이프라인 시작
+bool StreamProcessor::start() {
     if (!initialize_camera() || !initialize_streamers()) {
-        g_keep_running = false;
-        return;
+        return false;
     }
 
-    std::cout << "영상 처리 및 스트리밍 루프를 시작합니다..." << std::endl;
-    cv::Mat frame;
+    std::cout << "[CAM " << camera_id_ << "] 영상 처리 및 스트리밍 루프를 시작합니다..." << std::endl;
+
+    // 캡처 → 추론 → 렌더/인코딩을 서로 다른 스레드에서 돌려
+    // 느린 추론이 카메라 읽기와 RTSP 출력을 막지 않도록 합니다.
+    capture_thread_ = std::thread(&StreamProcessor::capture_loop, this);
+    inference_thread_ = std::thread(&StreamProcessor::inference_loop, this);
+    render_thread_ = std::thread(&StreamProcessor::render_loop, this);
+    return true;
+}
+
+void StreamProcessor::stop() {
+    // 캡처 스레드가 g_keep_running을 보고 끝나면서 큐를 닫지만, 시작에 실패한 경우를 위해 직접 닫음
+    inference_queue_->close();
+    render_queue_->close();
+    if (capture_thread_.joinable()) capture_thread_.join();
+    if (inference_thread_.joinable()) inference_thread_.join();
+    if (render_thread_.joinable()) render_thread_.join();
+}
+
+PipelineStats StreamProcessor::getPipelineStats() const {
+    PipelineStats stats;
+    stats.camera_id = camera_id_;
+    stats.mode = getMode();
+    stats.active_mode = getActiveMode();
+    stats.source = frame_source_->name();
+    stats.capture = frame_source_->stats();
+    stats.inference_queue = inference_queue_->stats();
+    stats.render_queue = render_queue_->stats();
+    stats.captured_frames = captured_frames_.load();
+    stats.inferred_frames = inferred_frames_.load();
+    stats.streamed_frames = streamed_frames_.load();
+    stats.cadence_skipped_frames = cadence_skipped_frames_.load();
+    stats.propagated_frames = propagated_frames_.load();
+    stats.motion_gated_frames = motion_gated_frames_.load();
+    stats.motion_changed_ratio = motion_changed_ratio_.load();
+    stats.capture_to_inference = inference_latency_.stats();
+    stats.capture_to_output = output_latency_.stats();
+    stats.frame_pool = frame_pool_.stats();
+    return stats;
+}
+
+void StreamProcessor::capture_loop() {
+    uint64_t seq = 0;
+    // 반복마다 새로 만들지 않음: VideoCapture 계열 소스는 같은 버퍼에 다시 디코딩함
+    Frame raw;
 
     while (g_keep_running) {
-        if (!cap_.read(frame)) {
+        if (!frame_source_->read(raw)) {
             std::this_thread::sleep_for(std::chrono::milliseconds(10));
             continue;
         }
 
-        process_frame_and_stream(frame);
-        
-        // 이상탐지 처리
-        handle_anomaly_detection();
-
-        // 시스템 정보 모니터링 처리
-        handle_system_info_monitoring();
+        Frame frame;
+        frame.format = raw.format;
+        frame.seq = seq++;
+        // 버퍼 시각을 아는 소스(appsink)는 그 값을, 나머지는 읽어 온 시각을 캡처 시각으로 사용
+        frame.captured_at = raw.captured_at.time_since_epoch().count() != 0
+                                ? raw.captured_at : std::chrono::steady_clock::now();
+        frame.pts_ns = raw.pts_ns;
+        frame_pool_.acquire(frame, raw.image.rows, raw.image.cols, raw.image.type());
+        condition_frame(raw.image, raw.format, frame.image);
+        // raw가 소스 버퍼 뷰(v4l2)라면 조건화가 끝났으니 바로 드라이버로 돌려줌
+        raw.buffer_ref.reset();
+        ++captured_frames_;
+
+        // 렌더 단계는 프레임 위에 오버레이를 그리므로 추론 단계에는 별도 버퍼를 넘깁니다.
+        // 추론 주기에서 빠지는 프레임은 복사도 하지 않고 렌더 단계로만 보냅니다.
+        if (should_infer(frame)) {
+            Frame inference_frame = frame;
+            frame_pool_.acquire(inference_frame, frame.image.rows, frame.image.cols, frame.image.type());
+            frame.image.copyTo(inference_frame.image);
+            inference_queue_->push(std::move(inference_frame));
+        } else {
+            ++cadence_skipped_frames_;
+        }
+        render_queue_->push(std::move(frame));
     }
-}
 
-// 콜백 등록 함수
-void StreamProcessor::onAnomalyStatusChanged(std::function<void(bool)> callback) { anomaly_callback_ = callback; }
-void StreamProcessor::onNewDetection(std::function<void(const DetectionData&)> callback) { detection_callback_ = callback; }
-void StreamProcessor::onNewBlur(std::function<void(const PersonCountData&)> callback) { blur_callback_ = callback; }
-void StreamProcessor::onNewFall(std::function<void(const FallCountData&)> callback) { fall_callback_ = callback; }
-void StreamProcessor::onNewTrespass(std::function<void(const TrespassLogData&)> callback) { trespass_callback_ = callback; }
-void StreamProcessor::onSystemInfoUpdate(std::function<void(double, double)> callback) { system_info_callback_ = callback; }
+    // 대기 중인 추론/렌더 단계를 깨워 종료시킵니다.
+    inference_queue_->close();
+    render_queue_->close();
+}
 
+bool StreamProcessor::should_infer(const Frame& frame) {
+    const int every_n = pipeline_config_.infer_every_n_frames;
+    if (every_n > 1 && frame.seq % every_n != 0) return false;
 
-void StreamProcessor::handle_anomaly_detection() {
-    // 1초마다 이상탐지 상태 확인
-    time_t current_time = time(0);
-    if (current_time - last_anomaly_check_ >= ANOMALY_CHECK_INTERVAL) {
-        last_anomaly_check_ = current_time;
-        
-        if (anomaly_detector_) {
-            bool current_anomaly = anomaly_detector_->isAnomalyDetected();
+    const double target_fps = pipeline_config_.infer_target_fps;
+    if (target_fps <= 0.0) return true;
 
-            // [핵심] 이전에 정상이였다가(false) 지금 이상이 감지된(true) 첫 순간에만 실행
-            if (current_anomaly && !anomaly_detected_.load()) {
+    // 캡처 간격의 흔들림 때문에 한 프레임씩 밀리지 않도록 주기의 1/4만큼 일찍 와도 받아들임
+    const auto interval = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+        std::chrono::duration<double>(1.0 / target_fps));
+    if (frame.captured_at + interval / 4 < next_inference_at_) return false;
 
-                // 등록된 콜백이 있으면 호출 
-                if (anomaly_callback_) {
-                anomaly_callback_(current_anomaly);
-                }
-                
-                std::cout << "🚨 이상탐지! 알람을 1회 울립니다." << std::endl;
-
-                if (serial_comm_ && serial_comm_->isOpen()) {
-                    // --- 1. 알람을 켜기 위해 첫 번째 TOGGLE 신호 전송 ---
-                    uint8_t seq1 = serial_comm_->getNextSeq();
-                    auto frame_on = STM32Protocol::buildToggleFrame(seq1);
-                    serial_comm_->sendAndReceive(frame_on, "Sent TOGGLE (ON)");
-                }
-            }
-
-            // 현재 상태를 마지막으로 업데이트
-            anomaly_detected_ = current_anomaly;
-        }
+    next_inference_at_ += interval;
+    if (next_inference_at_ < frame.captured_at) {
+        // 처음이거나 한참 뒤처짐: 지금부터 다시 주기를 셈
+        next_inference_at_ = frame.captured_at + interval;
     }
+    return true;
 }
 
-void StreamProcessor::handle_system_info_monitoring() {
-    static time_t last_system_info_check = 0;
-    constexpr static int SYSTEM_INFO_CHECK_INTERVAL = 1; // 5초마다 체크
-
-    time_t current_time = time(0);
-    if (current_time - last_system_info_check >= SYSTEM_INFO_CHECK_INTERVAL) {
-        last_system_info_check = current_time;
-
-        if (system_info_callback_ && system_monitor_) { // system_monitor_가 유효한지 확인
-            // CPU 및 메모리 사용률을 멤버 객체를 통해 계산
-            double cpu_usage = system_monitor_->getCpuUsage();
-            double memory_usage = system_monitor_->getMemoryUsage();
-            system_info_callback_(cpu_usage, memory_usage);
-        }
+void StreamProcessor::condition_frame(const cv::Mat& src, PixelFormat format, cv::Mat& dst) {
+    int beta;
+    {
+        std::lock_guard<std::mutex> lock(image_processing_settings_mutex_);
+        beta = brightness_beta_;
     }
+
+    // 기본 3x3 가우시안 블러(항상 적용)와 클라이언트가 조절한 밝기, 설정의 대비/감마를 한 번에 적용.
+    // YUV 프레임은 휘도(Y) 평면에만 적용됩니다.
+    const ConditioningConfig& cond = pipeline_config_.conditioning;
+    conditioner_.set_curve(beta, cond.contrast, cond.gamma);
+    conditioner_.apply(src, format, dst);
 }
 
-double StreamProcessor::get_cpu_usage() {
-    static struct {
-        long long user, nice, system, idle, iowait, irq, softirq;
-        bool first_run = true;
-    } cpu_stats;
-
-    std::ifstream file("/proc/stat");
-    std::string line;
-
-    if (std::getline(file, line)) {
-        std::istringstream iss(line);
-        std::string cpu;
-        long long user, nice, system, idle, iowait, irq, softirq;
-
-        iss >> cpu >> user >> nice >> system >> idle >> iowait >> irq >> softirq;
-
-        if (cpu_stats.first_run) {
-            cpu_stats.user = user;
-            cpu_stats.nice = nice;
-            cpu_stats.system = system;
-            cpu_stats.idle = idle;
-            cpu_stats.iowait = iowait;
-            cpu_stats.irq = irq;
-            cpu_stats.softirq = softirq;
-            cpu_stats.first_run = false;
-            return 0.0;
+void StreamProcessor::inference_loop() {
+    Frame frame;
+    while (inference_queue_->pop(frame)) {
+        const std::string active_mode = engine_.activeMode(camera_id_);
+        handle_mode_change(active_mode);
+
+        // 정지 장면이면 추론을 건너뜀. 렌더 단계는 마지막 결과를 계속 그립니다.
+        const MotionGateConfig& gate = pipeline_config_.motion_gate;
+        if (gate.enabled && std::find(gate.modes.begin(), gate.modes.end(), active_mode) != gate.modes.end()) {
+            const bool infer = motion_gate_.should_infer(frame);
+            motion_changed_ratio_ = motion_gate_.last_changed_ratio();
+            if (!infer) {
+                ++motion_gated_frames_;
+                continue;
+            }
         }
 
-        long long total_diff = (user + nice + system + idle + iowait + irq + softirq) - 
-                              (cpu_stats.user + cpu_stats.nice + cpu_stats.system + 
-                               cpu_stats.idle + cpu_stats.iowait + cpu_stats.irq + cpu_stats.softirq);
-
-        long long active_diff = (user + nice + system + irq + softirq) - 
-                               (cpu_stats.user + cpu_stats.nice + cpu_stats.system + 
-                                cpu_stats.irq + cpu_stats.softirq);
-
-        cpu_stats.user = user;
-        cpu_stats.nice = nice;
-        cpu_stats.system = system;
-        cpu_stats.idle = idle;
-        cpu_stats.iowait = iowait;
-        cpu_stats.irq = irq;
-        cpu_stats.softirq = softirq;
+        // 침입 모드에 구역이 있으면 구역을 감싼 크롭만 추론 (작은 사람도 모델 입력에서 크게 보임)
+        // (구역과 크롭 목록은 추론 스레드 전용 버퍼에 복사해 재사용)
+        std::vector<Zone>& zones = zones_scratch_;
+        std::vector<cv::Rect>& rois = rois_scratch_;
+        zones.clear();
+        rois.clear();
+        if (active_mode == "trespass") {
+            {
+                std::lock_guard<std::mutex> lock(zones_mutex_);
+                zones = zones_;
+            }
+            const cv::Size size = frame_size(frame.image, frame.format);
+            for (const Zone& zone : zones) {
+                const cv::Rect crop = zone_crop(zone, size);
+                if (!crop.empty()) rois.push_back(crop);
+            }
+        }
 
-        if (total_diff > 0) {
-            return (static_cast<double>(active_diff) / total_diff) * 100.0;
+        // 모델은 공유 엔진에서 다른 카메라와 번갈아 실행됩니다.
+        std::shared_ptr<InferenceResult> result = engine_.infer(camera_id_, frame, active_mode, rois);
+        if (result && !zones.empty()) {
+            // 크롭은 구역보다 넓으므로 발 위치(박스 하단 중앙)가 구역 안인 검출만 남김
+            auto& detections = result->detections;
+            detections.erase(std::remove_if(detections.begin(), detections.end(), [&](const DetectionResult& det) {
+                const cv::Point foot(det.box.x + det.box.width / 2, det.box.y + det.box.height);
+                return !in_any_zone(zones, foot);
+            }), detections.end());
+        }
+        if (result) {
+            if (pipeline_config_.tracker.enabled && result->mode != "blur") {
+                // 검출이 없는 프레임도 넘겨야 놓친 트랙이 나이를 먹고 정리됨
+                tracker_.update(result->detections);
+            }
+            if (pipeline_config_.propagate_boxes) {
+                // 다음 추론 전까지 렌더 단계가 이 프레임 기준으로 박스 이동량을 추정
+                luma_thumbnail(frame.image, frame.format, BoxPropagator::kScale, result->reference_luma);
+            }
+            handle_inference_events(frame, *result);
+            std::lock_guard<std::mutex> lock(result_mutex_);
+            latest_result_ = std::move(result);
         }
+        ++inferred_frames_;
+        inference_latency_.record(frame.captured_at);
     }
-
-    return 0.0;
 }
 
-double StreamProcessor::get_memory_usage() {
-    struct sysinfo info;
-    if (sysinfo(&info) != 0) {
-        return -1.0;
+void StreamProcessor::render_loop() {
+    Frame frame;
+    while (render_queue_->pop(frame)) {
+        render_and_stream(frame);
     }
-
-    unsigned long total_ram = info.totalram * info.mem_unit;
-    unsigned long free_ram = info.freeram * info.mem_unit;
-    unsigned long used_ram = total_ram - free_ram;
-
-    return (static_cast<double>(used_ram) / total_ram) * 100.0;
 }
 
-void StreamProcessor::process_frame_and_stream(cv::Mat& original_frame) {
-    // 1. 모드 변경 확인 및 모델 로드
-    handle_mode_change();
-
-    std::string active_mode;
-    {
-        std::lock_guard<std::mutex> lock(g_mode_mutex);
-        active_mode = g_current_mode;
-    }
+// 콜백 등록 함수
+void StreamProcessor::onNewDetection(std::function<void(const DetectionData&)> callback) { detection_callback_ = callback; }
+void StreamProcessor::onNewBlur(std::function<void(const PersonCountData&)> callback) { blur_callback_ = callback; }
+void StreamProcessor::onNewFall(std::function<void(const FallCountData&)> callback) { fall_callback_ = callback; }
+void StreamProcessor::onNewTrespass(std::function<void(const TrespassLogData&)> callback) { trespass_callback_ = callback; }
 
-    // 2. 모든 모드에 공통적으로 적용될 프레임 생성
-    cv::Mat processed_frame = original_frame.clone();
 
-    // 3. 공통 이미지 처리 필터 적용
-    // 3-1. 기본 가우시안 블러 (항상 적용)
-    cv::GaussianBlur(processed_frame, processed_frame, cv::Size(gaussian_blur_kernel_size_, gaussian_blur_kernel_size_), 0);
-
-    // 3-2. 클라이언트가 조절한 밝기 적용 (항상 적용)
-    {
-        std::lock_guard<std::mutex> lock(image_processing_settings_mutex_);
-        if (brightness_beta_ != 0) {
-            // alpha(대비)는 1.0으로 고정하고 beta(밝기)만 조절합니다.
-            processed_frame.convertTo(processed_frame, -1, 1.0, brightness_beta_);
-        }
-    }
-
-    // 4. 모드별 특화 처리 (AI 탐지 및 그리기)
-    //    이제 모든 모드는 이미 필터가 적용된 'processed_frame'을 사용합니다.
-    if (active_mode == "detect" && detector_) {
-        auto results = detector_->detect(processed_frame, 0.4, 0.45);
+// 추론 결과에 따른 알림(음성, LED, STM32)과 DB 저장. 추론된 프레임마다 한 번 실행됩니다.
+void StreamProcessor::handle_inference_events(const Frame& frame, const InferenceResult& result) {
+    const std::string& active_mode = result.mode;
+    const auto& results = result.detections;
+    const auto& class_names = result.class_names;
 
+    if (active_mode == "detect") {
         int person_count = 0, helmet_count = 0, vest_count = 0;
-        const auto& class_names = detector_->get_class_names();
         for (const auto& res : results) {
             if (res.class_id < class_names.size()) {
                 const std::string& class_name = class_names[res.class_id];
@@ -265,82 +325,51 @@ void StreamProcessor::process_frame_and_stream(cv::Mat& original_frame) {
         }
 
         bool is_unsafe = (helmet_count < person_count || vest_count < person_count);
+        // 추적 중이면 같은 사람에게 반복해서 알리지 않고, 아직 알리지 않은 사람(트랙)이 있을 때만 알림
+        const bool tracking = pipeline_config_.tracker.enabled;
+        const bool alert = is_unsafe && (!tracking || claim_new_tracks(result, "person", alerted_tracks_));
 
             // 음성 안내
-        if (is_unsafe) {
-            if (led_fade_controller_) {
-                led_fade_controller_->triggerFade();
+        if (alert) {
+            if (alerts_.led) {
+                alerts_.led->triggerFade();
             }
-            if (!audio_notifier_.isPlaying()) {
+            if (alerts_.audio && !alerts_.audio->isPlaying()) {
                 bool only_helmet_missing = (helmet_count < person_count) && (vest_count >= person_count);
                 bool only_vest_missing = (vest_count < person_count) && (helmet_count >= person_count);
 
                 if (only_helmet_missing) {
                     std::cout << "[INFO] Playing sound: helmet_ment.wav" << std::endl;
-                    audio_notifier_.play("sounds/helmet_ment.wav");
+                    alerts_.audio->play("sounds/helmet_ment.wav");
                 } else if (only_vest_missing) {
                     std::cout << "[INFO] Playing sound: vest_ment.wav" << std::endl;
-                    audio_notifier_.play("sounds/vest_ment.wav");
+                    alerts_.audio->play("sounds/vest_ment.wav");
                 } else {
                     std::cout << "[INFO] Playing sound: safety_ment.wav" << std::endl;
-                    audio_notifier_.play("sounds/safety_ment.wav");
+                    alerts_.audio->play("sounds/safety_ment.wav");
                 }
             }
         }
 
         // STM32 신호 전송
-        if (is_unsafe && serial_comm_ && serial_comm_->isOpen()) {
-            uint8_t seq = serial_comm_->getNextSeq();
+        if (alert && alerts_.serial && alerts_.serial->isOpen()) {
+            uint8_t seq = alerts_.serial->getNextSeq();
             auto frame_to_send = STM32Protocol::buildToggleFrame(seq);
             // 응답을 기다리지 않는 sendOnly로 변경하는 것을 고려해볼 수 있습니다.
-            serial_comm_->sendAndReceive(frame_to_send, "Sent TOGGLE (seq=" + std::to_string(seq) + ")");
-        }
-
-        // 탐지 결과 그리기
-        for (const auto& res : results) {
-            if (res.class_id < class_names.size()) {
-                std::string class_name = class_names[res.class_id];
-                cv::Scalar color = color_map_.count(class_name) ? color_map_[class_name] : cv::Scalar(0, 0, 255);
-                    
-                // 사각형 그리기
-                cv::rectangle(processed_frame, res.box, color, 2);
-
-                // 텍스트 그리기 로직 
-                std::stringstream label_ss;
-                label_ss << class_name << " " << std::fixed << std::setprecision(2) << res.confidence;
-                std::string label = label_ss.str();
-                    
-                int baseLine;
-                cv::Size label_size = cv::getTextSize(label, cv::FONT_HERSHEY_SIMPLEX, 0.5, 1, &baseLine);
-
-                int text_y = res.box.y - 10;
-                if (text_y < label_size.height) {
-                    text_y = res.box.y + label_size.height + 10;
-                }
-
-                cv::rectangle(processed_frame, 
-                            cv::Point(res.box.x, text_y - label_size.height - 5),
-                            cv::Point(res.box.x + label_size.width, text_y + baseLine - 5),
-                            color, -1);
-                cv::putText(processed_frame, label, cv::Point(res.box.x, text_y - 5), 
-                            cv::FONT_HERSHEY_SIMPLEX, 0.5, cv::Scalar(255, 255, 255), 1);
-            }
+            alerts_.serial->sendAndReceive(frame_to_send, "Sent TOGGLE (seq=" + std::to_string(seq) + ")");
         }
 
-
-            // DB 저장
-        if (time(0) - last_save_time_ >= 3) {
-            auto saved_data = db_manager_.saveDetectionLog(camera_id_, results, processed_frame, *detector_);
+            // DB 저장 (오버레이가 그려진 스냅샷을 저장, 추적 중이면 새 사람이 나타났을 때만)
+        if (time(0) - last_save_time_ >= 3 && (!tracking || claim_new_tracks(result, "person", saved_tracks_))) {
+            cv::Mat snapshot = make_snapshot(frame, result);
+            auto saved_data = db_manager_.saveDetectionLog(camera_id_, results, snapshot, class_names);
             if (detection_callback_ && saved_data.has_value()) {
                 detection_callback_(saved_data.value());
             }
             last_save_time_ = time(0);
         }
-    } else if (active_mode == "trespass" && detector_) {
-        auto results = detector_->detect(processed_frame, 0.4, 0.45);
-            
+    } else if (active_mode == "trespass") {
         int person_count = 0;
-        const auto& class_names = detector_->get_class_names();
         for (const auto& res : results) {
             if (res.class_id < class_names.size() && class_names[res.class_id] == "person") {
                 person_count++;
@@ -348,65 +377,36 @@ void StreamProcessor::process_frame_and_stream(cv::Mat& original_frame) {
         }
             
         bool trespass_detected = (person_count > 0);
+        const bool tracking = pipeline_config_.tracker.enabled;
+        const bool alert = trespass_detected && (!tracking || claim_new_tracks(result, "person", alerted_tracks_));
 
-        if(trespass_detected) {
-            if (led_fade_controller_) {
-                led_fade_controller_->triggerFade();
+        if(alert) {
+            if (alerts_.led) {
+                alerts_.led->triggerFade();
             }
 
-            if(serial_comm_ && serial_comm_->isOpen()) {
-                uint8_t seq = serial_comm_->getNextSeq();
+            if(alerts_.serial && alerts_.serial->isOpen()) {
+                uint8_t seq = alerts_.serial->getNextSeq();
                 auto frame_to_send = STM32Protocol::buildToggleFrame(seq);
                 // 응답을 기다리지 않는 sendOnly로 변경하는 것을 고려해볼 수 있습니다.
-                serial_comm_->sendAndReceive(frame_to_send, "Sent TOGGLE (seq=" + std::to_string(seq) + ")");
-            }
-        }
-            
-        // 결과 그리기 (person만 빨간색으로)
-        for (const auto& res : results) {
-            if (res.class_id < class_names.size() && class_names[res.class_id] == "person") {
-                cv::rectangle(processed_frame, res.box, cv::Scalar(0, 0, 255), 2);
-                // 1. 표시할 라벨 생성 ("person" + 신뢰도 점수)
-                std::string label = "person " + cv::format("%.2f", res.confidence);
-                cv::Scalar color = cv::Scalar(0, 0, 255); // 빨간색
-
-                // 2. 텍스트 배경을 위한 설정
-                int baseLine;
-                cv::Size label_size = cv::getTextSize(label, cv::FONT_HERSHEY_SIMPLEX, 0.5, 1, &baseLine);
-                int text_y = res.box.y - 10;
-                if (text_y < label_size.height) {
-                    text_y = res.box.y + res.box.height + label_size.height + 5;
-                }
-
-                // 3. 텍스트 배경 사각형 그리기
-                cv::rectangle(processed_frame,
-                            cv::Point(res.box.x, text_y - label_size.height - 5),
-                            cv::Point(res.box.x + label_size.width, text_y + baseLine - 5),
-                            color, -1);
-
-                // 4. 실제 텍스트 그리기
-                cv::putText(processed_frame, label, cv::Point(res.box.x, text_y - 5),
-                            cv::FONT_HERSHEY_SIMPLEX, 0.5, cv::Scalar(255, 255, 255), 1);
+                alerts_.serial->sendAndReceive(frame_to_send, "Sent TOGGLE (seq=" + std::to_string(seq) + ")");
             }
         }
 
             // DB 저장 및 웹소켓 알림
         if (time(0) - last_save_time_ >= 3) {
-            if (trespass_detected) {
-                auto saved_data = db_manager_.saveTrespassLog(camera_id_, person_count, processed_frame);
+            if (trespass_detected && (!tracking || claim_new_tracks(result, "person", saved_tracks_))) {
+                cv::Mat snapshot = make_snapshot(frame, result);
+                auto saved_data = db_manager_.saveTrespassLog(camera_id_, person_count, snapshot);
                 if (trespass_callback_ && saved_data.has_value()) {
                     trespass_callback_(saved_data.value());
                 }
             }
             last_save_time_ = time(0);
         }
-    } else if (active_mode == "fall" && fall_) {
-        // 1. 넘어짐 탐지 실행
-        auto results = fall_->detect(processed_frame, 0.4, 0.45);
-    
-        // 2. 넘어짐 상황 판단
+    } else if (active_mode == "fall") {
+        // 넘어짐 상황 판단
         bool fall_detected = false;
-        const auto& class_names = fall_->get_class_names();
         for (const auto& res : results) {
             if (res.class_id < class_names.size()) {
                 if (class_names[res.class_id] == "fall") {
@@ -416,57 +416,38 @@ void StreamProcessor::process_frame_and_stream(cv::Mat& original_frame) {
             }
         }
     
-        // 3. 넘어짐 발생 시 음성 안내 및 STM32 신호 전송
-        if (fall_detected) {
-            if (led_fade_controller_) {
-                led_fade_controller_->triggerFade();
+        // 넘어짐 발생 시 음성 안내 및 STM32 신호 전송 (추적 중이면 넘어진 트랙마다 한 번)
+        const bool tracking = pipeline_config_.tracker.enabled;
+        const bool alert = fall_detected && (!tracking || claim_new_tracks(result, "fall", alerted_tracks_));
+        if (alert) {
+            if (alerts_.led) {
+                alerts_.led->triggerFade();
             }
 
-            if (!audio_notifier_.isPlaying()) {
-                audio_notifier_.play("sounds/fall_ment.wav");
+            if (alerts_.audio && !alerts_.audio->isPlaying()) {
+                alerts_.audio->play("sounds/fall_ment.wav");
                 std::cout << "[INFO] Playing sound: fall_ment.wav" << std::endl;
             }
-            if (serial_comm_ && serial_comm_->isOpen()) {
-                uint8_t seq = serial_comm_->getNextSeq();
+            if (alerts_.serial && alerts_.serial->isOpen()) {
+                uint8_t seq = alerts_.serial->getNextSeq();
                 auto frame_to_send = STM32Protocol::buildToggleFrame(seq);
-                serial_comm_->sendAndReceive(frame_to_send, "Sent FALL ALERT");
-            }
-        }
-            
-        // 4. 탐지 결과를 display_frame에 그리기
-        for (const auto& res : results) {
-            if (res.class_id < class_names.size()) {
-                std::string class_name = class_names[res.class_id];
-                cv::Scalar color = color_map_.count(class_name) ? color_map_[class_name] : cv::Scalar(255, 255, 255);
-                    
-                cv::rectangle(processed_frame, res.box, color, 2);
-                std::string label = class_name + " " + cv::format("%.2f", res.confidence);
-                
-                int baseLine;
-                cv::Size label_size = cv::getTextSize(label, cv::FONT_HERSHEY_SIMPLEX, 0.5, 1, &baseLine);
-                int text_y = res.box.y - 10;
-                if (text_y < label_size.height) {
-                    text_y = res.box.y + label_size.height + 10;
-                }
-                cv::rectangle(processed_frame, cv::Point(res.box.x, text_y - label_size.height - 5), cv::Point(res.box.x + label_size.width, text_y + baseLine), color, -1);
-                cv::putText(processed_frame, label, cv::Point(res.box.x, text_y - 5), cv::FONT_HERSHEY_SIMPLEX, 0.5, cv::Scalar(255, 255, 255), 1);
+                alerts_.serial->sendAndReceive(frame_to_send, "Sent FALL ALERT");
             }
         }
 
-        // 5. DB 저장 (필요 시 구현, 여기서는 예시로 넘어짐 카운트만 저장)
+        // DB 저장 (필요 시 구현, 여기서는 예시로 넘어짐 카운트만 저장)
         if (time(0) - last_save_time_ >= 3) {
-            if(fall_detected) {
-                auto saved_data = db_manager_.saveFallLog(camera_id_, fall_detected, processed_frame);
+            if (fall_detected && (!tracking || claim_new_tracks(result, "fall", saved_tracks_))) {
+                cv::Mat snapshot = make_snapshot(frame, result);
+                auto saved_data = db_manager_.saveFallLog(camera_id_, fall_detected, snapshot);
                 if (fall_callback_ && saved_data.has_value()) {
                     fall_callback_(saved_data.value());
                 }
             }
             last_save_time_ = time (0);
         }
-
-    } else if (active_mode == "blur" && segmenter_) {
-        SegmentationResult seg_result = segmenter_->process_frame(processed_frame);
-        int blur_count = seg_result.person_count;
+    } else if (active_mode == "blur") {
+        int blur_count = result.segmentation.person_count;
 
         if (time(0) - last_save_time_ >= 3) {
             if(blur_count > 0) {
@@ -477,67 +458,106 @@ void StreamProcessor::process_frame_and_stream(cv::Mat& original_frame) {
             }
             last_save_time_ = time(0);
         }
-    } else if (active_mode == "stop") {
-        cv::putText(processed_frame, "STOPPED", cv::Point(10, 60), cv::FONT_HERSHEY_SIMPLEX, 0.7, cv::Scalar(0, 0, 255), 2);
     }
-    // "raw" 모드일 경우, 위 if-else 문을 모두 건너뛰고 필터만 적용된 processed_frame이 남게 됩니다.
+}
 
-    // 5. 최종 프레임에 공통 상태 정보를 그리고 스트리밍합니다.
-    if (!processed_frame.empty()) {
-        //cv::putText(processed_frame, "MODE: " + active_mode, cv::Point(10, 30), cv::FONT_HERSHEY_SIMPLEX, 0.7, cv::Scalar(255, 0, 0), 2);
+// class_name 트랙 가운데 reported에 없는 것이 있으면 모두 기록하고 true를 돌려줍니다.
+// 확정되지 않은 검출(track_id -1)은 다음 추론에서 ID를 받을 때까지 미룹니다.
+bool StreamProcessor::claim_new_tracks(const InferenceResult& result, const std::string& class_name, std::set<int>& reported) {
+    bool claimed = false;
+    for (const auto& res : result.detections) {
+        if (res.track_id < 0 || res.class_id >= result.class_names.size()) continue;
+        if (result.class_names[res.class_id] != class_name) continue;
+        if (reported.insert(res.track_id).second) claimed = true;
+    }
+    // 사라진 트랙은 잊어서 집합이 계속 커지지 않게 함
+    for (auto it = reported.begin(); it != reported.end();) {
+        it = tracker_.isAlive(*it) ? std::next(it) : reported.erase(it);
+    }
+    return claimed;
+}
 
-        if (proc_processed_) {
-            fwrite(processed_frame.data, 1, processed_frame.total() * processed_frame.elemSize(), proc_processed_);
-        }
+// DB에 저장할 스냅샷: 항상 BGR로 만든 뒤 오버레이를 그립니다.
+cv::Mat StreamProcessor::make_snapshot(const Frame& frame, const InferenceResult& result) {
+    cv::Mat snapshot;
+    if (frame.format == PixelFormat::Bgr) {
+        snapshot = frame.image.clone();
+    } else {
+        yuv420_to_bgr(frame.image, frame.format, snapshot);
+    }
+    draw_overlays(snapshot, PixelFormat::Bgr, result, snapshot_blur_);
+    return snapshot;
+}
+
+// 모드별 오버레이를 그립니다. 구역은 API 스레드가 바꿀 수 있으므로 trespass 모드에서만 잠그고 넘김
+void StreamProcessor::draw_overlays(cv::Mat& frame, PixelFormat format, const InferenceResult& result, PrivacyBlur& blur) {
+    if (result.mode == "trespass") {
+        std::lock_guard<std::mutex> lock(zones_mutex_);
+        ::draw_overlays(frame, format, result, color_map_, zones_, blur);
+    } else {
+        ::draw_overlays(frame, format, result, color_map_, {}, blur);
     }
 }
 
+void StreamProcessor::render_and_stream(Frame& frame) {
+    const std::string active_mode = getActiveMode();
 
-// (handle_mode_change 및 나머지 헬퍼 함수들은 이전과 동일)
-void StreamProcessor::handle_mode_change() {
-    std::string active_mode;
+    // 추론 단계의 최신 결과를 현재 프레임에 다시 그립니다.
+    std::shared_ptr<const InferenceResult> result;
     {
-        std::lock_guard<std::mutex> lock(g_mode_mutex);
-        active_mode = g_current_mode;
+        std::lock_guard<std::mutex> lock(result_mutex_);
+        result = latest_result_;
     }
-
-    if (active_mode != last_loaded_mode_) {
-        detector_.reset();
-        segmenter_.reset();
-        std::cout << "모드 변경 시도: " << active_mode << std::endl;
-        
-        // ✅ "raw" 또는 "stop" 모드는 모델 로딩이 필요 없음
-        if (active_mode == "raw" || active_mode == "stop") {
-            last_loaded_mode_ = active_mode;
-            std::cout << active_mode << " 모드로 전환 (모델 로드 없음)" << std::endl;
-            return; // 모델 로드 없이 함수 종료
+    if (result && result->mode == active_mode) {
+        if (pipeline_config_.propagate_boxes && result->frame_seq != frame.seq) {
+            // 추론하지 않은 프레임: 마지막 결과의 박스를 움직임만큼 옮겨 그림
+            draw_overlays(frame.image, frame.format, box_propagator_.propagate(result, frame), privacy_blur_);
+            ++propagated_frames_;
+        } else {
+            draw_overlays(frame.image, frame.format, *result, privacy_blur_);
         }
+    }
 
-        try {
-            if (active_mode == "detect" || active_mode == "trespass") {
-                if (!detector_ || last_loaded_mode_ != "detect" && last_loaded_mode_ != "trespass") {
-                    detector_ = std::make_unique<Detector>(detection_model_path_);
-                }
-            } else if (active_mode == "blur") {
-                segmenter_ = std::make_unique<Segmenter>(segmentation_model_path_);
-            } else if (active_mode == "fall") {
-                fall_ = std::make_unique<Fall>(fall_model_path_);
-            }
-            last_loaded_mode_ = active_mode;
-            last_save_time_ = time(0); 
-            std::cout << "다음 모드를 위한 모델 로드 완료: " << active_mode << std::endl;
-        } catch (const Ort::Exception& e) {
-            std::cerr << "모델 로딩 중 오류 발생: " << e.what() << std::endl;
-            g_keep_running = false;
-        }
+    if (active_mode == "stop") {
+        draw_text(frame.image, frame.format, "STOPPED", cv::Point(10, 60), 0.7, cv::Scalar(0, 0, 255), 2);
+    }
+    // "raw" 모드일 경우 필터만 적용된 프레임이 그대로 송출됩니다.
+
+    if (!frame.image.empty() && proc_processed_) {
+        fwrite(frame.image.data, 1, frame.image.total() * frame.image.elemSize(), proc_processed_);
+        ++streamed_frames_;
+        output_latency_.record(frame.captured_at);
+    }
+}
+
+
+// 엔진이 새 모드로 바꿨으면 (모델 준비 완료) 이전 모드의 결과와 추적 상태를 버립니다.
+void StreamProcessor::handle_mode_change(const std::string& active_mode) {
+    if (active_mode == last_mode_) return;
+
+    {
+        // 이전 모드의 결과가 새 모드 프레임에 그려지지 않도록 비웁니다.
+        std::lock_guard<std::mutex> lock(result_mutex_);
+        latest_result_.reset();
+    }
+    {
+        std::lock_guard<std::mutex> lock(mode_mutex_);
+        active_mode_ = active_mode;
     }
+    tracker_.reset();
+    motion_gate_.reset();
+    alerted_tracks_.clear();
+    saved_tracks_.clear();
+    last_mode_ = active_mode;
+    last_save_time_ = time(0);
 }
+
 bool StreamProcessor::initialize_camera() {
-    cap_.open(gstreamer_pipeline(), cv::CAP_GSTREAMER);
-    if (!cap_.isOpened()) {
-        std::cerr << "오류: 카메라를 열 수 없습니다." << std::endl;
+    if (!frame_source_ || !frame_source_->open()) {
+        std::cerr << "[CAM " << camera_id_ << "] 오류: 카메라를 열 수 없습니다." << std::endl;
         return false;
     }
+    std::cout << "[CAM " << camera_id_ << "] 프레임 소스: " << frame_source_->name() << std::endl;
     return true;
 }
 
@@ -552,30 +572,17 @@ bool StreamProcessor::initialize_streamers() {
 
 
 FILE* StreamProcessor::create_ffmpeg_process(const std::string& rtsp_url) {
-    std::string cmd = "ffmpeg -f rawvideo -pixel_format bgr24 -video_size " +
+    // YUV 캡처는 변환 없이 그대로 넘김 (yuv420p는 출력 -pix_fmt와 같아 FFmpeg 쪽 변환도 생략됨)
+    std::string pixel_format = "bgr24";
+    if (capture_format_ == PixelFormat::I420) pixel_format = "yuv420p";
+    else if (capture_format_ == PixelFormat::Nv12) pixel_format = "nv12";
+
+    std::string cmd = "ffmpeg -f rawvideo -pixel_format " + pixel_format + " -video_size " +
                       std::to_string(capture_width_) + "x" + std::to_string(capture_height_) +
                       " -framerate " + std::to_string(framerate_) + " -i - "
-                      "-c:v h264_v4l2m2m -b:v 2M -bufsize 2M -maxrate 2M "
+                      "-c:v " + encoder_ + " -b:v 2M -bufsize 2M -maxrate 2M "
                       " -g 30 -keyint_min 30 -sc_threshold 0 "
                       "-pix_fmt yuv420p -f rtsp -rtsp_transport tcp " + rtsp_url;
     std::cout << "FFmpeg 실행 명령어: " << cmd << std::endl;
     return popen(cmd.c_str(), "w");
 }
-
-std::string StreamProcessor::gstreamer_pipeline() {
-    // Python의 picam2 설정과 유사한 최적화된 파이프라인
-    // sync=false, max-buffers=1, drop=true로 설정하여 최대한 딜레이 감소
-    // RGB888 포맷으로 직접 설정 (Python의 format="RGB888"과 동일)
-    return "libcamerasrc ! "
-           "video/x-raw, width=" + std::to_string(capture_width_) +
-           ", height=" + std::to_string(capture_height_) +
-           ", framerate=" + std::to_string(framerate_) + "/1 ! "
-           "videoconvert ! "
-           "video/x-raw, format=BGR ! "
-           "appsink sync=false max-buffers=1 drop=true";
-}
-
-SerialCommunicator& StreamProcessor::getSerialCommunicator() {
-    // unique_ptr이 소유한 객체의 참조를 반환
-    return *serial_comm_;
-}
\ No newline at end of file
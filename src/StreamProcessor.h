@@ -5,115 +5,202 @@
 #include <memory>
 #include <atomic>
 #include <map>
+#include <set>
 #include <cstdio> // FILE*
 #include <functional>
 #include <mutex>
+#include <thread>
 #include "AudioNotifier.h"
-#include "SystemMonitor.h"
+#include "BoxPropagator.h"
+#include "Frame.h"
+#include "FramePool.h"
+#include "FrameQueue.h"
+#include "FrameSource.h"
+#include "ImageConditioner.h"
+#include "MotionGate.h"
+#include "ObjectTracker.h"
+#include "PipelineMetrics.h"
+#include "PrivacyBlur.h"
+#include "ServerConfig.h"
+#include "Zone.h"
 #include "driver/led_pwm/led_controller/led_fade_manager.h"
 
 // 클래스 전방 선언 (순환 참조 방지)
-class Detector;
-class Segmenter;
-class Fall;
 class DatabaseManager;
 class SerialCommunicator;
-class AnomalyDetector;
+class InferenceEngine;
 struct DetectionResult;
 struct DetectionData;
 struct PersonCountData;
 struct FallCountData;
 struct TrespassLogData;
-
+struct InferenceResult;
+
+// 여러 카메라가 함께 쓰는 알림 장치 (StreamManager 소유, 없으면 nullptr)
+struct AlertOutputs {
+    SerialCommunicator* serial = nullptr;
+    DebouncedFadeController* led = nullptr;
+    AudioNotifier* audio = nullptr;
+};
+
+// 파이프라인 모니터링 값 (/api/pipeline/stats)
+struct PipelineStats {
+    int camera_id = 0;
+    std::string mode;        // 요청된 모드
+    std::string active_mode; // 지금 추론/렌더에 쓰는 모드 (모델 로드 중이면 이전 모드)
+    std::string source;
+    CaptureStats capture;
+    QueueStats inference_queue;
+    QueueStats render_queue;
+    uint64_t captured_frames = 0;
+    uint64_t inferred_frames = 0;
+    uint64_t streamed_frames = 0;
+    uint64_t cadence_skipped_frames = 0; // 추론 주기 때문에 추론 단계로 보내지 않은 프레임
+    uint64_t propagated_frames = 0;      // 박스를 움직임만큼 옮겨 그린 프레임
+    uint64_t motion_gated_frames = 0;    // 움직임이 없어 추론을 건너뛴 프레임
+    double motion_changed_ratio = 0.0;   // 마지막으로 측정한 변화 픽셀 비율
+    LatencyStats capture_to_inference; // 캡처 → 추론 완료
+    LatencyStats capture_to_output;    // 캡처 → FFmpeg 전달
+    FramePoolStats frame_pool;
+};
+
+// 카메라 한 대의 캡처 → 추론 → 렌더/인코딩 파이프라인.
+// 모델은 InferenceEngine을 통해 다른 카메라와 공유합니다.
 class StreamProcessor {
 public:
-    // 생성자: DB 매니저에 대한 참조를 받습니다.
-    StreamProcessor(DatabaseManager& dbManager);
+    // 생성자: DB 매니저, 카메라 설정, 프레임 소스, 공유 추론 엔진과 알림 장치를 받습니다.
+    StreamProcessor(DatabaseManager& dbManager, const CameraConfig& camera, const PipelineConfig& pipeline,
+                    std::unique_ptr<FrameSource> frameSource, InferenceEngine& engine, const AlertOutputs& alerts);
     ~StreamProcessor();
 
-    // 이 함수를 호출하면 메인 루프가 시작됩니다.
-    void run();
+    // 카메라와 FFmpeg을 열고 캡처/추론/렌더 스레드를 띄웁니다.
+    bool start();
+    // g_keep_running이 false가 된 뒤 호출: 스레드가 끝날 때까지 기다립니다.
+    void stop();
+
+    int getCameraId() const { return camera_id_; }
+    // 요청된 모드. 새 모델을 올리는 동안에는 getActiveMode()가 이전 모드를 돌려줍니다.
+    std::string getMode() const;
+    std::string getActiveMode() const;
+    void setMode(const std::string& mode);
+    const std::string& getRtspUrl() const { return rtsp_url_; }
 
-    bool isAnomalyDetected() const;
-    SerialCommunicator& getSerialCommunicator();
+    PipelineStats getPipelineStats() const;
 
     // 웹소켓 콜백 함수 등록을 위한 함수
-    void onAnomalyStatusChanged(std::function<void(bool)> callback);
     void onNewDetection(std::function<void(const DetectionData&)> callback);
     void onNewBlur(std::function<void(const PersonCountData&)> callback);
     void onNewFall(std::function<void(const FallCountData&)> callback);
     void onNewTrespass(std::function<void(const TrespassLogData&)> callback);
-    void onSystemInfoUpdate(std::function<void(double, double)> callback);
 
     void setBrightness(int beta);
 
+    // 침입 감지 구역 (비어 있으면 전체 프레임을 감시)
+    std::vector<Zone> getZones() const;
+    void setZones(const std::vector<Zone>& zones);
+
 private:
     // 초기화 헬퍼 함수
     bool initialize_camera();
     bool initialize_streamers();
 
-    void process_frame_and_stream(cv::Mat& frame);
-    void handle_mode_change();
-    void handle_anomaly_detection();  // 이상탐지 처리 함수 추가
-    void handle_system_info_monitoring(); // 시스템 정보 모니터링 처리 함수 추가
+    // 파이프라인 단계 (각각 별도 스레드)
+    void capture_loop();   // 캡처 + 공통 이미지 처리
+    void inference_loop(); // 모드 전환, 추론, 알림/DB 저장
+    void render_loop();    // 오버레이 그리기 + FFmpeg 인코딩
+
+    void condition_frame(const cv::Mat& src, PixelFormat format, cv::Mat& dst);
+    bool should_infer(const Frame& frame); // 추론 주기(every_n_frames, target_fps) 판단
+    void handle_inference_events(const Frame& frame, const InferenceResult& result);
+    bool claim_new_tracks(const InferenceResult& result, const std::string& class_name, std::set<int>& reported);
+    void render_and_stream(Frame& frame);
+
+    void handle_mode_change(const std::string& active_mode);
 
-    // 그리기 및 스트리밍
-    void draw_and_stream_output(cv::Mat& frame, const std::vector<DetectionResult>& results);
+    // 그리기 (BGR 또는 I420/NV12 프레임에 직접)
+    // blur 모드는 호출한 스레드의 렌더러(privacy_blur_ / snapshot_blur_)를 씁니다.
+    void draw_overlays(cv::Mat& frame, PixelFormat format, const InferenceResult& result, PrivacyBlur& blur);
+    cv::Mat make_snapshot(const Frame& frame, const InferenceResult& result);
 
     // 헬퍼 함수
     FILE* create_ffmpeg_process(const std::string& rtsp_url);
-    std::string gstreamer_pipeline();
-    double get_cpu_usage(); // CPU 사용률 계산
-    double get_memory_usage(); // 메모리 사용률 계산
 
     // --- 멤버 변수 ---
     DatabaseManager& db_manager_;
-    std::unique_ptr<SerialCommunicator> serial_comm_;
-    std::unique_ptr<AnomalyDetector> anomaly_detector_;  // 이상탐지 객체 추가
-    std::unique_ptr<SystemMonitor> system_monitor_; // 멤버 변수 추가
+    InferenceEngine& engine_;
+    AlertOutputs alerts_;
 
     // 카메라 및 스트림 설정
-    const int camera_id_ = 1;
+    const int camera_id_;
     int capture_width_ = 640;
     int capture_height_ = 480;
     int framerate_ = 30;
-    cv::VideoCapture cap_;
+    PixelFormat capture_format_ = PixelFormat::Bgr;
+    std::unique_ptr<FrameSource> frame_source_;
     FILE* proc_processed_ = nullptr;
-    std::string rtsp_url_ = "rtsps://127.0.0.1:8555/processed";
+    std::string rtsp_url_;
+    std::string encoder_;
+
+    // 카메라별 동작 모드 (예: "detect", "blur")
+    std::string mode_;
+    std::string active_mode_; // 엔진이 모델을 준비해 실제로 쓰는 모드 (추론 스레드가 갱신)
+    mutable std::mutex mode_mutex_;
+    std::string last_mode_ = "none"; // 추론 스레드가 마지막으로 처리한 모드
+
+    // 침입 감지 구역. 추론은 구역 크롭에서만 돌고, 발 위치가 구역 안인 사람만 남김
+    std::vector<Zone> zones_;
+    mutable std::mutex zones_mutex_;
+    std::vector<Zone> zones_scratch_;     // 추론 스레드 전용 사본
+    std::vector<cv::Rect> rois_scratch_;
+
+    // 파이프라인 단계와 큐
+    PipelineConfig pipeline_config_;
+    std::unique_ptr<FrameQueue<Frame>> inference_queue_;
+    std::unique_ptr<FrameQueue<Frame>> render_queue_;
+    FramePool frame_pool_; // 캡처/추론용 프레임 버퍼 (캡처 스레드만 acquire)
+    std::thread capture_thread_;
+    std::thread inference_thread_;
+    std::thread render_thread_;
+    std::atomic<uint64_t> captured_frames_{0};
+    std::atomic<uint64_t> inferred_frames_{0};
+    std::atomic<uint64_t> streamed_frames_{0};
+    std::atomic<uint64_t> cadence_skipped_frames_{0};
+    std::atomic<uint64_t> propagated_frames_{0};
+    std::atomic<uint64_t> motion_gated_frames_{0};
+    std::atomic<double> motion_changed_ratio_{0.0};
+    LatencyTracker inference_latency_;
+    LatencyTracker output_latency_;
+
+    // 추론 단계가 만든 최신 결과 (렌더 단계가 매 프레임 재사용)
+    std::shared_ptr<const InferenceResult> latest_result_;
+    std::mutex result_mutex_;
+
+    // 추론 주기와 박스 전파
+    std::chrono::steady_clock::time_point next_inference_at_; // target_fps: 다음 추론 예정 시각 (캡처 스레드)
+    BoxPropagator box_propagator_;                            // 렌더 스레드 전용
+    PrivacyBlur privacy_blur_;                                // blur 모드 렌더러 (렌더 스레드 전용)
+    PrivacyBlur snapshot_blur_;                               // 스냅샷용 (추론 스레드 전용)
 
     // 이미지 처리 설정 변수 
     int brightness_beta_;
-    int gaussian_blur_kernel_size_ = 3;
+    ImageConditioner conditioner_; // 캡처 스레드 전용 (블러 + 밝기/대비/감마 곡선)
     std::mutex image_processing_settings_mutex_;
 
-    // 모델 관리
-    std::unique_ptr<Detector> detector_;
-    std::unique_ptr<Segmenter> segmenter_;
-    std::unique_ptr<Fall> fall_;
-    std::string last_loaded_mode_ = "none";
-    std::string detection_model_path_ = "models/detect_192.tflite";
-    std::string segmentation_model_path_ = "models/yolo11n-seg.onnx";
-    std::string fall_model_path_ = "models/fall_192.tflite";
-
     // 그리기 및 DB 저장 주기
     std::map<std::string, cv::Scalar> color_map_;
     time_t last_save_time_ = 0;
-    
-    // 이상탐지 관련
-    std::atomic<bool> anomaly_detected_{false};
-    time_t last_anomaly_check_ = 0;
-    constexpr static int ANOMALY_CHECK_INTERVAL = 1;  // 1초마다 체크
+
+    // 검출 추적 (추론 스레드 전용). 이미 알림/저장한 트랙은 다시 내보내지 않음
+    ObjectTracker tracker_;
+    std::set<int> alerted_tracks_;
+    std::set<int> saved_tracks_;
+
+    // 움직임 게이트 (추론 스레드 전용)
+    MotionGate motion_gate_;
 
     // 웹소켓 콜백 함수들을 저장할 멤버 변수 
-    std::function<void(bool)> anomaly_callback_;
     std::function<void(const DetectionData&)> detection_callback_;
     std::function<void(const PersonCountData&)> blur_callback_;
     std::function<void(const FallCountData&)> fall_callback_;
     std::function<void(const TrespassLogData&)> trespass_callback_;
-    std::function<void(double, double)> system_info_callback_;
-
-    // PPE detect시 스피커 송출 관련 멤버 변수
-    AudioNotifier audio_notifier_; 
-
-    std::unique_ptr<DebouncedFadeController> led_fade_controller_;
-};
\ No newline at end of file
+};
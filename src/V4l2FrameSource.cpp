@@ -0,0 +1,357 @@
+#include "V4l2FrameSource.h"
+
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <iostream>
+#include <mutex>
+#include <poll.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include <vector>
+#include <linux/dma-buf.h>
+#include <linux/dma-heap.h>
+#include <linux/videodev2.h>
+
+namespace {
+
+int xioctl(int fd, unsigned long request, void* arg) {
+    int r;
+    do {
+        r = ioctl(fd, request, arg);
+    } while (r == -1 && errno == EINTR);
+    return r;
+}
+
+uint32_t to_fourcc(PixelFormat format) {
+    switch (format) {
+        case PixelFormat::I420: return V4L2_PIX_FMT_YUV420;
+        case PixelFormat::Nv12: return V4L2_PIX_FMT_NV12;
+        case PixelFormat::Bgr:  return V4L2_PIX_FMT_BGR24;
+    }
+    return V4L2_PIX_FMT_BGR24;
+}
+
+std::string fourcc_name(uint32_t fourcc) {
+    return std::string{static_cast<char>(fourcc & 0xff), static_cast<char>((fourcc >> 8) & 0xff),
+                       static_cast<char>((fourcc >> 16) & 0xff), static_cast<char>((fourcc >> 24) & 0xff)};
+}
+
+void dmabuf_sync(int fd, uint64_t flags) {
+    if (fd < 0) return;
+    dma_buf_sync sync{};
+    sync.flags = flags;
+    xioctl(fd, DMA_BUF_IOCTL_SYNC, &sync);
+}
+
+} // namespace
+
+struct V4l2FrameSource::Device {
+    struct Buffer {
+        void* start = MAP_FAILED;
+        size_t length = 0;
+        int dmabuf_fd = -1; // DMABUF 모드에서만 사용
+    };
+
+    int fd = -1;
+    uint32_t memory = V4L2_MEMORY_MMAP;
+    std::vector<Buffer> buffers;
+    std::mutex mutex;
+    bool streaming = false;
+
+    ~Device() {
+        for (auto& buffer : buffers) {
+            if (buffer.start != MAP_FAILED) munmap(buffer.start, buffer.length);
+            if (buffer.dmabuf_fd >= 0) ::close(buffer.dmabuf_fd);
+        }
+        if (fd >= 0) ::close(fd);
+    }
+
+    bool queue(uint32_t index) {
+        v4l2_buffer buf{};
+        buf.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+        buf.memory = memory;
+        buf.index = index;
+        if (memory == V4L2_MEMORY_DMABUF) {
+            buf.m.fd = buffers[index].dmabuf_fd;
+            buf.length = static_cast<uint32_t>(buffers[index].length);
+        }
+        return xioctl(fd, VIDIOC_QBUF, &buf) == 0;
+    }
+
+    // 프레임 뷰의 마지막 참조가 사라질 때 호출됨 (어느 스레드에서든)
+    void release(uint32_t index) {
+        dmabuf_sync(buffers[index].dmabuf_fd, DMA_BUF_SYNC_END | DMA_BUF_SYNC_READ);
+        std::lock_guard<std::mutex> lock(mutex);
+        if (streaming && !queue(index)) {
+            std::cerr << "[WARN] V4L2 버퍼 재등록 실패 (index=" << index << "): " << std::strerror(errno) << std::endl;
+        }
+    }
+};
+
+V4l2FrameSource::V4l2FrameSource(const CaptureConfig& config) : config_(config) {}
+
+V4l2FrameSource::~V4l2FrameSource() {
+    close();
+}
+
+bool V4l2FrameSource::open() {
+    device_ = std::make_shared<Device>();
+    device_->fd = ::open(config_.device.c_str(), O_RDWR | O_NONBLOCK | O_CLOEXEC);
+    if (device_->fd < 0) {
+        std::cerr << "오류: V4L2 장치를 열 수 없습니다: " << config_.device << " (" << std::strerror(errno) << ")" << std::endl;
+        device_.reset();
+        return false;
+    }
+
+    v4l2_capability cap{};
+    if (xioctl(device_->fd, VIDIOC_QUERYCAP, &cap) != 0 ||
+        !(cap.capabilities & V4L2_CAP_VIDEO_CAPTURE) || !(cap.capabilities & V4L2_CAP_STREAMING)) {
+        std::cerr << "오류: 스트리밍 캡처를 지원하지 않는 장치입니다: " << config_.device << std::endl;
+        device_.reset();
+        return false;
+    }
+
+    const bool use_dmabuf = (config_.io_mode == "dmabuf");
+    if (!configure_format() || !(use_dmabuf ? setup_dmabuf_buffers() : setup_mmap_buffers())) {
+        device_.reset();
+        return false;
+    }
+
+    for (uint32_t i = 0; i < device_->buffers.size(); ++i) {
+        if (!device_->queue(i)) {
+            std::cerr << "오류: VIDIOC_QBUF 실패: " << std::strerror(errno) << std::endl;
+            device_.reset();
+            return false;
+        }
+    }
+    v4l2_buf_type type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+    if (xioctl(device_->fd, VIDIOC_STREAMON, &type) != 0) {
+        std::cerr << "오류: VIDIOC_STREAMON 실패: " << std::strerror(errno) << std::endl;
+        device_.reset();
+        return false;
+    }
+    device_->streaming = true;
+
+    std::cout << "[INFO] V4L2 캡처 시작: " << reinterpret_cast<const char*>(cap.card) << " (" << config_.device
+              << ", " << config_.width << "x" << config_.height << ", " << (use_dmabuf ? "dmabuf" : "mmap")
+              << " x" << device_->buffers.size() << (contiguous_ ? "" : ", 패딩 있음: 복사 모드") << ")" << std::endl;
+    return true;
+}
+
+bool V4l2FrameSource::configure_format() {
+    const uint32_t fourcc = to_fourcc(config_.format);
+
+    v4l2_format fmt{};
+    fmt.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+    fmt.fmt.pix.width = static_cast<uint32_t>(config_.width);
+    fmt.fmt.pix.height = static_cast<uint32_t>(config_.height);
+    fmt.fmt.pix.pixelformat = fourcc;
+    fmt.fmt.pix.field = V4L2_FIELD_NONE;
+    if (xioctl(device_->fd, VIDIOC_S_FMT, &fmt) != 0) {
+        std::cerr << "오류: VIDIOC_S_FMT 실패: " << std::strerror(errno) << std::endl;
+        return false;
+    }
+    // 드라이버는 지원하지 않는 값을 조용히 바꾸므로 결과를 확인
+    if (fmt.fmt.pix.pixelformat != fourcc ||
+        fmt.fmt.pix.width != static_cast<uint32_t>(config_.width) ||
+        fmt.fmt.pix.height != static_cast<uint32_t>(config_.height)) {
+        std::cerr << "오류: 장치가 요청한 형식을 지원하지 않습니다. 요청 " << fourcc_name(fourcc) << " "
+                  << config_.width << "x" << config_.height << ", 실제 " << fourcc_name(fmt.fmt.pix.pixelformat)
+                  << " " << fmt.fmt.pix.width << "x" << fmt.fmt.pix.height << std::endl;
+        return false;
+    }
+
+    bytes_per_line_ = fmt.fmt.pix.bytesperline;
+    const uint32_t packed = static_cast<uint32_t>(config_.width) * (config_.format == PixelFormat::Bgr ? 3 : 1);
+    // BGR은 stride가 있어도 Mat step으로 표현 가능. YUV 420은 평면이 이어져 있어야 뷰로 넘길 수 있음
+    contiguous_ = (config_.format == PixelFormat::Bgr) || (bytes_per_line_ == packed);
+
+    if (config_.framerate > 0) {
+        v4l2_streamparm parm{};
+        parm.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+        parm.parm.capture.timeperframe.numerator = 1;
+        parm.parm.capture.timeperframe.denominator = static_cast<uint32_t>(config_.framerate);
+        xioctl(device_->fd, VIDIOC_S_PARM, &parm); // 지원하지 않는 드라이버도 있으므로 실패는 무시
+    }
+    return true;
+}
+
+bool V4l2FrameSource::setup_mmap_buffers() {
+    v4l2_requestbuffers req{};
+    req.count = static_cast<uint32_t>(config_.buffer_count);
+    req.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+    req.memory = V4L2_MEMORY_MMAP;
+    if (xioctl(device_->fd, VIDIOC_REQBUFS, &req) != 0 || req.count < 2) {
+        std::cerr << "오류: V4L2 mmap 버퍼를 할당할 수 없습니다: " << std::strerror(errno) << std::endl;
+        return false;
+    }
+
+    device_->memory = V4L2_MEMORY_MMAP;
+    device_->buffers.resize(req.count);
+    for (uint32_t i = 0; i < req.count; ++i) {
+        v4l2_buffer buf{};
+        buf.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+        buf.memory = V4L2_MEMORY_MMAP;
+        buf.index = i;
+        if (xioctl(device_->fd, VIDIOC_QUERYBUF, &buf) != 0) {
+            std::cerr << "오류: VIDIOC_QUERYBUF 실패: " << std::strerror(errno) << std::endl;
+            return false;
+        }
+        // 다운스트림은 뷰를 읽기만 하므로 읽기 전용으로 매핑해 실수로 쓰는 것을 막음
+        auto& buffer = device_->buffers[i];
+        buffer.length = buf.length;
+        buffer.start = mmap(nullptr, buf.length, PROT_READ, MAP_SHARED, device_->fd, buf.m.offset);
+        if (buffer.start == MAP_FAILED) {
+            std::cerr << "오류: V4L2 버퍼 mmap 실패: " << std::strerror(errno) << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+bool V4l2FrameSource::setup_dmabuf_buffers() {
+    v4l2_format fmt{};
+    fmt.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+    if (xioctl(device_->fd, VIDIOC_G_FMT, &fmt) != 0) return false;
+    const size_t size = fmt.fmt.pix.sizeimage;
+
+    int heap_fd = ::open("/dev/dma_heap/system", O_RDWR | O_CLOEXEC);
+    if (heap_fd < 0) {
+        std::cerr << "오류: /dev/dma_heap/system을 열 수 없습니다: " << std::strerror(errno) << std::endl;
+        return false;
+    }
+
+    v4l2_requestbuffers req{};
+    req.count = static_cast<uint32_t>(config_.buffer_count);
+    req.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+    req.memory = V4L2_MEMORY_DMABUF;
+    if (xioctl(device_->fd, VIDIOC_REQBUFS, &req) != 0 || req.count < 2) {
+        std::cerr << "오류: 장치가 DMABUF 가져오기를 지원하지 않습니다: " << std::strerror(errno) << std::endl;
+        ::close(heap_fd);
+        return false;
+    }
+
+    device_->memory = V4L2_MEMORY_DMABUF;
+    device_->buffers.resize(req.count);
+    bool ok = true;
+    for (uint32_t i = 0; i < req.count && ok; ++i) {
+        dma_heap_allocation_data alloc{};
+        alloc.len = size;
+        alloc.fd_flags = O_RDWR | O_CLOEXEC;
+        if (xioctl(heap_fd, DMA_HEAP_IOCTL_ALLOC, &alloc) != 0) {
+            std::cerr << "오류: dma-heap 할당 실패: " << std::strerror(errno) << std::endl;
+            ok = false;
+            break;
+        }
+        auto& buffer = device_->buffers[i];
+        buffer.dmabuf_fd = static_cast<int>(alloc.fd);
+        buffer.length = size;
+        buffer.start = mmap(nullptr, size, PROT_READ, MAP_SHARED, buffer.dmabuf_fd, 0);
+        if (buffer.start == MAP_FAILED) {
+            std::cerr << "오류: DMABUF mmap 실패: " << std::strerror(errno) << std::endl;
+            ok = false;
+        }
+    }
+    ::close(heap_fd);
+    return ok;
+}
+
+bool V4l2FrameSource::read(Frame& frame) {
+    if (!device_) return false;
+
+    // 프레임이 준비될 때까지 poll로 대기 (종료 플래그 확인을 위해 100ms 제한)
+    pollfd pfd{device_->fd, POLLIN, 0};
+    if (poll(&pfd, 1, 100) <= 0) return false;
+
+    v4l2_buffer buf{};
+    buf.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+    buf.memory = device_->memory;
+    if (xioctl(device_->fd, VIDIOC_DQBUF, &buf) != 0) {
+        if (errno != EAGAIN) std::cerr << "[WARN] VIDIOC_DQBUF 실패: " << std::strerror(errno) << std::endl;
+        return false;
+    }
+
+    const uint32_t index = buf.index;
+    if (buf.flags & V4L2_BUF_FLAG_ERROR) {
+        std::lock_guard<std::mutex> lock(device_->mutex);
+        device_->queue(index);
+        return false;
+    }
+    dmabuf_sync(device_->buffers[index].dmabuf_fd, DMA_BUF_SYNC_START | DMA_BUF_SYNC_READ);
+
+    // 드라이버 sequence가 건너뛰면 그만큼 프레임이 버려진 것
+    const int64_t sequence = buf.sequence;
+    if (last_sequence_ >= 0 && sequence > last_sequence_ + 1) dropped_ += sequence - last_sequence_ - 1;
+    last_sequence_ = sequence;
+
+    // 버퍼 참조: 마지막 Frame이 사라지면 드라이버에 다시 넣음
+    std::shared_ptr<Device> device = device_;
+    void* data = device_->buffers[index].start;
+    std::shared_ptr<void> buffer_ref(data, [device, index](void*) { device->release(index); });
+
+    const int width = config_.width;
+    const int height = config_.height;
+    if (config_.format == PixelFormat::Bgr) {
+        frame.image = cv::Mat(height, width, CV_8UC3, data, bytes_per_line_);
+        frame.buffer_ref = std::move(buffer_ref);
+    } else if (contiguous_) {
+        frame.image = cv::Mat(height * 3 / 2, width, CV_8UC1, data);
+        frame.buffer_ref = std::move(buffer_ref);
+    } else {
+        // 패딩이 있는 YUV 평면은 연속 버퍼로 복사 후 즉시 반환
+        frame.image.create(height * 3 / 2, width, CV_8UC1);
+        const uchar* src = static_cast<const uchar*>(data);
+        const uint32_t chroma_stride = bytes_per_line_ / 2;
+        for (int y = 0; y < height; ++y) {
+            std::memcpy(frame.image.ptr(y), src + static_cast<size_t>(y) * bytes_per_line_, width);
+        }
+        const uchar* chroma = src + static_cast<size_t>(bytes_per_line_) * height;
+        uchar* dst = frame.image.ptr(height);
+        if (config_.format == PixelFormat::Nv12) {
+            for (int y = 0; y < height / 2; ++y) {
+                std::memcpy(dst + static_cast<size_t>(y) * width, chroma + static_cast<size_t>(y) * bytes_per_line_, width);
+            }
+        } else {
+            for (int y = 0; y < height; ++y) { // U 평면 뒤에 V 평면 (각각 height/2 행)
+                std::memcpy(dst + static_cast<size_t>(y) * (width / 2), chroma + static_cast<size_t>(y) * chroma_stride, width / 2);
+            }
+        }
+        buffer_ref.reset();
+    }
+    frame.format = config_.format;
+
+    // 드라이버 타임스탬프가 CLOCK_MONOTONIC이면 steady_clock과 같은 기준
+    if ((buf.flags & V4L2_BUF_FLAG_TIMESTAMP_MASK) == V4L2_BUF_FLAG_TIMESTAMP_MONOTONIC) {
+        const int64_t ns = static_cast<int64_t>(buf.timestamp.tv_sec) * 1000000000LL +
+                           static_cast<int64_t>(buf.timestamp.tv_usec) * 1000LL;
+        frame.pts_ns = ns;
+        frame.captured_at = std::chrono::steady_clock::time_point(
+            std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::nanoseconds(ns)));
+    }
+
+    ++delivered_;
+    return true;
+}
+
+void V4l2FrameSource::close() {
+    if (!device_) return;
+    {
+        std::lock_guard<std::mutex> lock(device_->mutex);
+        if (device_->streaming) {
+            v4l2_buf_type type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+            xioctl(device_->fd, VIDIOC_STREAMOFF, &type);
+            device_->streaming = false;
+        }
+    }
+    // 매핑 해제는 아직 반환되지 않은 프레임이 모두 사라진 뒤 Device 소멸자에서 일어남
+    device_.reset();
+}
+
+CaptureStats V4l2FrameSource::stats() const {
+    CaptureStats stats;
+    stats.delivered = delivered_.load();
+    stats.dropped = dropped_.load();
+    return stats;
+}
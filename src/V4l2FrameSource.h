@@ -0,0 +1,37 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include "FrameSource.h"
+
+// V4L2 streaming I/O로 카메라를 직접 읽는 소스 (GStreamer 불필요).
+// 커널 버퍼(mmap 또는 dma-heap에서 할당한 DMABUF)를 복사하지 않고 cv::Mat 뷰로 넘기며,
+// 프레임의 마지막 참조가 사라질 때 버퍼를 드라이버에 다시 넣습니다(QBUF).
+// vivid 가상 드라이버(modprobe vivid)로 카메라 없이도 동작을 확인할 수 있습니다.
+class V4l2FrameSource : public FrameSource {
+public:
+    explicit V4l2FrameSource(const CaptureConfig& config);
+    ~V4l2FrameSource() override;
+
+    bool open() override;
+    bool read(Frame& frame) override;
+    void close() override;
+    std::string name() const override { return "v4l2"; }
+    CaptureStats stats() const override;
+
+    struct Device; // 장치 fd와 버퍼 매핑 (반환 대기 중인 프레임이 함께 소유)
+
+private:
+    bool configure_format();
+    bool setup_mmap_buffers();
+    bool setup_dmabuf_buffers();
+
+    CaptureConfig config_;
+    std::shared_ptr<Device> device_;
+    uint32_t bytes_per_line_ = 0;
+    bool contiguous_ = true; // 평면 사이 패딩이 없어 뷰로 넘길 수 있는지
+
+    int64_t last_sequence_ = -1;
+    std::atomic<uint64_t> delivered_{0};
+    std::atomic<uint64_t> dropped_{0};
+};
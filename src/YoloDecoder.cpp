@@ -0,0 +1,150 @@
+#include "YoloDecoder.h"
+
+#include <opencv2/core/hal/intrin.hpp>
+#include <algorithm>
+#include <cmath>
+
+void YoloInt8Decoder::configure(float scale, int zero_point, int num_classes, int num_det, std::vector<int> target_classes) {
+    scale_ = scale;
+    zero_point_ = zero_point;
+    num_classes_ = std::min(num_classes, 128); // 클래스 id를 int8 레인에 담음
+    num_det_ = num_det;
+
+    targets_.clear();
+    for (int id : target_classes) {
+        if (id >= 0 && id < num_classes_) targets_.push_back(id);
+    }
+    if (targets_.empty()) {
+        for (int id = 0; id < num_classes_; ++id) targets_.push_back(id);
+    }
+    std::sort(targets_.begin(), targets_.end());
+    targets_.erase(std::unique(targets_.begin(), targets_.end()), targets_.end());
+    is_target_.assign(num_classes_, false);
+    for (int id : targets_) is_target_[id] = true;
+
+    best_score_.resize(num_det_);
+    best_class_.resize(num_det_);
+}
+
+void YoloInt8Decoder::decode(const int8_t* output, const cv::Size& frame_size, float conf_threshold, float nms_threshold,
+                             std::vector<DetectionResult>& results) {
+    boxes_.clear();
+    scores_.clear();
+    classes_.clear();
+    results.clear();
+    const int n = num_det_;
+    if (n == 0 || targets_.empty()) return;
+
+    // 역양자화 점수 (q - zp) * scale >= conf 를 만족하는 가장 작은 q.
+    // 기존 루프와 경계가 똑같도록 같은 부동소수점 식으로 확인하며 맞춤
+    auto dequant = [this](int q) { return (static_cast<float>(q) - zero_point_) * scale_; };
+    int q_thresh = static_cast<int>(std::ceil(conf_threshold / scale_ + zero_point_));
+    q_thresh = std::max(-128, std::min(q_thresh, 128));
+    while (q_thresh > -128 && dequant(q_thresh - 1) >= conf_threshold) --q_thresh;
+    while (q_thresh <= 127 && dequant(q_thresh) < conf_threshold) ++q_thresh;
+    if (q_thresh > 127) return; // 어떤 점수도 문턱을 넘을 수 없음
+
+    // 1. 대상 클래스 행에 대한 앵커별 argmax (int8 그대로)
+    int8_t* best = best_score_.data();
+    int8_t* best_class = best_class_.data();
+    std::copy(output + (4 + targets_[0]) * n, output + (4 + targets_[0] + 1) * n, best);
+    std::fill(best_class, best_class + n, static_cast<int8_t>(targets_[0]));
+    for (size_t t = 1; t < targets_.size(); ++t) {
+        const int8_t* row = output + (4 + targets_[t]) * n;
+        const int8_t cls = static_cast<int8_t>(targets_[t]);
+        int i = 0;
+#if CV_SIMD
+        constexpr int kLanes = CV_SIMD_WIDTH;
+        const cv::v_int8 v_cls = cv::vx_setall_s8(cls);
+        for (; i <= n - kLanes; i += kLanes) {
+            const cv::v_int8 score = cv::vx_load(row + i);
+            const cv::v_int8 current = cv::vx_load(best + i);
+            const cv::v_int8 better = score > current; // 동점이면 앞 클래스 유지
+            cv::v_store(best + i, cv::v_select(better, score, current));
+            cv::v_store(best_class + i, cv::v_select(better, v_cls, cv::vx_load(best_class + i)));
+        }
+#endif
+        for (; i < n; ++i) {
+            if (row[i] > best[i]) {
+                best[i] = row[i];
+                best_class[i] = cls;
+            }
+        }
+    }
+
+    // 2. 문턱 비교: 통과한 앵커만 박스/점수를 역양자화
+    const float frame_w = static_cast<float>(frame_size.width);
+    const float frame_h = static_cast<float>(frame_size.height);
+    auto add_candidate = [&](int i) {
+        const float cx = dequant(output[0 * n + i]);
+        const float cy = dequant(output[1 * n + i]);
+        const float w = dequant(output[2 * n + i]);
+        const float h = dequant(output[3 * n + i]);
+        boxes_.emplace_back(static_cast<int>((cx - w / 2) * frame_w), static_cast<int>((cy - h / 2) * frame_h),
+                            static_cast<int>(w * frame_w), static_cast<int>(h * frame_h));
+        scores_.push_back(dequant(best[i]));
+        classes_.push_back(best_class[i]);
+    };
+    const int8_t threshold = static_cast<int8_t>(q_thresh);
+    int i = 0;
+#if CV_SIMD
+    constexpr int kLanes = CV_SIMD_WIDTH;
+    // a >= t ⇔ a > t - 1 (t > -128이면); t == -128이면 모두 통과
+    const cv::v_int8 v_below = cv::vx_setall_s8(static_cast<int8_t>(std::max(-128, q_thresh - 1)));
+    for (; q_thresh > -128 && i <= n - kLanes; i += kLanes) {
+        if (!cv::v_check_any(cv::vx_load(best + i) > v_below)) continue;
+        for (int j = i; j < i + kLanes; ++j) {
+            if (best[j] >= threshold) add_candidate(j);
+        }
+    }
+#endif
+    for (; i < n; ++i) {
+        if (best[i] >= threshold) add_candidate(i);
+    }
+
+    run_nms(conf_threshold, nms_threshold, results, false);
+}
+
+void YoloInt8Decoder::run_nms(float conf_threshold, float nms_threshold, std::vector<DetectionResult>& results,
+                              bool filter_targets) {
+    nms_idx_.clear();
+    if (!boxes_.empty()) {
+        cv::dnn::NMSBoxes(boxes_, scores_, conf_threshold, nms_threshold, nms_idx_);
+    }
+    for (int idx : nms_idx_) {
+        if (filter_targets && !is_target_[classes_[idx]]) continue;
+        results.push_back({boxes_[idx], scores_[idx], classes_[idx]});
+    }
+}
+
+void YoloInt8Decoder::decode_reference(const int8_t* output, const cv::Size& frame_size, float conf_threshold,
+                                       float nms_threshold, std::vector<DetectionResult>& results) {
+    // 기존 Detector/Fall 루프: 모든 클래스를 역양자화해 argmax, 대상 클래스는 NMS 뒤에 거름
+    boxes_.clear();
+    scores_.clear();
+    classes_.clear();
+    results.clear();
+    const int n = num_det_;
+    const int W0 = frame_size.width, H0 = frame_size.height;
+    for (int i = 0; i < n; ++i) {
+        float best_conf = -1.0f;
+        int class_id = -1;
+        for (int k = 0; k < num_classes_; ++k) {
+            const float current_conf = (static_cast<float>(output[(4 + k) * n + i]) - zero_point_) * scale_;
+            if (current_conf > best_conf) {
+                best_conf = current_conf;
+                class_id = k;
+            }
+        }
+        if (best_conf < conf_threshold) continue;
+        const float cx = (static_cast<float>(output[0 * n + i]) - zero_point_) * scale_;
+        const float cy = (static_cast<float>(output[1 * n + i]) - zero_point_) * scale_;
+        const float w = (static_cast<float>(output[2 * n + i]) - zero_point_) * scale_;
+        const float h = (static_cast<float>(output[3 * n + i]) - zero_point_) * scale_;
+        boxes_.emplace_back(static_cast<int>((cx - w / 2) * W0), static_cast<int>((cy - h / 2) * H0),
+                            static_cast<int>(w * W0), static_cast<int>(h * H0));
+        scores_.push_back(best_conf);
+        classes_.push_back(class_id);
+    }
+    run_nms(conf_threshold, nms_threshold, results, true);
+}
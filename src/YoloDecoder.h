@@ -0,0 +1,46 @@
+#pragma once
+
+#include <opencv2/opencv.hpp>
+#include <cstdint>
+#include <vector>
+#include "types.h"
+
+// int8 양자화 YOLO 검출 출력 디코더 (Detector/Fall 공용).
+// 출력 텐서는 클래스 우선(class-major) 배치 [4 + 클래스 수][앵커 수]로, 앵커 i의 cx/cy/w/h와
+// 클래스 k 점수가 각각 길이 N인 연속 행에 놓입니다. 이 배치를 그대로 이용해
+//  1. conf_threshold를 한 번만 int8 문턱으로 바꾸고 (q >= q_thresh ⇔ 역양자화 점수 >= conf_threshold)
+//  2. 대상 클래스 행만 SIMD로 훑어 앵커별 최대 점수/클래스를 int8 그대로 구하고
+//  3. 문턱 비교도 SIMD로 해 한 레인도 넘지 못한 블록은 통째로 건너뛰고
+//  4. 살아남은 앵커의 박스와 점수만 역양자화합니다.
+// SIMD 코드는 OpenCV universal intrinsics로 작성돼 NEON/SSE/AVX로 컴파일됩니다.
+class YoloInt8Decoder {
+public:
+    // target_classes가 비어 있으면 모든 클래스를 대상으로 합니다. 클래스 id는 0~127이어야 합니다.
+    void configure(float scale, int zero_point, int num_classes, int num_det, std::vector<int> target_classes);
+
+    // 박스 좌표는 frame_size 기준으로 복원됩니다. results는 비운 뒤 채웁니다 (용량 유지).
+    void decode(const int8_t* output, const cv::Size& frame_size, float conf_threshold, float nms_threshold,
+                std::vector<DetectionResult>& results);
+
+    // 기존 스칼라 루프 (모든 클래스 역양자화 + argmax, NMS 뒤 대상 클래스 필터). decode()의 비교 기준 (tests/test_yolo_decoder)
+    void decode_reference(const int8_t* output, const cv::Size& frame_size, float conf_threshold, float nms_threshold,
+                          std::vector<DetectionResult>& results);
+
+private:
+    void run_nms(float conf_threshold, float nms_threshold, std::vector<DetectionResult>& results, bool filter_targets);
+
+    float scale_ = 1.0f;
+    int zero_point_ = 0;
+    int num_classes_ = 0;
+    int num_det_ = 0;
+    std::vector<int> targets_;      // 오름차순 (동점이면 앞 클래스가 이기는 기존 argmax와 같게)
+    std::vector<bool> is_target_;
+
+    // 프레임마다 재사용하는 버퍼
+    std::vector<int8_t> best_score_; // 앵커별 최대 int8 점수
+    std::vector<int8_t> best_class_;
+    std::vector<cv::Rect> boxes_;
+    std::vector<float> scores_;
+    std::vector<int> classes_;
+    std::vector<int> nms_idx_;
+};
@@ -0,0 +1,251 @@
+#include "YuvImage.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+ChromaPlanes yuv420_chroma_planes(const cv::Mat& image, PixelFormat format) {
+    const int width = image.cols;
+    const int height = image.rows * 2 / 3;
+    uchar* base = const_cast<uchar*>(image.data) + static_cast<size_t>(width) * height;
+
+    ChromaPlanes planes;
+    if (format == PixelFormat::Nv12) {
+        planes.uv = cv::Mat(height / 2, width / 2, CV_8UC2, base, width);
+    } else {
+        const size_t quarter = static_cast<size_t>(width / 2) * (height / 2);
+        planes.u = cv::Mat(height / 2, width / 2, CV_8UC1, base, width / 2);
+        planes.v = cv::Mat(height / 2, width / 2, CV_8UC1, base + quarter, width / 2);
+    }
+    return planes;
+}
+
+cv::Rect yuv420_chroma_rect(const cv::Rect& r) {
+    // 크로마 좌표로 내릴 때는 바깥쪽으로 반올림해 경계 픽셀이 빠지지 않도록 함
+    int x0 = r.x / 2, y0 = r.y / 2;
+    int x1 = (r.x + r.width + 1) / 2, y1 = (r.y + r.height + 1) / 2;
+    return cv::Rect(x0, y0, x1 - x0, y1 - y0);
+}
+
+namespace {
+
+inline uchar clamp_u8(int v) {
+    return static_cast<uchar>(std::min(std::max(v, 0), 255));
+}
+
+// roi를 out_size로 쌍선형 샘플링하며 출력 픽셀마다 put(oy, ox, r, g, b)를 부릅니다.
+// cv::resize(INTER_LINEAR)와 같은 픽셀 중심 정렬, 11비트 고정소수점 보간
+template <typename Put>
+void resample_yuv420_rgb(const cv::Mat& image, PixelFormat format, const cv::Rect& roi, const cv::Size& out_size, Put put) {
+    const int frame_w = image.cols;
+    const int frame_h = image.rows * 2 / 3;
+    // 보간 좌표는 roi 기준으로 계산하고 접근할 때만 프레임 좌표로 옮김
+    const int src_w = roi.width;
+    const int src_h = roi.height;
+
+    ChromaPlanes planes = yuv420_chroma_planes(image, format);
+    const bool nv12 = (format == PixelFormat::Nv12);
+
+    const float scale_x = static_cast<float>(src_w) / out_size.width;
+    const float scale_y = static_cast<float>(src_h) / out_size.height;
+    constexpr int kShift = 11;
+    constexpr int kOne = 1 << kShift;
+
+    // 열 좌표표는 호출마다 다시 채우지만 버퍼는 스레드별로 재사용
+    thread_local std::vector<int> x0s, wxs;
+    x0s.resize(out_size.width);
+    wxs.resize(out_size.width);
+    for (int ox = 0; ox < out_size.width; ++ox) {
+        float fx = (ox + 0.5f) * scale_x - 0.5f;
+        int x0 = static_cast<int>(std::floor(fx));
+        float ax = fx - x0;
+        if (x0 < 0) { x0 = 0; ax = 0.f; }
+        if (x0 >= src_w - 1) { x0 = src_w - 2; ax = 1.f; }
+        x0s[ox] = roi.x + x0;
+        wxs[ox] = static_cast<int>(ax * kOne + 0.5f);
+    }
+
+    for (int oy = 0; oy < out_size.height; ++oy) {
+        float fy = (oy + 0.5f) * scale_y - 0.5f;
+        int y0 = static_cast<int>(std::floor(fy));
+        float ay = fy - y0;
+        if (y0 < 0) { y0 = 0; ay = 0.f; }
+        if (y0 >= src_h - 1) { y0 = src_h - 2; ay = 1.f; }
+        const int wy = static_cast<int>(ay * kOne + 0.5f);
+
+        y0 += roi.y;
+        const uchar* row0 = image.ptr<uchar>(y0);
+        const uchar* row1 = image.ptr<uchar>(y0 + 1);
+        const int cy = std::min((y0 + (wy >= kOne / 2 ? 1 : 0)) / 2, frame_h / 2 - 1);
+
+        for (int ox = 0; ox < out_size.width; ++ox) {
+            const int x0 = x0s[ox];
+            const int wx = wxs[ox];
+            const int top = row0[x0] * (kOne - wx) + row0[x0 + 1] * wx;
+            const int bottom = row1[x0] * (kOne - wx) + row1[x0 + 1] * wx;
+            const int y = (top * (kOne - wy) + bottom * wy + (1 << (2 * kShift - 1))) >> (2 * kShift);
+
+            // 크로마는 해상도가 절반이므로 가장 가까운 샘플을 사용
+            const int cx = std::min((x0 + (wx >= kOne / 2 ? 1 : 0)) / 2, frame_w / 2 - 1);
+            int u, v;
+            if (nv12) {
+                const uchar* uv = planes.uv.ptr<uchar>(cy) + cx * 2;
+                u = uv[0];
+                v = uv[1];
+            } else {
+                u = planes.u.ptr<uchar>(cy)[cx];
+                v = planes.v.ptr<uchar>(cy)[cx];
+            }
+
+            // BT.601 limited range (cv::COLOR_YUV2RGB_I420과 동일한 계수)
+            const int c = 298 * (y - 16);
+            const int d = u - 128;
+            const int e = v - 128;
+            put(oy, ox, clamp_u8((c + 409 * e + 128) >> 8),
+                        clamp_u8((c - 100 * d - 208 * e + 128) >> 8),
+                        clamp_u8((c + 516 * d + 128) >> 8));
+        }
+    }
+}
+
+} // namespace
+
+cv::Mat yuv420_luma(cv::Mat& image) {
+    return image.rowRange(0, image.rows * 2 / 3);
+}
+
+const cv::Mat yuv420_luma(const cv::Mat& image) {
+    return image.rowRange(0, image.rows * 2 / 3);
+}
+
+void luma_thumbnail(const cv::Mat& image, PixelFormat format, int scale, cv::Mat& out) {
+    const cv::Size size = frame_size(image, format);
+    const cv::Size small(std::max(1, size.width / scale), std::max(1, size.height / scale));
+    if (format == PixelFormat::Bgr) {
+        // 축소를 먼저 해서 회색 변환할 픽셀 수를 줄임
+        thread_local cv::Mat resized;
+        cv::resize(image, resized, small, 0, 0, cv::INTER_AREA);
+        cv::cvtColor(resized, out, cv::COLOR_BGR2GRAY);
+    } else {
+        cv::resize(yuv420_luma(image), out, small, 0, 0, cv::INTER_AREA);
+    }
+}
+
+cv::Scalar bgr_to_yuv_color(const cv::Scalar& bgr) {
+    const int b = static_cast<int>(bgr[0]), g = static_cast<int>(bgr[1]), r = static_cast<int>(bgr[2]);
+    const int y = ((66 * r + 129 * g + 25 * b + 128) >> 8) + 16;
+    const int u = ((-38 * r - 74 * g + 112 * b + 128) >> 8) + 128;
+    const int v = ((112 * r - 94 * g - 18 * b + 128) >> 8) + 128;
+    return cv::Scalar(y, u, v);
+}
+
+void bgr_to_yuv420(const cv::Mat& bgr, PixelFormat format, cv::Mat& out) {
+    cv::cvtColor(bgr, out, cv::COLOR_BGR2YUV_I420);
+    if (format != PixelFormat::Nv12) return;
+
+    // I420 → NV12: U/V 평면을 UV 인터리브로 재배치
+    thread_local cv::Mat i420; // 프레임마다 할당하지 않도록 스레드별로 재사용
+    out.copyTo(i420);
+    ChromaPlanes src = yuv420_chroma_planes(i420, PixelFormat::I420);
+    ChromaPlanes dst = yuv420_chroma_planes(out, PixelFormat::Nv12);
+    cv::Mat channels[] = {src.u, src.v};
+    cv::merge(channels, 2, dst.uv);
+}
+
+void yuv420_to_bgr(const cv::Mat& image, PixelFormat format, cv::Mat& out) {
+    cv::cvtColor(image, out, format == PixelFormat::Nv12 ? cv::COLOR_YUV2BGR_NV12 : cv::COLOR_YUV2BGR_I420);
+}
+
+void yuv420_resize_to_rgb(const cv::Mat& image, PixelFormat format, const cv::Size& out_size, cv::Mat& rgb) {
+    yuv420_resize_to_rgb(image, format, cv::Rect(0, 0, image.cols, image.rows * 2 / 3), out_size, rgb);
+}
+
+void yuv420_resize_to_rgb(const cv::Mat& image, PixelFormat format, const cv::Rect& roi, const cv::Size& out_size, cv::Mat& rgb) {
+    rgb.create(out_size, CV_8UC3);
+    resample_yuv420_rgb(image, format, roi, out_size, [&rgb](int oy, int ox, uchar r, uchar g, uchar b) {
+        uchar* out = rgb.ptr<uchar>(oy) + ox * 3;
+        out[0] = r;
+        out[1] = g;
+        out[2] = b;
+    });
+}
+
+void yuv420_resize_to_int8_rgb(const cv::Mat& image, PixelFormat format, const cv::Rect& roi, const cv::Size& out_size,
+                               const int8_t* lut, int8_t* dst) {
+    const int row_stride = out_size.width * 3;
+    resample_yuv420_rgb(image, format, roi, out_size, [=](int oy, int ox, uchar r, uchar g, uchar b) {
+        int8_t* out = dst + oy * row_stride + ox * 3;
+        out[0] = lut[r];
+        out[1] = lut[g];
+        out[2] = lut[b];
+    });
+}
+
+void yuv420_rectangle(cv::Mat& image, PixelFormat format, const cv::Rect& rect, const cv::Scalar& bgr, int thickness) {
+    const cv::Scalar yuv = bgr_to_yuv_color(bgr);
+    cv::Mat luma = yuv420_luma(image);
+    cv::rectangle(luma, rect, cv::Scalar(yuv[0]), thickness);
+
+    ChromaPlanes planes = yuv420_chroma_planes(image, format);
+    const cv::Rect chroma_rect = yuv420_chroma_rect(rect);
+    const int chroma_thickness = thickness < 0 ? thickness : std::max(1, thickness / 2);
+    if (format == PixelFormat::Nv12) {
+        cv::rectangle(planes.uv, chroma_rect, cv::Scalar(yuv[1], yuv[2]), chroma_thickness);
+    } else {
+        cv::rectangle(planes.u, chroma_rect, cv::Scalar(yuv[1]), chroma_thickness);
+        cv::rectangle(planes.v, chroma_rect, cv::Scalar(yuv[2]), chroma_thickness);
+    }
+}
+
+void yuv420_polylines(cv::Mat& image, PixelFormat format, const std::vector<cv::Point>& points, const cv::Scalar& bgr, int thickness) {
+    const cv::Scalar yuv = bgr_to_yuv_color(bgr);
+    cv::Mat luma = yuv420_luma(image);
+    cv::polylines(luma, points, true, cv::Scalar(yuv[0]), thickness);
+
+    std::vector<cv::Point> chroma_points;
+    chroma_points.reserve(points.size());
+    for (const cv::Point& p : points) chroma_points.emplace_back(p.x / 2, p.y / 2);
+    ChromaPlanes planes = yuv420_chroma_planes(image, format);
+    const int chroma_thickness = std::max(1, thickness / 2);
+    if (format == PixelFormat::Nv12) {
+        cv::polylines(planes.uv, chroma_points, true, cv::Scalar(yuv[1], yuv[2]), chroma_thickness);
+    } else {
+        cv::polylines(planes.u, chroma_points, true, cv::Scalar(yuv[1]), chroma_thickness);
+        cv::polylines(planes.v, chroma_points, true, cv::Scalar(yuv[2]), chroma_thickness);
+    }
+}
+
+void yuv420_text(cv::Mat& image, const std::string& text, const cv::Point& org, double font_scale,
+                 const cv::Scalar& bgr, int thickness) {
+    cv::Mat luma = yuv420_luma(image);
+    cv::putText(luma, text, org, cv::FONT_HERSHEY_SIMPLEX, font_scale, cv::Scalar(bgr_to_yuv_color(bgr)[0]), thickness);
+}
+
+void yuv420_masked_blur(cv::Mat& image, PixelFormat format, const cv::Rect& box, const cv::Mat& mask, int ksize) {
+    cv::Mat luma = yuv420_luma(image);
+    cv::Mat roi = luma(box);
+    cv::Mat blurred;
+    cv::GaussianBlur(roi, blurred, cv::Size(ksize, ksize), 0);
+    blurred.copyTo(roi, mask);
+
+    // 색차도 같은 모양으로 흐려야 얼굴 윤곽이 색 경계로 남지 않음
+    ChromaPlanes planes = yuv420_chroma_planes(image, format);
+    const cv::Rect chroma_box = yuv420_chroma_rect(box) & cv::Rect(0, 0, image.cols / 2, image.rows / 3);
+    if (chroma_box.empty()) return;
+    cv::Mat chroma_mask;
+    cv::resize(mask, chroma_mask, chroma_box.size(), 0, 0, cv::INTER_NEAREST);
+    const int chroma_ksize = std::max(3, (ksize / 2) | 1);
+
+    auto blur_plane = [&](cv::Mat& plane) {
+        cv::Mat plane_roi = plane(chroma_box);
+        cv::Mat plane_blurred;
+        cv::GaussianBlur(plane_roi, plane_blurred, cv::Size(chroma_ksize, chroma_ksize), 0);
+        plane_blurred.copyTo(plane_roi, chroma_mask);
+    };
+    if (format == PixelFormat::Nv12) {
+        blur_plane(planes.uv);
+    } else {
+        blur_plane(planes.u);
+        blur_plane(planes.v);
+    }
+}
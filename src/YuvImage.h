@@ -0,0 +1,51 @@
+#pragma once
+
+#include <opencv2/opencv.hpp>
+#include <cstdint>
+#include <string>
+#include "Frame.h"
+
+// I420/NV12 프레임을 BGR로 바꾸지 않고 다루기 위한 도구 모음.
+// 모든 함수는 image가 (height*3/2 x width) CV_8UC1 버퍼라고 가정합니다.
+
+// 각 평면을 가리키는 Mat 헤더 (데이터 복사 없음)
+cv::Mat yuv420_luma(cv::Mat& image);
+const cv::Mat yuv420_luma(const cv::Mat& image);
+
+// 크로마 평면 헤더. I420은 U/V 평면 각각, NV12는 UV 인터리브 평면 하나를 채웁니다.
+struct ChromaPlanes {
+    cv::Mat u;   // I420 전용
+    cv::Mat v;   // I420 전용
+    cv::Mat uv;  // NV12 전용 (CV_8UC2)
+};
+ChromaPlanes yuv420_chroma_planes(const cv::Mat& image, PixelFormat format);
+// 휘도 좌표 사각형을 크로마 좌표로 내립니다 (바깥쪽으로 반올림).
+cv::Rect yuv420_chroma_rect(const cv::Rect& rect);
+
+// BGR 색상을 BT.601 limited range YUV 값으로 변환
+cv::Scalar bgr_to_yuv_color(const cv::Scalar& bgr);
+
+// 전체 프레임 변환 (스냅샷 저장이나 합성 소스 등 드문 경로에서만 사용)
+void bgr_to_yuv420(const cv::Mat& bgr, PixelFormat format, cv::Mat& out);
+void yuv420_to_bgr(const cv::Mat& image, PixelFormat format, cv::Mat& out);
+
+// YUV 420 프레임에서 바로 작은 RGB 입력 이미지(예: 192x192)를 샘플링합니다.
+// 전체 해상도 BGR 프레임을 만들지 않고 출력 픽셀 수만큼만 변환합니다.
+void yuv420_resize_to_rgb(const cv::Mat& image, PixelFormat format, const cv::Size& out_size, cv::Mat& rgb);
+// 프레임의 roi 영역(2x2 이상, 프레임 안)만 out_size로 샘플링합니다. (구역 크롭 추론용)
+void yuv420_resize_to_rgb(const cv::Mat& image, PixelFormat format, const cv::Rect& roi, const cv::Size& out_size, cv::Mat& rgb);
+// 같은 샘플링 결과를 RGB 순서로 lut(256칸)에 통과시켜 int8 HWC 버퍼(예: 모델 입력 텐서)에 바로 씁니다.
+void yuv420_resize_to_int8_rgb(const cv::Mat& image, PixelFormat format, const cv::Rect& roi, const cv::Size& out_size,
+                               const int8_t* lut, int8_t* dst);
+
+// 움직임 추정용 저해상도 휘도 영상 (1/scale 크기, CV_8UC1). BGR 프레임도 받습니다.
+void luma_thumbnail(const cv::Mat& image, PixelFormat format, int scale, cv::Mat& out);
+
+// 오버레이를 Y/U/V 평면에 직접 그립니다. 색상은 BGR로 받습니다.
+void yuv420_rectangle(cv::Mat& image, PixelFormat format, const cv::Rect& rect, const cv::Scalar& bgr, int thickness);
+void yuv420_polylines(cv::Mat& image, PixelFormat format, const std::vector<cv::Point>& points, const cv::Scalar& bgr, int thickness);
+// 글자는 휘도 평면에만 그립니다 (색차 해상도가 절반이라 얇은 획은 구분되지 않음).
+void yuv420_text(cv::Mat& image, const std::string& text, const cv::Point& org, double font_scale,
+                 const cv::Scalar& bgr, int thickness);
+// box 영역을 mask 모양대로 흐리게 처리합니다. mask는 box 크기의 CV_8UC1입니다.
+void yuv420_masked_blur(cv::Mat& image, PixelFormat format, const cv::Rect& box, const cv::Mat& mask, int ksize);
@@ -0,0 +1,57 @@
+#include "Zone.h"
+#include "json.hpp"
+
+#include <algorithm>
+
+cv::Rect zone_crop(const Zone& zone, const cv::Size& frame_size) {
+    const cv::Rect bound = cv::boundingRect(zone) & cv::Rect(0, 0, frame_size.width, frame_size.height);
+    if (bound.empty()) return cv::Rect();
+
+    const int side = std::max(bound.width, bound.height);
+    const int width = std::min(side, frame_size.width);
+    const int height = std::min(side, frame_size.height);
+    const int x = std::max(0, std::min(bound.x + bound.width / 2 - width / 2, frame_size.width - width));
+    const int y = std::max(0, std::min(bound.y + bound.height / 2 - height / 2, frame_size.height - height));
+    return cv::Rect(x, y, width, height);
+}
+
+bool in_any_zone(const std::vector<Zone>& zones, const cv::Point& point) {
+    return std::any_of(zones.begin(), zones.end(), [&](const Zone& zone) {
+        return cv::pointPolygonTest(zone, cv::Point2f(point), false) >= 0;
+    });
+}
+
+bool zones_from_json(const nlohmann::json& j, std::vector<Zone>& zones, std::string& error) {
+    if (!j.is_array()) {
+        error = "zones must be an array of polygons";
+        return false;
+    }
+    std::vector<Zone> parsed;
+    for (const auto& polygon : j) {
+        if (!polygon.is_array() || polygon.size() < 3) {
+            error = "each zone needs at least 3 points";
+            return false;
+        }
+        Zone zone;
+        for (const auto& point : polygon) {
+            if (!point.is_array() || point.size() != 2 || !point[0].is_number() || !point[1].is_number()) {
+                error = "each point must be [x, y]";
+                return false;
+            }
+            zone.emplace_back(point[0].get<int>(), point[1].get<int>());
+        }
+        parsed.push_back(std::move(zone));
+    }
+    zones = std::move(parsed);
+    return true;
+}
+
+nlohmann::json zones_to_json(const std::vector<Zone>& zones) {
+    nlohmann::json j = nlohmann::json::array();
+    for (const auto& zone : zones) {
+        nlohmann::json polygon = nlohmann::json::array();
+        for (const auto& point : zone) polygon.push_back({point.x, point.y});
+        j.push_back(polygon);
+    }
+    return j;
+}
@@ -0,0 +1,20 @@
+#pragma once
+
+#include <opencv2/opencv.hpp>
+#include <string>
+#include <vector>
+#include "json_fwd.hpp"
+
+// 감시 구역: 프레임 좌표의 다각형 (점 3개 이상)
+using Zone = std::vector<cv::Point>;
+
+// 구역을 감싸는 추론용 크롭 영역. 모델 입력이 정사각형이므로 짧은 변을 늘려 정사각형에 가깝게 만들고
+// 프레임 안으로 옮깁니다. 구역이 프레임 밖에 있으면 빈 영역을 돌려줍니다.
+cv::Rect zone_crop(const Zone& zone, const cv::Size& frame_size);
+
+// 점이 구역 중 하나의 안쪽(경계 포함)에 있으면 true
+bool in_any_zone(const std::vector<Zone>& zones, const cv::Point& point);
+
+// JSON [[[x, y], ...], ...] 형식과 변환합니다. 형식이 틀리면 false와 error를 돌려줍니다.
+bool zones_from_json(const nlohmann::json& j, std::vector<Zone>& zones, std::string& error);
+nlohmann::json zones_to_json(const std::vector<Zone>& zones);
@@ -1,35 +1,22 @@
-// detector.h (완성본)
 #pragma once
-#include "types.h"
-#include <opencv2/opencv.hpp>
-#include <vector>
-#include <string>
-#include <memory>
-#include <set>
-#include <tensorflow/lite/interpreter.h>
-#include <tensorflow/lite/kernels/register.h>
-#include <tensorflow/lite/model.h>
-#include <tensorflow/lite/interpreter_builder.h>
-#include <tensorflow/lite/delegates/xnnpack/xnnpack_delegate.h>
+#include "QuantizedYoloTflite.h"
 
-class Detector {
-public:
-    Detector(const std::string& model_path = "../detect_192.tflite", const cv::Size& input_size = {192, 192});
-    std::vector<DetectionResult> detect(const cv::Mat& image, float conf_threshold, float nms_threshold);
-    const std::vector<std::string>& get_class_names() const;
+struct DetectorTraits {
+    static constexpr const char* kDefaultModelPath = "../detect_192.tflite";
+    static constexpr std::array<const char*, 17> kClassNames = {
+        "person", "ear", "ear-mufs", "face", "face-guard", "face-mask",
+        "foot", "tool", "glasses", "gloves", "helmet", "hands", "head",
+        "medical-suit", "shoes", "safety-suit", "safety-vest"
+    };
+    // person, helmet, safety-vest. 디코더가 이 클래스들 사이에서만 최고 점수를 고름
+    static constexpr std::array<int, 3> kTargetClasses = {0, 10, 16};
+    static constexpr float kConfThreshold = 0.4f;
+    static constexpr float kNmsThreshold = 0.45f;
+};
 
-private:
-    std::unique_ptr<tflite::FlatBufferModel> model;
-    std::unique_ptr<tflite::Interpreter> interpreter;
-    std::unique_ptr<TfLiteDelegate, decltype(&TfLiteXNNPackDelegateDelete)> xnnpack_delegate;
-    float input_scale = 1.0f;
-    int input_zero_point = 0;
-    float output_scale = 1.0f;
-    int output_zero_point = 0;
-    int in_h = 0, in_w = 0, in_c = 0;
-    int out_num_attr = 0, out_num_det = 0;
-    int input_idx = 0, output_idx = 0;
-    cv::Size input_size;
-    std::vector<std::string> class_names;
-    std::set<int> target_class_ids = {0, 10, 16}; // person, helmet, safety-vest
+// PPE/침입 감지 모델 (person, helmet, safety-vest)
+class Detector : public QuantizedYoloTflite<DetectorTraits> {
+public:
+    explicit Detector(const std::string& model_path = DetectorTraits::kDefaultModelPath)
+        : QuantizedYoloTflite(model_path) {}
 };
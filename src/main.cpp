@@ -2,16 +2,15 @@
 #include "DatabaseManager.h"
 #include "ApiService.h"
 #include "SharedState.h"
-#include "StreamProcessor.h" 
+#include "StreamManager.h"
 #include "SerialCommunicator.h"
+#include "ServerConfig.h"
 
 #include <thread>
 #include <csignal>
 #include <iostream>
 
 // 전역 변수 선언
-std::string g_current_mode = "raw";
-std::mutex g_mode_mutex;
 std::atomic<bool> g_keep_running(true);
 
 // 시그널 핸들러
@@ -25,40 +24,53 @@ int main() {
     signal(SIGINT, signal_handler);
     signal(SIGTERM, signal_handler);
 
-    // 2. 핵심 컴포넌트 생성
+    // 2. 설정 로드 및 핵심 컴포넌트 생성
+    ServerConfig config = loadServerConfig("config/server.json");
     DatabaseManager dbManager("data/detections.db", "data/blur.db", "data/fall.db", "data/trespass.db", "captured_images");
-    StreamProcessor streamProcessor(dbManager);
-    SerialCommunicator& serial_comm = streamProcessor.getSerialCommunicator();
+
+    // 설정된 카메라마다 파이프라인을 만들고 모델은 하나의 추론 엔진으로 공유합니다.
+    std::unique_ptr<StreamManager> streamManager;
+    try {
+        streamManager = std::make_unique<StreamManager>(dbManager, config);
+    } catch (const std::exception& e) {
+        std::cerr << "오류: " << e.what() << std::endl;
+        return 1;
+    }
+    SerialCommunicator& serial_comm = streamManager->getSerialCommunicator();
     
     crow::SimpleApp app;
-    ApiService apiService(app, streamProcessor, dbManager, serial_comm);
+    ApiService apiService(app, *streamManager, dbManager, serial_comm);
     apiService.setupRoutes();
 
     // 콜백 함수 등록 (이벤트 연결)
-    streamProcessor.onAnomalyStatusChanged([&apiService](bool isAnomaly) {
+    streamManager->onAnomalyStatusChanged([&apiService](bool isAnomaly) {
         apiService.broadcastAnomalyStatus(isAnomaly);
     });
 
-    streamProcessor.onNewDetection([&apiService](const DetectionData& data) {
+    streamManager->onNewDetection([&apiService](const DetectionData& data) {
         apiService.broadcastNewDetection(data);
     });
 
-    streamProcessor.onNewBlur([&apiService](const PersonCountData& data) {
+    streamManager->onNewBlur([&apiService](const PersonCountData& data) {
         apiService.broadcastNewBlur(data);
     });
 
-    streamProcessor.onNewFall([&apiService](const FallCountData& data) {
+    streamManager->onNewFall([&apiService](const FallCountData& data) {
         apiService.broadcastNewFall(data);
     });
 
-    streamProcessor.onNewTrespass([&apiService](const TrespassLogData& data) {
+    streamManager->onNewTrespass([&apiService](const TrespassLogData& data) {
         apiService.broadcastNewTrespass(data);
     });
 
-    streamProcessor.onSystemInfoUpdate([&apiService](double cpuUsage, double memoryUsage) {
+    streamManager->onSystemInfoUpdate([&apiService](double cpuUsage, double memoryUsage) {
         apiService.broadcastSystemInfo(cpuUsage, memoryUsage);
     });
 
+    streamManager->onModelLoad([&apiService](const ModelLoadEvent& event) {
+        apiService.broadcastModelLoad(event);
+    });
+
     // 3. API 서버를 백그라운드 스레드에서 실행
     std::thread server_thread([&app](){
         std::cout << "C++ 백엔드 서버가 8443번 포트에서 시작됩니다..." << std::endl;
@@ -68,8 +80,8 @@ int main() {
         .run();
     });
 
-    // 4. 메인 스레드에서 영상 처리 루프 실행
-    streamProcessor.run(); // g_keep_running이 false가 될 때까지 여기서 대기
+    // 4. 메인 스레드에서 카메라 파이프라인 실행 및 모니터링
+    streamManager->run(); // g_keep_running이 false가 될 때까지 여기서 대기
 
     // 5. 정리
     std::cout << "서버와 스트리밍 프로세스를 중지하고 리소스를 정리합니다..." << std::endl;
@@ -1,20 +1,103 @@
 #include "segmenter.h"
+#include "PrivacyBlur.h"
+#include "InferenceThreadPool.h"
+#include "ModelCache.h"
 #include "yolo_backend/include/constants.h"
 #include "yolo_backend/include/utils/common.h" // generateRandomColors 함수를 위해
 
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <iostream>
+#include <stdexcept>
+
+namespace {
+
+GraphOptimizationLevel parse_graph_optimization(const std::string& name) {
+    if (name == "disabled") return ORT_DISABLE_ALL;
+    if (name == "basic") return ORT_ENABLE_BASIC;
+    if (name == "extended") return ORT_ENABLE_EXTENDED;
+    if (name != "all") std::cerr << "[WARN] 알 수 없는 그래프 최적화 수준: " << name << " (all 사용)" << std::endl;
+    return ORT_ENABLE_ALL;
+}
+
+ExecutionMode parse_execution_mode(const std::string& name) {
+    if (name == "parallel") return ORT_PARALLEL;
+    if (name != "sequential") std::cerr << "[WARN] 알 수 없는 실행 모드: " << name << " (sequential 사용)" << std::endl;
+    return ORT_SEQUENTIAL;
+}
+
+OnnxSessionProfile make_profile(const OnnxSessionConfig& config) {
+    OnnxSessionProfile profile;
+    profile.intraOpThreads = config.intra_op_threads;
+    profile.interOpThreads = config.inter_op_threads;
+    profile.graphOptimization = parse_graph_optimization(config.graph_optimization);
+    profile.executionMode = parse_execution_mode(config.execution_mode);
+    profile.cpuMemArena = config.cpu_mem_arena;
+    profile.memPattern = config.mem_pattern;
+    return profile;
+}
+
+} // namespace
+
 // 생성자: 모델 로딩 및 초기 설정
-Segmenter::Segmenter(const std::string& model_path) {
+Segmenter::Segmenter(const std::string& model_path, const OnnxSessionConfig& session) {
     conf_threshold = 0.5f;
     iou_threshold = 0.45f;
     mask_threshold = 0.5f;
 
     const std::string onnx_provider = OnnxProviders::CPU;
-    model = std::make_unique<AutoBackendOnnx>(model_path.c_str(), "segmenter_log", onnx_provider.c_str());
+    Ort::Env& env = InferenceThreadPool::instance().ort_env();
+    OnnxSessionProfile profile = make_profile(session);
+
+    // 최적화된 그래프는 원본 모델, 최적화 수준, ORT 버전에 따라 달라짐. 모델 경로와 뒤의 둘은 키로,
+    // 모델 내용은 해시로 넘겨 최적화 수준마다 캐시가 따로 남음
+    std::string cache_path;
+    bool cache_hit = false;
+    uint64_t model_hash = 0;
+    if (!session.optimized_model_dir.empty() && profile.graphOptimization != ORT_DISABLE_ALL &&
+        hash_file(model_path, model_hash)) {
+        const std::string key = std::string(OrtGetApiBase()->GetVersionString()) + "/" + session.graph_optimization;
+        cache_path = prepare_cache_file(session.optimized_model_dir, model_path, key, model_hash, ".opt.onnx", cache_hit);
+    }
+
+    const auto started = std::chrono::steady_clock::now();
+    if (cache_hit) {
+        OnnxSessionProfile cached = profile;
+        cached.graphOptimization = ORT_DISABLE_ALL;
+        try {
+            model_file = cache_path;
+            model = std::make_unique<AutoBackendOnnx>(model_file.c_str(), "segmenter_log", onnx_provider.c_str(), &env, cached);
+            if (model->getNames().empty()) throw std::runtime_error("클래스 메타데이터 없음");
+        } catch (const std::exception& e) {
+            // 깨졌거나 다른 환경에서 만든 캐시는 지우고 원본에서 다시 만듦
+            std::cerr << "[WARN] 최적화 그래프 캐시를 쓸 수 없어 다시 만듭니다: " << e.what() << std::endl;
+            model.reset();
+            std::error_code ec;
+            std::filesystem::remove(cache_path, ec);
+            cache_hit = false;
+        }
+    }
+    if (!model) {
+        // 저장 중에 죽어도 반쯤 쓴 파일을 캐시로 읽지 않도록 임시 이름으로 저장한 뒤 옮김
+        const std::string pending = cache_path.empty() ? "" : cache_path + ".tmp";
+        profile.optimizedModelPath = pending;
+        model_file = model_path;
+        model = std::make_unique<AutoBackendOnnx>(model_file.c_str(), "segmenter_log", onnx_provider.c_str(), &env, profile);
+        if (!pending.empty()) {
+            std::error_code ec;
+            std::filesystem::rename(pending, cache_path, ec);
+            if (ec) std::cerr << "[WARN] 최적화 그래프 캐시 저장 실패: " << ec.message() << std::endl;
+        }
+    }
+    const double load_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - started).count();
+    std::cout << "[INFO] segmenter 세션 준비 " << static_cast<int>(load_ms) << " ms (최적화 그래프 캐시: "
+              << (cache_path.empty() ? "꺼짐" : cache_hit ? "hit" : "miss (새로 생성)") << ")" << std::endl;
 
     auto names = model->getNames();
     colors = generateRandomColors(model->getNc(), model->getCh());
 
-    person_class_id = 0;
+    person_class_id = -1;
     for (const auto& pair : names) {
         if (pair.second == "'person'") { // 따옴표 포함
             person_class_id = pair.first;
@@ -25,6 +108,8 @@ Segmenter::Segmenter(const std::string& model_path) {
     if (person_class_id == -1) {
         throw std::runtime_error("'person' class not found in the model!");
     }
+    // 블러에는 사람 마스크만 쓰므로 다른 클래스는 마스크를 만들지 않음
+    model->setMaskClasses({ person_class_id });
     std::cout << "Segmenter initialized. Found 'person' with ID: " << person_class_id << std::endl;
 }
 
@@ -32,29 +117,55 @@ Segmenter::Segmenter(const std::string& model_path) {
 Segmenter::~Segmenter() {}
 
 SegmentationResult Segmenter::process_frame(cv::Mat& frame) {
-    if (frame.empty()) return {0}; // 빈 프레임이면 0명 반환
+    SegmentationResult result = segment(frame);
+    PrivacyBlur().apply(frame, PixelFormat::Bgr, result);
 
-    std::vector<YoloResults> all_results = model->predict_once(frame, conf_threshold, iou_threshold, mask_threshold);
-    std::vector<YoloResults> person_results;
-    for (const auto& result : all_results) {
-        if (result.class_idx == person_class_id) {
-            person_results.push_back(result);
-        }
+    // 사람 수를 담은 구조체를 반환합니다.
+    return result;
+}
+
+SegmentationResult Segmenter::segment(const cv::Mat& frame) {
+    SegmentationResult result;
+    if (frame.empty()) return result; // 빈 프레임이면 0명 반환
+
+    // predict_once는 conversionCode가 -1이면 입력을 수정하지 않습니다.
+    cv::Mat input = frame;
+    // Run()이 predict 안에 있어 전후처리까지 게이트 안에서 돎
+    auto gate = InferenceThreadPool::instance().enter();
+    std::vector<YoloResults> all_results = model->predict_once(input, conf_threshold, iou_threshold, mask_threshold);
+    to_result(all_results, result);
+    return result;
+}
+
+void Segmenter::segment_batch(const std::vector<cv::Mat>& frames, std::vector<SegmentationResult>& results) {
+    results.resize(frames.size());
+    batch_inputs_.clear();
+    batch_index_.clear();
+    for (size_t i = 0; i < frames.size(); ++i) {
+        results[i].person_count = 0;
+        results[i].boxes.clear();
+        results[i].masks.clear();
+        if (frames[i].empty()) continue;
+        batch_inputs_.push_back(frames[i]);
+        batch_index_.push_back(i);
     }
-    apply_blur(frame, person_results);
+    if (batch_inputs_.empty()) return;
 
-    // 사람 수를 담은 구조체를 반환합니다.
-    return {(int)person_results.size()};
+    auto gate = InferenceThreadPool::instance().enter();
+    model->predict_batch(batch_inputs_, conf_threshold, iou_threshold, mask_threshold, batch_results_);
+    for (size_t i = 0; i < batch_results_.size(); ++i) {
+        to_result(batch_results_[i], results[batch_index_[i]]);
+    }
 }
 
-// 블러 처리 함수
-void Segmenter::apply_blur(cv::Mat& img, std::vector<YoloResults>& results) {
-    for (const auto& res : results) {
-        if (res.mask.rows && res.mask.cols > 0) {
-            cv::Mat roi = img(res.bbox);
-            cv::Mat blurred_roi;
-            cv::GaussianBlur(roi, blurred_roi, cv::Size(51, 51), 0);
-            blurred_roi.copyTo(roi, res.mask);
+void Segmenter::to_result(const std::vector<YoloResults>& yolo_results, SegmentationResult& result) const {
+    result.boxes.clear();
+    result.masks.clear();
+    for (const auto& res : yolo_results) {
+        if (res.class_idx == person_class_id && res.mask.rows > 0 && res.mask.cols > 0) {
+            result.boxes.push_back(res.bbox);
+            result.masks.push_back(res.mask);
         }
     }
-}
\ No newline at end of file
+    result.person_count = static_cast<int>(result.boxes.size());
+}
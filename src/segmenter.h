@@ -4,28 +4,48 @@
 
 #include <opencv2/opencv.hpp>
 #include <memory>
+#include <string>
 #include "nn/autobackend.h"
+#include "Frame.h"
+#include "ServerConfig.h"
 
 // 반환값으로 사용할 구조체 정의
 struct SegmentationResult {
     int person_count = 0;
+    std::vector<cv::Rect> boxes;  // 사람 영역 (프레임 좌표)
+    std::vector<cv::Mat> masks;   // boxes와 같은 크기의 이진 마스크
 };
 
 class Segmenter {
 public:
-    Segmenter(const std::string& model_path);
+    // session은 ONNX Runtime 세션 프로필 (models.onnx). optimized_model_dir가 있으면 처음 로드할 때
+    // 최적화된 그래프를 <모델>-<키 해시>-<모델 해시>.opt.onnx로 저장하고, 다음 로드부터는 그 파일을 최적화 없이 엽니다.
+    explicit Segmenter(const std::string& model_path, const OnnxSessionConfig& session = OnnxSessionConfig());
     ~Segmenter();
 
-    // 함수 이름을 바꾸고, 사람 수를 담은 구조체를 반환하도록 수정
+    // 함수 이름을 바꾸고, 사람 수를 담은 구조체를 반환하도록 수정 (블러는 PrivacyBlur 기본 설정)
     SegmentationResult process_frame(cv::Mat& frame);
 
+    // 프레임을 수정하지 않고 사람 영역과 마스크만 계산합니다.
+    SegmentationResult segment(const cv::Mat& frame);
+
+    // 여러 카메라의 프레임을 session.Run() 한 번으로 처리합니다. (모델 배치 축이 고정이면 한 장씩)
+    // results는 frames 크기로 맞춘 뒤 채우며, 항목의 벡터 용량은 그대로 재사용합니다.
+    void segment_batch(const std::vector<cv::Mat>& frames, std::vector<SegmentationResult>& results);
+
 private:
+    void to_result(const std::vector<YoloResults>& yolo_results, SegmentationResult& result) const;
+
     std::unique_ptr<AutoBackendOnnx> model;
+    std::string model_file; // 실제로 연 파일 (AutoBackendOnnx가 경로 포인터를 보관하므로 유지)
     int person_class_id;
     float conf_threshold;
     float iou_threshold;
     float mask_threshold;
     std::vector<cv::Scalar> colors;
 
-    void apply_blur(cv::Mat& img, std::vector<YoloResults>& results);
+    // segment_batch()가 호출마다 비워 다시 쓰는 목록
+    std::vector<cv::Mat> batch_inputs_;
+    std::vector<size_t> batch_index_; // batch_inputs_[i]가 frames의 몇 번째인지
+    std::vector<std::vector<YoloResults>> batch_results_;
 };
\ No newline at end of file
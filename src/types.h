@@ -7,4 +7,5 @@ struct DetectionResult {
     cv::Rect box;
     float confidence;
     int class_id;
+    int track_id = -1; // ObjectTracker가 붙이는 프레임 간 식별자 (확정 전이거나 추적을 끄면 -1)
 };
\ No newline at end of file
@@ -6,6 +6,7 @@
 
 #include "onnx_model_base.h"
 #include "constants.h"
+#include "utils/augment.h"
 
 /**
  * @brief Represents the results of YOLO prediction.
@@ -31,9 +32,11 @@ public:
     // constructors
     AutoBackendOnnx(const char* modelPath, const char* logid, const char* provider,
         const std::vector<int>& imgsz, const int& stride,
-        const int& nc, std::unordered_map<int, std::string> names);
+        const int& nc, std::unordered_map<int, std::string> names, Ort::Env* sharedEnv = nullptr,
+        const OnnxSessionProfile& profile = OnnxSessionProfile());
 
-    AutoBackendOnnx(const char* modelPath, const char* logid, const char* provider);
+    AutoBackendOnnx(const char* modelPath, const char* logid, const char* provider, Ort::Env* sharedEnv = nullptr,
+        const OnnxSessionProfile& profile = OnnxSessionProfile());
 
     // getters
     virtual const std::vector<int>& getImgsz();
@@ -64,6 +67,18 @@ public:
     virtual std::vector<YoloResults> predict_once(cv::Mat& image, float& conf, float& iou, float& mask_threshold, int conversionCode = -1, bool verbose = true);
     virtual std::vector<YoloResults> predict_once(const std::filesystem::path& imagePath, float& conf, float& iou, float& mask_threshold, int conversionCode = -1, bool verbose = true);
     virtual std::vector<YoloResults> predict_once(const std::string& imagePath, float& conf, float& iou, float& mask_threshold, int conversionCode = -1, bool verbose = true);
+    /**
+     * @brief Runs prediction on several images with a single session.Run().
+     *
+     * The letterboxed images are stacked along the batch dimension and the outputs are split back per image.
+     * Falls back to one predict_once() per image when the model input has a fixed batch size.
+     *
+     * @param batch_results Resized to images.size() and filled with one vector of YoloResults per input image,
+     *                      in the same order. Its storage is reused between calls.
+     */
+    virtual void predict_batch(std::vector<cv::Mat>& images, float& conf, float& iou, float& mask_threshold,
+        std::vector<std::vector<YoloResults>>& batch_results);
+    virtual bool supportsDynamicBatch() const;
 
     virtual void fill_blob(cv::Mat& image, float*& blob, std::vector<int64_t>& inputTensorShape);
     virtual void postprocess_masks(cv::Mat& output0, cv::Mat& output1, ImageInfo para, std::vector<YoloResults>& output,
@@ -74,8 +89,26 @@ public:
         int& class_names_num, float& conf_threshold, float& iou_threshold);
     virtual void postprocess_kpts(cv::Mat& output0, ImageInfo& image_info, std::vector<YoloResults>& output,
                                   int& class_names_num, float& conf_threshold, float& iou_threshold);
-    static void _get_mask2(const cv::Mat& mask_info, const cv::Mat& mask_data, const ImageInfo& image_info, cv::Rect bound, cv::Mat& mask_out,
-        float& mask_thresh, int& iw, int& ih, int& mw, int& mh, int& masks_features_num, bool round_downsampled = false);
+    virtual std::vector<YoloResults> postprocess(std::vector<Ort::Value>& outputTensors, int batch_index, const cv::Size& raw_size,
+        float& conf, float& iou, float& mask_threshold);
+    /**
+     * @brief Restricts mask decoding to the given class indices.
+     *
+     * Detections of other classes are still returned, with an empty mask. An empty list (default) decodes every class.
+     */
+    void setMaskClasses(const std::vector<int>& classes);
+    /**
+     * @brief Decodes one instance mask inside its box only.
+     *
+     * @param mask_logits [mh, mw] prototype logits of the instance (its row of the batched coefficient x proto GEMM).
+     * @param bound The instance box in frame coordinates, already clipped to the frame.
+     * @param mask_out Binary CV_8U mask of bound.size().
+     *
+     * The sigmoid is taken only over the box footprint at prototype resolution, and only that crop is
+     * upsampled (bilinear) to the box and thresholded.
+     */
+    static void _get_mask2(const cv::Mat& mask_logits, const ImageInfo& image_info, cv::Rect bound, cv::Mat& mask_out,
+        float& mask_thresh, int& iw, int& ih, int& mw, int& mh);
 
 protected:
     std::vector<int> imgsz_;
@@ -86,5 +119,21 @@ protected:
     std::vector<int64_t> inputTensorShape_;
     cv::Size cvSize_;
     std::string task_;
+    bool dynamicBatch_ = false;  ///< true if the input batch dimension is dynamic (-1)
+
+    // predict_once() keeps its input/output tensors bound through IoBinding and reuses them every frame
+    void prepare_binding();
+    bool bindingReady_ = false;
+    bool outputsPreallocated_ = false;  ///< false if an output has a dynamic non-batch dimension
+    Ort::MemoryInfo bindingMemoryInfo_{ nullptr };
+    Ort::IoBinding binding_{ nullptr };
+    std::vector<float> inputBuffer_;  ///< [1, ch, h, w]
+    Ort::Value inputTensor_{ nullptr };
+    std::vector<std::vector<float>> outputBuffers_;
+    std::vector<Ort::Value> boundOutputs_;  ///< tensors over outputBuffers_, in output order
+    LetterboxBlob letterboxBlob_;  ///< keeps its padded canvas between frames
+    std::vector<float> batchInput_;  ///< predict_batch() input tensor, [bs, ch, h, w], reused between calls
+    std::vector<int> maskClasses_;  ///< classes that get a mask in postprocess_masks(); empty = all
+    cv::Mat maskLogits_;  ///< [instances, mh * mw] GEMM output, reused between frames
     //cv::MatSize cvMatSize_;
 };
@@ -4,6 +4,19 @@
 #include <unordered_map>
 #include <vector>
 
+// ONNX Runtime 세션 설정. 기본값은 기존 동작(기본 SessionOptions)과 같습니다.
+struct OnnxSessionProfile {
+    // 0이면 공유 Env의 전역 스레드 풀을 씀 (공유 Env가 없으면 ORT 기본값). 양수면 이 세션만의 스레드 풀
+    int intraOpThreads = 0;
+    int interOpThreads = 0;
+    GraphOptimizationLevel graphOptimization = ORT_ENABLE_ALL;
+    ExecutionMode executionMode = ORT_SEQUENTIAL;
+    bool cpuMemArena = true;
+    bool memPattern = true;
+    // 비어 있지 않으면 세션을 만들 때 최적화된 그래프를 이 경로에 저장
+    std::string optimizedModelPath;
+};
+
 /*
  * This interface must provide only required arguments to load any onnx model regarding specific info -
  *  - i.e. modelPath will always be required, provider like "cpu" or "cuda" the same, since these are parameters you need
@@ -11,7 +24,9 @@
  */
 class OnnxModelBase {
 public:
-    OnnxModelBase(const char* modelPath, const char* logid, const char* provider);
+    // sharedEnv가 있으면 그 Env로 세션을 만들고, profile의 스레드 수가 0이면 Env의 전역 스레드 풀을 씁니다.
+    OnnxModelBase(const char* modelPath, const char* logid, const char* provider, Ort::Env* sharedEnv = nullptr,
+                  const OnnxSessionProfile& profile = OnnxSessionProfile());
     //OnnxModelBase();  // no default constructor should be there
     //virtual ~OnnxModelBase();
     virtual const std::vector<std::string>& getInputNames(); // = 0
@@ -1,4 +1,5 @@
 #pragma once
+#include <opencv2/core/mat.hpp>
 #include <opencv2/core/types.hpp>
 
 void letterbox(const cv::Mat& image,
@@ -11,6 +12,38 @@ void letterbox(const cv::Mat& image,
 );
 
 
+/**
+ * @brief Where letterbox() places the resized image inside its output (same arguments as letterbox()).
+ *
+ * Used to map frame coordinates into model-input (and prototype mask) coordinates.
+ */
+cv::Rect letterbox_roi(const cv::Size& shape, const cv::Size& newShape = cv::Size(640, 640), bool auto_ = true,
+    bool scaleFill = false, bool scaleUp = true, int stride = 32);
+
+
+/**
+ * @brief Fused letterbox + 1/255 scaling + HWC->CHW for 8-bit 3-channel images.
+ *
+ * Resizes the image straight into the inner region of a persistent padded canvas (the border is filled
+ * only when the letterbox geometry changes), then makes a single SIMD pass that deinterleaves the
+ * channels, scales them by 1/255 and writes planar floats into `blob`. The output is bit-identical to
+ * letterbox() followed by convertTo(CV_32FC3, 1.0 / 255) and cv::split into CHW planes (checked against
+ * cv::dnn::blobFromImage by tests/test_letterbox_blob).
+ * Other image types fall back to exactly that sequence.
+ */
+class LetterboxBlob {
+public:
+    /// Writes channels() planes of the returned size into blob (the caller sizes it for newShape).
+    cv::Size run(const cv::Mat& image, float* blob, const cv::Size& newShape = cv::Size(640, 640),
+        cv::Scalar_<double> color = cv::Scalar(), bool auto_ = true, bool scaleFill = false,
+        bool scaleUp = true, int stride = 32);
+
+private:
+    cv::Mat canvas_;  ///< letterboxed 8UC3 image, border kept between calls
+    cv::Rect roi_;    ///< where the resized image sits inside canvas_
+    cv::Scalar color_;
+};
+
 cv::Mat scale_image(const cv::Mat& resized_mask, const cv::Size& im0_shape, const std::pair<float,
     cv::Point2f>& ratio_pad = std::make_pair(-1.0f, cv::Point2f(-1.0f, -1.0f)));
 
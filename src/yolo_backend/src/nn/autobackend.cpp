@@ -1,5 +1,8 @@
 #include "nn/autobackend.h"
 
+#include <algorithm>
+#include <cmath>
+#include <cstring>
 #include <iostream>
 #include <ostream>
 #include <filesystem>
@@ -20,16 +23,17 @@ namespace fs = std::filesystem;
 
 AutoBackendOnnx::AutoBackendOnnx(const char* modelPath, const char* logid, const char* provider,
     const std::vector<int>& imgsz, const int& stride,
-    const int& nc, const std::unordered_map<int, std::string> names)
-    : OnnxModelBase(modelPath, logid, provider), imgsz_(imgsz), stride_(stride), nc_(nc), names_(names),
+    const int& nc, const std::unordered_map<int, std::string> names, Ort::Env* sharedEnv,
+    const OnnxSessionProfile& profile)
+    : OnnxModelBase(modelPath, logid, provider, sharedEnv, profile), imgsz_(imgsz), stride_(stride), nc_(nc), names_(names),
     inputTensorShape_()
 {
 }
 
-AutoBackendOnnx::AutoBackendOnnx(const char* modelPath, const char* logid, const char* provider)
-    : OnnxModelBase(modelPath, logid, provider) {
-    // init metadata etc
-    OnnxModelBase(modelPath, logid, provider);
+AutoBackendOnnx::AutoBackendOnnx(const char* modelPath, const char* logid, const char* provider, Ort::Env* sharedEnv,
+    const OnnxSessionProfile& profile)
+    : OnnxModelBase(modelPath, logid, provider, sharedEnv, profile) {
+    // metadata is already initialized by OnnxModelBase
     // then try to get additional info from metadata like imgsz, stride etc;
     //  ideally you should get all of them but you'll raise error if smth is not in metadata (or not under the appropriate keys)
     const std::unordered_map<std::string, std::string>& base_metadata = OnnxModelBase::getMetadata();
@@ -116,6 +120,10 @@ AutoBackendOnnx::AutoBackendOnnx(const char* modelPath, const char* logid, const
         std::cerr << "Warning: Cannot get task value from metadata" << std::endl;
     }
 
+    // batch init: only models exported with a dynamic batch axis can stack several images
+    std::vector<int64_t> modelInputShape = session.GetInputTypeInfo(0).GetTensorTypeAndShapeInfo().GetShape();
+    dynamicBatch_ = !modelInputShape.empty() && modelInputShape[0] < 0;
+
     // TODO: raise assert if imgsz_ and task_ were not initialized (since you don't know in that case which postprocessing to use)
 
 }
@@ -168,6 +176,16 @@ const std::string& AutoBackendOnnx::getTask()
     return task_;
 }
 
+void AutoBackendOnnx::setMaskClasses(const std::vector<int>& classes)
+{
+    maskClasses_ = classes;
+}
+
+bool AutoBackendOnnx::supportsDynamicBatch() const
+{
+    return dynamicBatch_;
+}
+
 std::vector<YoloResults> AutoBackendOnnx::predict_once(const std::string& imagePath, float& conf, float& iou, float& mask_threshold,
     int conversionCode, bool verbose) {
     // Convert the string imagePath to an object of type std::filesystem::path
@@ -215,97 +233,168 @@ std::vector<YoloResults> AutoBackendOnnx::predict_once(cv::Mat& image, float& co
     double inference_time = 0.0;
     double postprocess_time = 0.0;
     Timer preprocess_timer = Timer(preprocess_time, verbose);
-    // 1. preprocess
-    float* blob = nullptr;
-    //double* blob = nullptr;
-    std::vector<Ort::Value> inputTensors;
+    // 1. preprocess: letterbox + 1/255 + HWC->CHW in one kernel, straight into the bound input buffer
     if (conversionCode >= 0) {
         cv::cvtColor(image, image, conversionCode);
     }
-    std::vector<int64_t> inputTensorShape;
     // TODO: for classify task preprocessed image will be different (!):
-    cv::Mat preprocessed_img;
     cv::Size new_shape = cv::Size(getWidth(), getHeight());
     const bool& scaleFill = false;  // false
     const bool& auto_ = false; // true
-    letterbox(image, preprocessed_img, new_shape, cv::Scalar(), auto_, scaleFill, true, getStride());
-    fill_blob(preprocessed_img, blob, inputTensorShape);
-    int64_t inputTensorSize = vector_product(inputTensorShape);
-    std::vector<float> inputTensorValues(blob, blob + inputTensorSize);
+    if (!bindingReady_) {
+        prepare_binding();
+    }
+    letterboxBlob_.run(image, inputBuffer_.data(), new_shape, cv::Scalar(), auto_, scaleFill, true, getStride());
+    preprocess_timer.Stop();
+    Timer inference_timer = Timer(inference_time, verbose);
+    // 2. inference: outputs land in the preallocated buffers (or arena tensors for dynamic output shapes)
+    session.Run(Ort::RunOptions{ nullptr }, binding_);
+    inference_timer.Stop();
+    Timer postprocess_timer = Timer(postprocess_time, verbose);
+    // create container for the results
+    std::vector<YoloResults> results;
+    if (outputsPreallocated_) {
+        results = postprocess(boundOutputs_, 0, image.size(), conf, iou, mask_threshold);
+    }
+    else {
+        std::vector<Ort::Value> outputTensors = binding_.GetOutputValues();
+        results = postprocess(outputTensors, 0, image.size(), conf, iou, mask_threshold);
+    }
+
+    postprocess_timer.Stop();
+    /*
+    if (verbose) {
+        std::cout << std::fixed << std::setprecision(1);
+        std::cout << "image: " << new_shape.height << "x" << new_shape.width << " " << results.size() << " objs, ";
+        std::cout << (preprocess_time + inference_time + postprocess_time) * 1000.0 << "ms" << std::endl;
+        std::cout << "Speed: " << (preprocess_time * 1000.0) << "ms preprocess, ";
+        std::cout << (inference_time * 1000.0) << "ms inference, ";
+        std::cout << (postprocess_time * 1000.0) << "ms postprocess per image ";
+        std::cout << "at shape (1, " << image.channels() << ", " << new_shape.height << ", " << new_shape.width << ")" << std::endl;
+    }
+*/
+    return results;
+}
+
+
+void AutoBackendOnnx::prepare_binding() {
+    // input: one [1, ch, h, w] buffer that the preprocessing kernel writes CHW floats into
+    const cv::Size shape = getCvSize();
+    const int64_t plane = static_cast<int64_t>(shape.width) * shape.height;
+    const std::vector<int64_t> inputShape = { 1, ch_, shape.height, shape.width };
+    inputBuffer_.assign(ch_ * plane, 0.0f);
+    bindingMemoryInfo_ = Ort::MemoryInfo::CreateCpu(OrtAllocatorType::OrtArenaAllocator, OrtMemType::OrtMemTypeDefault);
+    binding_ = Ort::IoBinding(session);
+    inputTensor_ = Ort::Value::CreateTensor<float>(bindingMemoryInfo_, inputBuffer_.data(), inputBuffer_.size(),
+        inputShape.data(), inputShape.size());
+    binding_.BindInput(inputNamesCStr[0], inputTensor_);
+
+    // outputs: preallocate when every dimension except batch is known, otherwise let ORT allocate per Run()
+    std::vector<std::vector<int64_t>> outputShapes;
+    outputsPreallocated_ = true;
+    for (size_t i = 0; i < outputNamesCStr.size(); ++i) {
+        std::vector<int64_t> outputShape = session.GetOutputTypeInfo(i).GetTensorTypeAndShapeInfo().GetShape();
+        if (!outputShape.empty() && outputShape[0] < 0) {
+            outputShape[0] = 1;
+        }
+        for (int64_t dim : outputShape) {
+            if (dim < 0) outputsPreallocated_ = false;
+        }
+        outputShapes.push_back(outputShape);
+    }
+    outputBuffers_.clear();
+    boundOutputs_.clear();
+    for (size_t i = 0; i < outputNamesCStr.size(); ++i) {
+        if (!outputsPreallocated_) {
+            binding_.BindOutput(outputNamesCStr[i], bindingMemoryInfo_);
+            continue;
+        }
+        outputBuffers_.emplace_back(vector_product(outputShapes[i]));
+        boundOutputs_.push_back(Ort::Value::CreateTensor<float>(bindingMemoryInfo_, outputBuffers_.back().data(),
+            outputBuffers_.back().size(), outputShapes[i].data(), outputShapes[i].size()));
+        binding_.BindOutput(outputNamesCStr[i], boundOutputs_.back());
+    }
+    bindingReady_ = true;
+}
+
+
+void AutoBackendOnnx::predict_batch(std::vector<cv::Mat>& images, float& conf, float& iou, float& mask_threshold,
+    std::vector<std::vector<YoloResults>>& batch_results) {
+    batch_results.resize(images.size());
+    if (images.empty()) {
+        return;
+    }
+    if (images.size() == 1 || !dynamicBatch_) {
+        for (size_t b = 0; b < images.size(); ++b) {
+            batch_results[b] = predict_once(images[b], conf, iou, mask_threshold, -1, false);
+        }
+        return;
+    }
+
+    // 1. preprocess: letterbox every image and write it as CHW directly into its slot of the batch tensor (fused kernel)
+    const int batch = static_cast<int>(images.size());
+    const cv::Size new_shape = cv::Size(getWidth(), getHeight());
+    const int64_t plane = static_cast<int64_t>(new_shape.width) * new_shape.height;
+    std::vector<int64_t> inputTensorShape = { batch, ch_, new_shape.height, new_shape.width };
+    batchInput_.resize(vector_product(inputTensorShape));
+    for (int b = 0; b < batch; ++b) {
+        letterboxBlob_.run(images[b], batchInput_.data() + b * ch_ * plane, new_shape, cv::Scalar(), false, false, true, getStride());
+    }
 
     Ort::MemoryInfo memoryInfo = Ort::MemoryInfo::CreateCpu(
         OrtAllocatorType::OrtArenaAllocator, OrtMemType::OrtMemTypeDefault);
-
+    std::vector<Ort::Value> inputTensors;
     inputTensors.push_back(Ort::Value::CreateTensor<float>(
-        memoryInfo, inputTensorValues.data(), inputTensorSize,
+        memoryInfo, batchInput_.data(), batchInput_.size(),
         inputTensorShape.data(), inputTensorShape.size()
     ));
-    preprocess_timer.Stop();
-    Timer inference_timer = Timer(inference_time, verbose);
-    // 2. inference
+
+    // 2. inference: a single Run() for the whole batch
     std::vector<Ort::Value> outputTensors = forward(inputTensors);
-    inference_timer.Stop();
-    Timer postprocess_timer = Timer(postprocess_time, verbose);
-    // create container for the results
+
+    // 3. postprocess each image from its slice of the outputs
+    for (int b = 0; b < batch; ++b) {
+        batch_results[b] = postprocess(outputTensors, b, images[b].size(), conf, iou, mask_threshold);
+    }
+}
+
+
+std::vector<YoloResults> AutoBackendOnnx::postprocess(std::vector<Ort::Value>& outputTensors, int batch_index, const cv::Size& raw_size,
+    float& conf, float& iou, float& mask_threshold)
+{
     std::vector<YoloResults> results;
-    // 3. postprocess based on task:
-    std::unordered_map<int, std::string> names = this->getNames();
-    // 4. cleanup blob since it was created using the "new" keyword during the `fill_blob` func call
-    delete[] blob;
+    int class_names_num = this->getNames().size();
+    ImageInfo img_info = { raw_size };
 
-    int class_names_num = names.size();
-    if (task_ == YoloTasks::SEGMENT) {
+    // outputs are [bs, features, preds_num]; take the slice of this image and transpose it to [preds_num, features]
+    std::vector<int64_t> outputTensor0Shape = outputTensors[0].GetTensorTypeAndShapeInfo().GetShape();
+    const int64_t output0_stride = outputTensor0Shape[1] * outputTensor0Shape[2];
+    float* all_data0 = outputTensors[0].GetTensorMutableData<float>() + batch_index * output0_stride;
+    cv::Mat output0 = cv::Mat(cv::Size((int)outputTensor0Shape[2], (int)outputTensor0Shape[1]), CV_32F, all_data0).t();
 
-        // get outputs info
-        std::vector<int64_t> outputTensor0Shape = outputTensors[0].GetTensorTypeAndShapeInfo().GetShape();
+    if (task_ == YoloTasks::SEGMENT) {
         std::vector<int64_t> outputTensor1Shape = outputTensors[1].GetTensorTypeAndShapeInfo().GetShape();
-        // get outputs
-        float* all_data0 = outputTensors[0].GetTensorMutableData<float>();
-
-        cv::Mat output0 = cv::Mat(cv::Size((int)outputTensor0Shape[2], (int)outputTensor0Shape[1]), CV_32F, all_data0).t();  // [bs, features, preds_num]=>[bs, preds_num, features]
-        auto mask_shape = outputTensor1Shape;
-        std::vector<int> mask_sz = { 1,(int)mask_shape[1],(int)mask_shape[2],(int)mask_shape[3] };
-        cv::Mat output1 = cv::Mat(mask_sz, CV_32F, outputTensors[1].GetTensorMutableData<float>());
+        const int64_t output1_stride = outputTensor1Shape[1] * outputTensor1Shape[2] * outputTensor1Shape[3];
+        std::vector<int> mask_sz = { 1,(int)outputTensor1Shape[1],(int)outputTensor1Shape[2],(int)outputTensor1Shape[3] };
+        cv::Mat output1 = cv::Mat(mask_sz, CV_32F, outputTensors[1].GetTensorMutableData<float>() + batch_index * output1_stride);
 
         int iw = this->getWidth();
         int ih = this->getHeight();
         int mask_features_num = outputTensor1Shape[1];
         int mh = outputTensor1Shape[2];
         int mw = outputTensor1Shape[3];
-        ImageInfo img_info = { image.size() };
         postprocess_masks(output0, output1, img_info, results, class_names_num, conf, iou,
             iw, ih, mw, mh, mask_features_num, mask_threshold);
     }
     else if (task_ == YoloTasks::DETECT) {
-        ImageInfo img_info = { image.size() };
-        std::vector<int64_t> outputTensor0Shape = outputTensors[0].GetTensorTypeAndShapeInfo().GetShape();
-        float* all_data0 = outputTensors[0].GetTensorMutableData<float>();
-        cv::Mat output0 = cv::Mat(cv::Size((int)outputTensor0Shape[2], (int)outputTensor0Shape[1]), CV_32F, all_data0).t();  // [bs, features, preds_num]=>[bs, preds_num, features]
         postprocess_detects(output0, img_info, results, class_names_num, conf, iou);
     }
     else if (task_ == YoloTasks::POSE) {
-        ImageInfo image_info = { image.size() };
-        std::vector<int64_t> outputTensor0Shape = outputTensors[0].GetTensorTypeAndShapeInfo().GetShape();
-        float* all_data0 = outputTensors[0].GetTensorMutableData<float>();
-        cv::Mat output0 = cv::Mat(cv::Size((int)outputTensor0Shape[2], (int)outputTensor0Shape[1]), CV_32F, all_data0).t();  // [bs, features, preds_num]=>[bs, preds_num, features]
-        postprocess_kpts(output0, image_info, results, class_names_num, conf, iou);
+        postprocess_kpts(output0, img_info, results, class_names_num, conf, iou);
     }
     else {
         throw std::runtime_error("NotImplementedError: task: " + task_);
     }
-
-    postprocess_timer.Stop();
-    /*
-    if (verbose) {
-        std::cout << std::fixed << std::setprecision(1);
-        std::cout << "image: " << preprocessed_img.rows << "x" << preprocessed_img.cols << " " << results.size() << " objs, ";
-        std::cout << (preprocess_time + inference_time + postprocess_time) * 1000.0 << "ms" << std::endl;
-        std::cout << "Speed: " << (preprocess_time * 1000.0) << "ms preprocess, ";
-        std::cout << (inference_time * 1000.0) << "ms inference, ";
-        std::cout << (postprocess_time * 1000.0) << "ms postprocess per image ";
-        std::cout << "at shape (1, " << image.channels() << ", " << preprocessed_img.rows << ", " << preprocessed_img.cols << ")" << std::endl;
-    }
-*/
     return results;
 }
 
@@ -318,7 +407,7 @@ void AutoBackendOnnx::postprocess_masks(cv::Mat& output0, cv::Mat& output1, Imag
     std::vector<int> class_ids;
     std::vector<float> confidences;
     std::vector<cv::Rect> boxes;
-    std::vector<std::vector<float>> masks;
+    std::vector<const float*> masks;  // mask coefficients, pointing into output0
     // 4 - your default number of rect parameters {x, y, w, h}
     int data_width = class_names_num + 4 + masks_features_num;
     int rows = output0.rows;
@@ -331,7 +420,7 @@ void AutoBackendOnnx::postprocess_masks(cv::Mat& output0, cv::Mat& output1, Imag
         minMaxLoc(scores, 0, &max_conf, 0, &class_id);
         if (max_conf > conf_threshold)
         {
-            masks.push_back(std::vector<float>(pdata + 4 + class_names_num, pdata + data_width));
+            masks.push_back(pdata + 4 + class_names_num);
             class_ids.push_back(class_id.x);
             confidences.push_back(max_conf);
 
@@ -353,22 +442,35 @@ void AutoBackendOnnx::postprocess_masks(cv::Mat& output0, cv::Mat& output1, Imag
     std::vector<int> nms_result;
     cv::dnn::NMSBoxes(boxes, confidences, conf_threshold, iou_threshold, nms_result); // , nms_eta, top_k);
 
-    // select all of the protos tensor
-    cv::Size downsampled_size = cv::Size(mw, mh);
-    std::vector<cv::Range> roi_rangs = { cv::Range(0, 1), cv::Range::all(),
-                                         cv::Range(0, downsampled_size.height), cv::Range(0, downsampled_size.width) };
-    cv::Mat temp_mask = output1(roi_rangs).clone();
-    cv::Mat proto = temp_mask.reshape(0, { masks_features_num, downsampled_size.width * downsampled_size.height });
-
-    for (int i = 0; i < nms_result.size(); ++i)
+    // NMS stays class-agnostic as before; the class filter only decides which survivors get a mask
+    std::vector<int> masked;  // indices into output
+    for (int idx : nms_result)
     {
-        int idx = nms_result[i];
         boxes[idx] = boxes[idx] & cv::Rect(0, 0, image_info.raw_size.width, image_info.raw_size.height);
         YoloResults result = { class_ids[idx] ,confidences[idx] ,boxes[idx] };
-        _get_mask2(cv::Mat(masks[idx]).t(), proto, image_info, boxes[idx], result.mask, mask_threshold,
-            iw, ih, mw, mh, masks_features_num);
+        const bool wanted = maskClasses_.empty() ||
+            std::find(maskClasses_.begin(), maskClasses_.end(), class_ids[idx]) != maskClasses_.end();
+        if (wanted && !boxes[idx].empty()) {
+            masked.push_back((int)output.size());
+        }
         output.push_back(result);
     }
+    if (masked.empty()) {
+        return;
+    }
+
+    // one GEMM for every kept instance: [instances, nm] x [nm, mh * mw], protos used in place
+    cv::Mat coefficients((int)masked.size(), masks_features_num, CV_32F);
+    for (int k = 0; k < (int)masked.size(); ++k) {
+        std::memcpy(coefficients.ptr<float>(k), masks[nms_result[masked[k]]], masks_features_num * sizeof(float));
+    }
+    const cv::Mat proto(masks_features_num, mw * mh, CV_32F, output1.data);
+    cv::gemm(coefficients, proto, 1.0, cv::noArray(), 0.0, maskLogits_);
+
+    for (int k = 0; k < (int)masked.size(); ++k) {
+        _get_mask2(maskLogits_.row(k).reshape(1, mh), image_info, boxes[nms_result[masked[k]]], output[masked[k]].mask,
+            mask_threshold, iw, ih, mw, mh);
+    }
 }
 
 
@@ -456,42 +558,44 @@ void AutoBackendOnnx::postprocess_kpts(cv::Mat& output0, ImageInfo& image_info,
     }
 }
 
-void AutoBackendOnnx::_get_mask2(const cv::Mat& masks_features,
-    const cv::Mat& proto,
-    const ImageInfo& image_info, const cv::Rect bound, cv::Mat& mask_out,
-    float& mask_thresh, int& iw, int& ih, int& mw, int& mh, int& masks_features_num,
-    bool round_downsampled)
-
+void AutoBackendOnnx::_get_mask2(const cv::Mat& mask_logits, const ImageInfo& image_info, const cv::Rect bound,
+    cv::Mat& mask_out, float& mask_thresh, int& iw, int& ih, int& mw, int& mh)
 {
-    cv::Size img0_shape = image_info.raw_size;
-    cv::Size img1_shape = cv::Size(iw, ih);
-    cv::Size downsampled_size = cv::Size(mw, mh);
-
-    cv::Rect_<float> bound_float(
-        static_cast<float>(bound.x),
-        static_cast<float>(bound.y),
-        static_cast<float>(bound.width),
-        static_cast<float>(bound.height)
-    );
-
-    cv::Rect_<float> downsampled_bbox = scale_boxes(img0_shape, bound_float, downsampled_size);
-    cv::Size bound_size = cv::Size(mw, mh);
-    clip_boxes(downsampled_bbox, bound_size);
-
-    cv::Mat matmul_res = (masks_features * proto).t();
-    matmul_res = matmul_res.reshape(1, { downsampled_size.height, downsampled_size.width });
-    // apply sigmoid to the mask:
+    mask_out.release();
+    if (bound.empty()) {
+        return;
+    }
+    // frame -> proto coordinates: the letterbox placement used by predict_once()/predict_batch(), then the proto stride
+    const cv::Size img0_shape = image_info.raw_size;
+    const cv::Rect inner = letterbox_roi(img0_shape, cv::Size(iw, ih), false, false, true);
+    const double sx = static_cast<double>(inner.width) / img0_shape.width * mw / iw;
+    const double sy = static_cast<double>(inner.height) / img0_shape.height * mh / ih;
+    const double ox = static_cast<double>(inner.x) * mw / iw;
+    const double oy = static_cast<double>(inner.y) * mh / ih;
+
+    // proto position of frame pixel center u is (u + 0.5) * s + o - 0.5; the crop covers the box's first
+    // and last pixel centers plus the neighbour each bilinear tap needs
+    const int x0 = std::max(0, static_cast<int>(std::floor((bound.x + 0.5) * sx + ox - 0.5)));
+    const int y0 = std::max(0, static_cast<int>(std::floor((bound.y + 0.5) * sy + oy - 0.5)));
+    const int x1 = std::min(mw, static_cast<int>(std::floor((bound.x + bound.width - 0.5) * sx + ox - 0.5)) + 2);
+    const int y1 = std::min(mh, static_cast<int>(std::floor((bound.y + bound.height - 0.5) * sy + oy - 0.5)) + 2);
+    if (x1 <= x0 || y1 <= y0) {
+        mask_out = cv::Mat::zeros(bound.size(), CV_8U);
+        return;
+    }
+
+    // sigmoid over the footprint only
     cv::Mat sigmoid_mask;
-    exp(-matmul_res, sigmoid_mask);
+    cv::exp(-mask_logits(cv::Rect(x0, y0, x1 - x0, y1 - y0)), sigmoid_mask);
     sigmoid_mask = 1.0 / (1.0 + sigmoid_mask);
-    cv::Mat resized_mask;
-    cv::Rect_<float> input_bbox = scale_boxes(img0_shape, bound_float, img1_shape);
-    cv::resize(sigmoid_mask, resized_mask, img1_shape, 0, 0, cv::INTER_LANCZOS4);
-    cv::Mat pre_out_mask = resized_mask(input_bbox);
-    cv::Mat scaled_mask;
-    scale_image2(scaled_mask, resized_mask, img0_shape);
-    cv::resize(scaled_mask, mask_out, img0_shape);
-    mask_out = mask_out(bound) > mask_thresh;
+
+    // bilinear upsample of the crop straight to the box: dst(x, y) = crop((x + bound.x + 0.5) * s + o - 0.5 - crop origin)
+    const cv::Matx23d box_to_crop(sx, 0.0, (bound.x + 0.5) * sx + ox - 0.5 - x0,
+                                  0.0, sy, (bound.y + 0.5) * sy + oy - 0.5 - y0);
+    cv::Mat upsampled;
+    cv::warpAffine(sigmoid_mask, upsampled, box_to_crop, bound.size(), cv::INTER_LINEAR | cv::WARP_INVERSE_MAP,
+        cv::BORDER_REPLICATE);
+    mask_out = upsampled > mask_thresh;
 }
 
 
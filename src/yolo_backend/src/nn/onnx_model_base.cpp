@@ -22,15 +22,41 @@
  * @param[in] provider Provider (e.g., "CPU" or "CUDA"). (NOTE: for now only CPU is supported)
  */
 
-OnnxModelBase::OnnxModelBase(const char* modelPath, const char* logid, const char* provider)
+OnnxModelBase::OnnxModelBase(const char* modelPath, const char* logid, const char* provider, Ort::Env* sharedEnv,
+                             const OnnxSessionProfile& profile)
 //: modelPath_(modelPath), env(std::move(env)), session(std::move(session))
     : modelPath_(modelPath)
 {
 
     // TODO: too bad passing `ORT_LOGGING_LEVEL_WARNING` by default - for some cases
     //       info level would make sense too
-    env = Ort::Env(ORT_LOGGING_LEVEL_WARNING, logid);
     Ort::SessionOptions sessionOptions; // 세션 옵션 객체 생성
+    if (sharedEnv == nullptr) {
+        env = Ort::Env(ORT_LOGGING_LEVEL_WARNING, logid);
+    }
+    Ort::Env& sessionEnv = sharedEnv != nullptr ? *sharedEnv : env;
+
+    if (sharedEnv != nullptr && profile.intraOpThreads <= 0 && profile.interOpThreads <= 0) {
+        // 공유 Env의 전역 스레드 풀 사용 (Env가 CreateEnvWithGlobalThreadPools로 만들어져 있어야 함)
+        sessionOptions.DisablePerSessionThreads();
+    }
+    else {
+        if (profile.intraOpThreads > 0) sessionOptions.SetIntraOpNumThreads(profile.intraOpThreads);
+        if (profile.interOpThreads > 0) sessionOptions.SetInterOpNumThreads(profile.interOpThreads);
+    }
+    sessionOptions.SetGraphOptimizationLevel(profile.graphOptimization);
+    sessionOptions.SetExecutionMode(profile.executionMode);
+    if (profile.cpuMemArena) sessionOptions.EnableCpuMemArena();
+    else sessionOptions.DisableCpuMemArena();
+    if (profile.memPattern) sessionOptions.EnableMemPattern();
+    else sessionOptions.DisableMemPattern();
+    if (!profile.optimizedModelPath.empty()) {
+    #ifdef _WIN32
+        sessionOptions.SetOptimizedModelFilePath(get_win_path(profile.optimizedModelPath).c_str());
+    #else
+        sessionOptions.SetOptimizedModelFilePath(profile.optimizedModelPath.c_str());
+    #endif
+    }
 
     // provider 문자열을 비교하여 실행 장치를 설정합니다.
     std::string providerStr(provider); 
@@ -61,10 +87,10 @@ OnnxModelBase::OnnxModelBase(const char* modelPath, const char* logid, const cha
     
     #ifdef _WIN32
         auto modelPathW = get_win_path(modelPath);
-        session = Ort::Session(env, modelPathW.c_str(), sessionOptions);
+        session = Ort::Session(sessionEnv, modelPathW.c_str(), sessionOptions);
     #else
         // 설정된 sessionOptions를 사용하여 세션을 생성합니다.
-        session = Ort::Session(env, modelPath, sessionOptions);
+        session = Ort::Session(sessionEnv, modelPath, sessionOptions);
     #endif
     //session = Ort::Session(env)
     // https://github.com/microsoft/onnxruntime/issues/14157
@@ -1,7 +1,11 @@
+#include "utils/augment.h"
+
 #include <opencv2/core.hpp>
 #include <opencv2/imgproc.hpp>
 #include <opencv2/core/mat.hpp>
 #include <opencv2/core/types.hpp>
+#include <opencv2/core/hal/intrin.hpp>
+#include <vector>
 
 
 /**
@@ -10,21 +14,21 @@
 const int& DEFAULT_LETTERBOX_PAD_VALUE = 114;
 
 
-void letterbox(const cv::Mat& image,
-    cv::Mat& outImage,
-    const cv::Size& newShape,
-    cv::Scalar_<double> color,
-    bool auto_,
-    bool scaleFill,
-    bool scaleUp, int stride
-) {
-    cv::Size shape = image.size();
+namespace {
+
+// Size of the resized image inside the letterbox and the border on each side
+struct LetterboxGeometry {
+    cv::Size unpad;
+    int top, bottom, left, right;
+};
+
+LetterboxGeometry letterbox_geometry(const cv::Size& shape, const cv::Size& newShape, bool auto_, bool scaleFill,
+    bool scaleUp, int stride) {
     float r = std::min(static_cast<float>(newShape.height) / static_cast<float>(shape.height),
         static_cast<float>(newShape.width) / static_cast<float>(shape.width));
     if (!scaleUp)
         r = std::min(r, 1.0f);
 
-    float ratio[2]{ r, r };
     int newUnpad[2]{ static_cast<int>(std::round(static_cast<float>(shape.width) * r)),
                      static_cast<int>(std::round(static_cast<float>(shape.height) * r)) };
 
@@ -42,37 +46,143 @@ void letterbox(const cv::Mat& image,
         dh = 0.0f;
         newUnpad[0] = newShape.width;
         newUnpad[1] = newShape.height;
-        ratio[0] = static_cast<float>(newShape.width) / static_cast<float>(shape.width);
-        ratio[1] = static_cast<float>(newShape.height) / static_cast<float>(shape.height);
     }
 
     dw /= 2.0f;
     dh /= 2.0f;
 
+    LetterboxGeometry geometry;
+    geometry.unpad = cv::Size(newUnpad[0], newUnpad[1]);
+    geometry.top = static_cast<int>(std::round(dh - 0.1f));
+    geometry.bottom = static_cast<int>(std::round(dh + 0.1f));
+    geometry.left = static_cast<int>(std::round(dw - 0.1f));
+    geometry.right = static_cast<int>(std::round(dw + 0.1f));
+    return geometry;
+}
+
+#if CV_SIMD
+// Converts 8-bit channel values to floats scaled by `scale` (same rounding as Mat::convertTo to CV_32F)
+inline void store_scaled(const cv::v_uint8& x, const cv::v_float32& scale, float* dst) {
+    constexpr int kLanes32 = CV_SIMD_WIDTH / 4;
+    cv::v_uint16 lo, hi;
+    cv::v_expand(x, lo, hi);
+    cv::v_uint32 q0, q1, q2, q3;
+    cv::v_expand(lo, q0, q1);
+    cv::v_expand(hi, q2, q3);
+    cv::v_store(dst, cv::v_mul(cv::v_cvt_f32(cv::v_reinterpret_as_s32(q0)), scale));
+    cv::v_store(dst + kLanes32, cv::v_mul(cv::v_cvt_f32(cv::v_reinterpret_as_s32(q1)), scale));
+    cv::v_store(dst + 2 * kLanes32, cv::v_mul(cv::v_cvt_f32(cv::v_reinterpret_as_s32(q2)), scale));
+    cv::v_store(dst + 3 * kLanes32, cv::v_mul(cv::v_cvt_f32(cv::v_reinterpret_as_s32(q3)), scale));
+}
+#endif
+
+} // namespace
+
+
+void letterbox(const cv::Mat& image,
+    cv::Mat& outImage,
+    const cv::Size& newShape,
+    cv::Scalar_<double> color,
+    bool auto_,
+    bool scaleFill,
+    bool scaleUp, int stride
+) {
+    const cv::Size shape = image.size();
+    const LetterboxGeometry geometry = letterbox_geometry(shape, newShape, auto_, scaleFill, scaleUp, stride);
+
     //cv::Mat outImage;
-    if (shape.width != newUnpad[0] || shape.height != newUnpad[1])
+    if (shape != geometry.unpad)
     {
-        cv::resize(image, outImage, cv::Size(newUnpad[0], newUnpad[1]));
+        cv::resize(image, outImage, geometry.unpad);
     }
     else
     {
         outImage = image.clone();
     }
 
-    int top = static_cast<int>(std::round(dh - 0.1f));
-    int bottom = static_cast<int>(std::round(dh + 0.1f));
-    int left = static_cast<int>(std::round(dw - 0.1f));
-    int right = static_cast<int>(std::round(dw + 0.1f));
+    if (color == cv::Scalar()) {
+        color = cv::Scalar(DEFAULT_LETTERBOX_PAD_VALUE, DEFAULT_LETTERBOX_PAD_VALUE, DEFAULT_LETTERBOX_PAD_VALUE);
+    }
+
+    cv::copyMakeBorder(outImage, outImage, geometry.top, geometry.bottom, geometry.left, geometry.right,
+        cv::BORDER_CONSTANT, color);
+
+}
+
+cv::Rect letterbox_roi(const cv::Size& shape, const cv::Size& newShape, bool auto_, bool scaleFill, bool scaleUp,
+    int stride) {
+    const LetterboxGeometry geometry = letterbox_geometry(shape, newShape, auto_, scaleFill, scaleUp, stride);
+    return cv::Rect(cv::Point(geometry.left, geometry.top), geometry.unpad);
+}
+
 
+cv::Size LetterboxBlob::run(const cv::Mat& image, float* blob, const cv::Size& newShape, cv::Scalar_<double> color,
+    bool auto_, bool scaleFill, bool scaleUp, int stride) {
+    const LetterboxGeometry geometry = letterbox_geometry(image.size(), newShape, auto_, scaleFill, scaleUp, stride);
+    const cv::Size outSize(geometry.unpad.width + geometry.left + geometry.right,
+                           geometry.unpad.height + geometry.top + geometry.bottom);
+    const float scale = static_cast<float>(1.0 / 255.0);  // the value convertTo(..., 1.0 / 255.0) uses
+
+    if (image.type() != CV_8UC3) {
+        // uncommon inputs take the reference path: letterbox, convertTo, split
+        letterbox(image, canvas_, newShape, color, auto_, scaleFill, scaleUp, stride);
+        cv::Mat floatImage;
+        canvas_.convertTo(floatImage, CV_MAKETYPE(CV_32F, canvas_.channels()), scale);
+        std::vector<cv::Mat> planes(canvas_.channels());
+        for (int c = 0; c < canvas_.channels(); ++c) {
+            planes[c] = cv::Mat(outSize, CV_32FC1, blob + c * outSize.area());
+        }
+        cv::split(floatImage, planes);
+        roi_ = cv::Rect();  // canvas_ no longer holds a border
+        return outSize;
+    }
 
+    // 1. resize straight into the padded canvas; the border only needs filling when the geometry changes
     if (color == cv::Scalar()) {
         color = cv::Scalar(DEFAULT_LETTERBOX_PAD_VALUE, DEFAULT_LETTERBOX_PAD_VALUE, DEFAULT_LETTERBOX_PAD_VALUE);
     }
+    const cv::Rect roi(geometry.left, geometry.top, geometry.unpad.width, geometry.unpad.height);
+    if (canvas_.size() != outSize || canvas_.type() != CV_8UC3 || roi != roi_ || color != color_) {
+        canvas_.create(outSize, CV_8UC3);
+        canvas_.setTo(color);
+        roi_ = roi;
+        color_ = color;
+    }
+    cv::Mat inner = canvas_(roi);
+    if (image.size() != geometry.unpad) {
+        cv::resize(image, inner, geometry.unpad);
+    }
+    else {
+        image.copyTo(inner);
+    }
 
-    cv::copyMakeBorder(outImage, outImage, top, bottom, left, right, cv::BORDER_CONSTANT, color);
-
+    // 2. one pass over the canvas: deinterleave HWC, scale by 1/255 and store planar CHW
+    const int total = outSize.area();
+    const uchar* src = canvas_.ptr<uchar>();
+    float* p0 = blob;
+    float* p1 = blob + total;
+    float* p2 = blob + 2 * total;
+    int i = 0;
+#if CV_SIMD
+    constexpr int kLanes8 = CV_SIMD_WIDTH;
+    const cv::v_float32 v_scale = cv::vx_setall_f32(scale);
+    for (; i <= total - kLanes8; i += kLanes8) {
+        cv::v_uint8 c0, c1, c2;
+        cv::v_load_deinterleave(src + 3 * i, c0, c1, c2);
+        store_scaled(c0, v_scale, p0 + i);
+        store_scaled(c1, v_scale, p1 + i);
+        store_scaled(c2, v_scale, p2 + i);
+    }
+#endif
+    for (; i < total; ++i) {
+        p0[i] = src[3 * i] * scale;
+        p1[i] = src[3 * i + 1] * scale;
+        p2[i] = src[3 * i + 2] * scale;
+    }
+    return outSize;
 }
 
+
 cv::Mat scale_image(const cv::Mat& resized_mask, const cv::Size& im0_shape, const std::pair<float, cv::Point2f>& ratio_pad) {
     cv::Size im1_shape = resized_mask.size();
 
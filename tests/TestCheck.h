@@ -0,0 +1,39 @@
+#pragma once
+
+#include <iostream>
+
+// 검사 실행 파일용 최소 매크로. 실패하면 위치와 식을 출력하고 test_exit_code()가 1을 돌려줍니다.
+// 실행 파일 하나가 검사 하나이며 ctest가 종료 코드로 성공/실패를 판단합니다.
+
+inline int& test_failures() {
+    static int failures = 0;
+    return failures;
+}
+
+#define CHECK(cond)                                                                              \
+    do {                                                                                         \
+        if (!(cond)) {                                                                           \
+            std::cerr << "[FAIL] " << __FILE__ << ":" << __LINE__ << ": " << #cond << std::endl; \
+            ++test_failures();                                                                   \
+        }                                                                                        \
+    } while (0)
+
+#define CHECK_EQ(a, b)                                                                            \
+    do {                                                                                          \
+        const auto& check_a_ = (a);                                                               \
+        const auto& check_b_ = (b);                                                               \
+        if (!(check_a_ == check_b_)) {                                                            \
+            std::cerr << "[FAIL] " << __FILE__ << ":" << __LINE__ << ": " << #a << " == " << #b   \
+                      << " (" << check_a_ << " != " << check_b_ << ")" << std::endl;              \
+            ++test_failures();                                                                    \
+        }                                                                                         \
+    } while (0)
+
+inline int test_exit_code(const char* name) {
+    if (test_failures() == 0) {
+        std::cout << "[PASS] " << name << std::endl;
+        return 0;
+    }
+    std::cerr << "[FAIL] " << name << ": 실패 " << test_failures() << "건" << std::endl;
+    return 1;
+}
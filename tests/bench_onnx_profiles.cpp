@@ -0,0 +1,107 @@
+#include "segmenter.h"
+#include "InferenceThreadPool.h"
+
+#include <unistd.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// segmenter(ONNX Runtime) 세션 프로필별 로드 시간과 프레임당 추론 시간을 비교하는 벤치마크.
+// 모델 파일이 필요해 ctest에는 넣지 않고 직접 실행합니다.
+//
+//   bench_onnx_profiles <모델.onnx> [반복 횟수=20] [추론 스레드 수=4]
+//
+// 비교 항목 (설정 파일 기본값 models.onnx에서 한 항목씩 바꿈)
+//  - 그래프 최적화 수준: disabled / basic / extended / all
+//  - CPU 메모리 arena와 mem pattern 끔
+//  - 공유 Env의 전역 스레드 풀 / 세션 전용 스레드 풀 / parallel 실행
+//  - 최적화 그래프 캐시: 빈 캐시 디렉터리로 처음 로드(miss)와 그 캐시로 다시 로드(hit)
+namespace fs = std::filesystem;
+
+namespace {
+
+struct Profile {
+    std::string name;
+    OnnxSessionConfig config;
+};
+
+std::vector<Profile> make_profiles(const std::string& cache_dir, int threads) {
+    // 캐시 항목 말고는 캐시 없이 만들어 매번 그래프 최적화까지 잼
+    OnnxSessionConfig base;
+    base.optimized_model_dir.clear();
+
+    std::vector<Profile> profiles;
+    for (const char* level : {"disabled", "basic", "extended", "all"}) {
+        profiles.push_back({std::string("최적화 ") + level, base});
+        profiles.back().config.graph_optimization = level;
+    }
+    profiles.push_back({"arena/mem pattern 끔", base});
+    profiles.back().config.cpu_mem_arena = false;
+    profiles.back().config.mem_pattern = false;
+    profiles.push_back({"전역 스레드 풀", base});
+    profiles.push_back({"세션 전용 스레드", base});
+    profiles.back().config.intra_op_threads = threads;
+    profiles.push_back({"parallel 실행", base});
+    profiles.back().config.intra_op_threads = threads;
+    profiles.back().config.inter_op_threads = 2;
+    profiles.back().config.execution_mode = "parallel";
+    // 같은 캐시 디렉터리를 두 번: 첫 번째는 최적화 후 저장, 두 번째는 저장된 그래프를 최적화 없이 읽음
+    OnnxSessionConfig cached;
+    cached.optimized_model_dir = cache_dir;
+    profiles.push_back({"캐시 miss", cached});
+    profiles.push_back({"캐시 hit", cached});
+    return profiles;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        std::cerr << "사용법: " << argv[0] << " <모델.onnx> [반복 횟수=20] [추론 스레드 수=4]" << std::endl;
+        return 1;
+    }
+    const std::string model_path = argv[1];
+    if (!fs::is_regular_file(model_path)) {
+        std::cout << "[INFO] 모델 파일이 없어 벤치마크를 건너뜁니다: " << model_path << std::endl;
+        return 0;
+    }
+    const int iterations = argc > 2 ? std::max(1, std::atoi(argv[2])) : 20;
+    InferenceConfig inference;
+    if (argc > 3) inference.threads = std::max(1, std::atoi(argv[3]));
+    InferenceThreadPool::configure(inference);
+
+    const fs::path cache_dir = fs::temp_directory_path() / ("bench_onnx_profiles_" + std::to_string(getpid()));
+    fs::remove_all(cache_dir);
+
+    cv::Mat frame(cv::Size(640, 480), CV_8UC3);
+    cv::randu(frame, cv::Scalar::all(0), cv::Scalar::all(256));
+
+    std::cout << std::fixed << std::setprecision(1);
+    for (const Profile& profile : make_profiles(cache_dir.string(), inference.threads)) {
+        try {
+            // 로드 시간은 세션 생성(캐시 hit이면 파일 읽기만, miss면 최적화와 저장까지)과 클래스 메타데이터 확인
+            const auto load_started = std::chrono::steady_clock::now();
+            Segmenter segmenter(model_path, profile.config);
+            const double load_ms =
+                std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - load_started).count();
+
+            segmenter.segment(frame); // 첫 Run()의 할당은 제외
+            const auto started = std::chrono::steady_clock::now();
+            for (int i = 0; i < iterations; ++i) segmenter.segment(frame);
+            const double run_ms =
+                std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - started).count() / iterations;
+            std::cout << "[INFO] 세션 프로필 (" << profile.name << "): 로드 " << load_ms << " ms, 프레임당 " << run_ms
+                      << " ms (" << iterations << "회)" << std::endl;
+        } catch (const std::exception& e) {
+            std::cerr << "[WARN] 세션 프로필 (" << profile.name << ") 실패: " << e.what() << std::endl;
+        }
+    }
+
+    fs::remove_all(cache_dir);
+    return 0;
+}
@@ -0,0 +1,46 @@
+#include "FramePool.h"
+#include "TestCheck.h"
+
+#include <deque>
+
+// 캡처 단계처럼 한 스레드에서 acquire하고, 큐와 단계가 프레임을 붙잡았다 놓는 상황을 흉내 냅니다.
+// 워밍업 뒤에는 버퍼를 새로 할당하지 않고, 버퍼 수는 동시에 살아 있는 프레임 수를 넘지 않아야 합니다.
+int main() {
+    constexpr int kInFlight = 6; // 추론 큐 1 + 렌더 큐 4 + 처리 중인 프레임 1
+    constexpr int kRows = 480 * 3 / 2;
+    constexpr int kCols = 640;
+
+    FramePool pool;
+    std::deque<Frame> in_flight;
+    auto step = [&](int rows, int cols) {
+        Frame frame;
+        pool.acquire(frame, rows, cols, CV_8UC1);
+        CHECK_EQ(frame.image.rows, rows);
+        CHECK_EQ(frame.image.cols, cols);
+        frame.image.setTo(cv::Scalar::all(0)); // 버퍼에 실제로 쓸 수 있는지
+        in_flight.push_back(std::move(frame));
+        if (in_flight.size() > static_cast<size_t>(kInFlight)) in_flight.pop_front();
+    };
+
+    for (int i = 0; i < kInFlight * 2; ++i) step(kRows, kCols);
+    const FramePoolStats warm = pool.stats();
+    CHECK(warm.buffers <= static_cast<size_t>(kInFlight + 1));
+    CHECK_EQ(warm.allocations, static_cast<uint64_t>(warm.buffers));
+
+    for (int i = 0; i < 1000; ++i) step(kRows, kCols);
+    const FramePoolStats steady = pool.stats();
+    CHECK_EQ(steady.allocations, warm.allocations);
+    CHECK_EQ(steady.buffers, warm.buffers);
+
+    // 모든 프레임을 놓으면 버퍼가 풀로 돌아와 다시 할당 없이 쓰임
+    in_flight.clear();
+    step(kRows, kCols);
+    CHECK_EQ(pool.stats().allocations, warm.allocations);
+
+    // 해상도가 바뀌면 그 버퍼만 다시 할당
+    in_flight.clear();
+    step(kRows / 2, kCols / 2);
+    CHECK_EQ(pool.stats().allocations, warm.allocations + 1);
+
+    return test_exit_code("test_frame_pool");
+}
@@ -0,0 +1,74 @@
+#include "ImageConditioner.h"
+#include "YuvImage.h"
+#include "TestCheck.h"
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+
+// fused 커널(3x3 블러 + LUT 한 번에, SIMD)이 기존 cv::GaussianBlur + cv::LUT 경로와
+// 픽셀마다 최대 1(고정소수점 반올림 차이)까지만 다른지 확인하고, 두 커널의 프레임당 시간을 출력합니다.
+namespace {
+
+constexpr int kIterations = 100;
+
+double max_abs_diff(const cv::Mat& a, const cv::Mat& b) {
+    cv::Mat diff;
+    cv::absdiff(a, b, diff);
+    double max_diff = 0.0;
+    cv::minMaxLoc(diff.reshape(1), nullptr, &max_diff);
+    return max_diff;
+}
+
+double time_apply(ImageConditioner& conditioner, const cv::Mat& src, PixelFormat format, cv::Mat& dst) {
+    conditioner.apply(src, format, dst); // 워밍업 (버퍼 할당)
+    const auto started = std::chrono::steady_clock::now();
+    for (int i = 0; i < kIterations; ++i) conditioner.apply(src, format, dst);
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - started).count() / kIterations;
+}
+
+void check_format(const cv::Size& size, PixelFormat format, const char* name) {
+    cv::Mat bgr(size, CV_8UC3);
+    cv::randu(bgr, cv::Scalar::all(0), cv::Scalar::all(256));
+    cv::Mat src;
+    if (format == PixelFormat::Bgr) {
+        src = bgr;
+    } else {
+        bgr_to_yuv420(bgr, format, src);
+    }
+
+    struct Curve { int beta; double contrast; double gamma; };
+    const Curve curves[] = {{0, 1.0, 1.0}, {20, 1.0, 1.0}, {-30, 1.3, 1.0}, {10, 0.8, 1.8}};
+    for (const Curve& curve : curves) {
+        ImageConditioner fused(ImageConditioner::Kernel::Fused);
+        ImageConditioner reference(ImageConditioner::Kernel::OpenCv);
+        fused.set_curve(curve.beta, curve.contrast, curve.gamma);
+        reference.set_curve(curve.beta, curve.contrast, curve.gamma);
+
+        cv::Mat fused_out, reference_out;
+        const double fused_ms = time_apply(fused, src, format, fused_out);
+        const double reference_ms = time_apply(reference, src, format, reference_out);
+        CHECK(fused_out.size() == reference_out.size());
+        CHECK_EQ(fused_out.type(), reference_out.type());
+        const double max_diff = max_abs_diff(fused_out, reference_out);
+        CHECK(max_diff <= 1.0);
+
+        std::cout << name << " " << size.width << "x" << size.height << " beta=" << curve.beta
+                  << " contrast=" << curve.contrast << " gamma=" << curve.gamma << ": " << std::fixed
+                  << std::setprecision(3) << "fused " << fused_ms << " ms, opencv " << reference_ms
+                  << " ms, 최대 픽셀 차이 " << max_diff << std::endl;
+        std::cout.unsetf(std::ios::fixed);
+    }
+}
+
+} // namespace
+
+int main() {
+    check_format(cv::Size(640, 480), PixelFormat::Bgr, "BGR");
+    check_format(cv::Size(640, 480), PixelFormat::I420, "I420");
+    check_format(cv::Size(640, 480), PixelFormat::Nv12, "NV12");
+    // SIMD 폭의 배수가 아닌 너비 (행 끝 스칼라 처리)
+    check_format(cv::Size(333, 242), PixelFormat::Bgr, "BGR");
+    check_format(cv::Size(334, 242), PixelFormat::I420, "I420");
+    return test_exit_code("test_image_conditioner");
+}
@@ -0,0 +1,135 @@
+#include "InputQuantizer.h"
+#include "YuvImage.h"
+#include "TestCheck.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+// InputQuantizer(프레임 → int8 입력 텐서 한 번에)를 예전 전처리 경로와 비교합니다.
+//  - BGR: cv::resize(INTER_LINEAR) → cv::cvtColor(BGR2RGB) → 바이트마다 round/clamp 양자화.
+//    리샘플 고정소수점 반올림이 OpenCV와 달라 1 LSB까지 허용
+//  - I420/NV12: yuv420_resize_to_rgb → 같은 양자화. 리샘플러를 함께 쓰므로 비트 단위로 같아야 함
+// 전체 프레임과 구역 크롭, 홀수 크기의 프레임/크롭/출력, 양자화 파라미터 두 가지를 확인하고
+// 두 경로의 호출당 시간을 출력합니다.
+namespace {
+
+constexpr int kIterations = 50;
+
+struct Quantization {
+    float scale;
+    int zero_point;
+};
+
+// 예전 Detector::quantize_input과 같은 스칼라 양자화
+void quantize_reference(const cv::Mat& rgb, const Quantization& q, std::vector<int8_t>& out) {
+    const size_t count = rgb.total() * rgb.channels();
+    out.resize(count);
+    for (size_t i = 0; i < count; ++i) {
+        const float normalized = static_cast<float>(rgb.data[i]) / 255.0f;
+        const int32_t quant = static_cast<int32_t>(std::round(normalized / q.scale + q.zero_point));
+        out[i] = static_cast<int8_t>(std::max(-128, std::min(quant, 127)));
+    }
+}
+
+void reference_path(const cv::Mat& image, PixelFormat format, const cv::Rect& roi, const cv::Size& out_size,
+                    const Quantization& q, std::vector<int8_t>& out) {
+    cv::Mat rgb;
+    if (format == PixelFormat::Bgr) {
+        cv::Mat resized;
+        cv::resize(image(roi), resized, out_size);
+        cv::cvtColor(resized, rgb, cv::COLOR_BGR2RGB);
+    } else {
+        yuv420_resize_to_rgb(image, format, roi, out_size, rgb);
+    }
+    quantize_reference(rgb, q, out);
+}
+
+int max_diff(const std::vector<int8_t>& a, const std::vector<int8_t>& b) {
+    int diff = 0;
+    for (size_t i = 0; i < a.size(); ++i) diff = std::max(diff, std::abs(a[i] - b[i]));
+    return diff;
+}
+
+void check_case(const cv::Mat& image, PixelFormat format, const char* name, const cv::Rect& roi,
+                const cv::Size& out_size, const Quantization& q) {
+    InputQuantizer quantizer;
+    quantizer.configure(q.scale, q.zero_point);
+    FrameRegion region;
+    region.image = &image;
+    region.format = format;
+    region.roi = roi;
+
+    std::vector<int8_t> expected;
+    reference_path(image, format, roi, out_size, q, expected);
+    std::vector<int8_t> actual(static_cast<size_t>(out_size.area()) * 3);
+    quantizer.write(region, out_size, actual.data());
+
+    const int diff = max_diff(expected, actual);
+    const int tolerance = format == PixelFormat::Bgr ? 1 : 0;
+    CHECK(diff <= tolerance);
+
+    auto time_ms = [](auto&& fn) {
+        const auto started = std::chrono::steady_clock::now();
+        for (int i = 0; i < kIterations; ++i) fn();
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - started).count() / kIterations;
+    };
+    const double reference_ms = time_ms([&] { reference_path(image, format, roi, out_size, q, expected); });
+    const double quantizer_ms = time_ms([&] { quantizer.write(region, out_size, actual.data()); });
+    std::cout << name << " " << roi.width << "x" << roi.height << "+" << roi.x << "+" << roi.y << " -> "
+              << out_size.width << "x" << out_size.height << " (scale " << q.scale << ", zp " << q.zero_point
+              << "): 최대 차이 " << diff << ", 예전 " << std::fixed << std::setprecision(3) << reference_ms
+              << " ms, InputQuantizer " << quantizer_ms << " ms" << std::endl;
+    std::cout.unsetf(std::ios::fixed);
+}
+
+void check_format(const cv::Size& size, PixelFormat format, const char* name) {
+    cv::Mat bgr(size, CV_8UC3);
+    cv::randu(bgr, cv::Scalar::all(0), cv::Scalar::all(256));
+    // 무작위 잡음만으로는 보간 차이가 드러나지 않는 매끄러운 영역도 섞음
+    cv::Mat left = bgr(cv::Rect(0, 0, size.width / 2, size.height));
+    cv::GaussianBlur(left.clone(), left, cv::Size(15, 15), 0);
+    cv::Mat image;
+    if (format == PixelFormat::Bgr) {
+        image = bgr;
+    } else {
+        bgr_to_yuv420(bgr, format, image);
+    }
+
+    const cv::Rect full(0, 0, size.width, size.height);
+    const cv::Rect crop(size.width / 5 + 1, size.height / 7 + 1, size.width / 3 + 1, size.height / 2 + 1);
+    const cv::Rect small_crop(size.width - 61, size.height - 45, 61, 45); // 출력보다 작은 크롭 (확대)
+    for (const Quantization& q : {Quantization{1.0f / 255.0f, -128}, Quantization{0.0078125f, -1}}) {
+        check_case(image, format, name, full, cv::Size(192, 192), q);
+        check_case(image, format, name, crop, cv::Size(192, 192), q);
+        check_case(image, format, name, small_crop, cv::Size(97, 61), q);
+    }
+}
+
+} // namespace
+
+int main() {
+    // LUT는 예전 스칼라 양자화와 모든 입력 값에서 같아야 함
+    for (const Quantization& q : {Quantization{1.0f / 255.0f, -128}, Quantization{0.0078125f, -1}}) {
+        InputQuantizer quantizer;
+        quantizer.configure(q.scale, q.zero_point);
+        cv::Mat values(1, 256, CV_8UC1);
+        for (int i = 0; i < 256; ++i) values.at<uchar>(0, i) = static_cast<uchar>(i);
+        std::vector<int8_t> expected;
+        quantize_reference(values, q, expected);
+        CHECK(std::equal(expected.begin(), expected.end(), quantizer.lut()));
+    }
+
+    check_format(cv::Size(640, 480), PixelFormat::Bgr, "BGR");
+    check_format(cv::Size(641, 479), PixelFormat::Bgr, "BGR");
+    check_format(cv::Size(640, 480), PixelFormat::I420, "I420");
+    check_format(cv::Size(640, 480), PixelFormat::Nv12, "NV12");
+    // YUV 420 프레임은 짝수 크기만 있으므로 홀수는 크롭 위치/크기와 출력 크기로 확인
+    check_format(cv::Size(334, 242), PixelFormat::I420, "I420");
+    check_format(cv::Size(334, 242), PixelFormat::Nv12, "NV12");
+    return test_exit_code("test_input_quantizer");
+}
@@ -0,0 +1,80 @@
+#include "utils/augment.h"
+#include "TestCheck.h"
+
+#include <opencv2/dnn.hpp>
+#include <opencv2/imgproc.hpp>
+#include <chrono>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+// 융합 전처리 커널(LetterboxBlob)이 기존 경로(letterbox → cv::dnn::blobFromImage 1/255)와 비트 단위로
+// 같은 CHW 텐서를 쓰는지 확인하고 두 경로의 프레임당 시간을 출력합니다.
+// 커널 객체 하나를 모든 경우에 재사용해 테두리 캐시가 기하 변경 때 다시 채워지는지도 확인합니다.
+namespace {
+
+constexpr int kIterations = 50;
+
+// 같은 커널로 여러 번 돌려도(테두리 재사용) 결과가 기존 경로와 같은지 확인
+void check_case(LetterboxBlob& kernel, const cv::Size& image_size, int type, const cv::Size& new_shape, bool auto_,
+                const char* name) {
+    cv::Mat image(image_size, type);
+    cv::Mat letterboxed, reference;
+    std::vector<float> fused(static_cast<size_t>(CV_MAT_CN(type)) * new_shape.area());
+
+    for (int round = 0; round < 2; ++round) {
+        cv::randu(image, cv::Scalar::all(0), cv::Scalar::all(256));
+        letterbox(image, letterboxed, new_shape, cv::Scalar(), auto_, false, true, 32);
+        reference = cv::dnn::blobFromImage(letterboxed, 1.0 / 255.0, cv::Size(), cv::Scalar(), false, false, CV_32F);
+
+        std::fill(fused.begin(), fused.end(), -1.0f);
+        const cv::Size out_size = kernel.run(image, fused.data(), new_shape, cv::Scalar(), auto_, false, true, 32);
+        CHECK(out_size == letterboxed.size());
+        CHECK_EQ(reference.total(), static_cast<size_t>(letterboxed.channels()) * out_size.area());
+        if (reference.total() > fused.size()) continue;
+
+        size_t mismatches = 0;
+        const float* expected = reference.ptr<float>();
+        for (size_t i = 0; i < reference.total(); ++i) {
+            if (std::memcmp(&fused[i], &expected[i], sizeof(float)) != 0) ++mismatches;
+        }
+        CHECK_EQ(mismatches, static_cast<size_t>(0));
+    }
+
+    auto measure = [&](auto&& run) {
+        const auto started = std::chrono::steady_clock::now();
+        for (int i = 0; i < kIterations; ++i) run();
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - started).count() / kIterations;
+    };
+    const double reference_ms = measure([&] {
+        letterbox(image, letterboxed, new_shape, cv::Scalar(), auto_, false, true, 32);
+        reference = cv::dnn::blobFromImage(letterboxed, 1.0 / 255.0, cv::Size(), cv::Scalar(), false, false, CV_32F);
+    });
+    const double fused_ms = measure([&] {
+        kernel.run(image, fused.data(), new_shape, cv::Scalar(), auto_, false, true, 32);
+    });
+    std::cout << name << " " << image_size.width << "x" << image_size.height << " -> " << new_shape.width << "x"
+              << new_shape.height << (auto_ ? " (auto)" : "") << ": " << std::fixed << std::setprecision(3)
+              << "기존 " << reference_ms << " ms, 융합 커널 " << fused_ms << " ms" << std::endl;
+    std::cout.unsetf(std::ios::fixed);
+}
+
+} // namespace
+
+int main() {
+    LetterboxBlob kernel;
+    const cv::Size input(640, 640);
+    check_case(kernel, cv::Size(640, 480), CV_8UC3, input, false, "가로");
+    check_case(kernel, cv::Size(480, 640), CV_8UC3, input, false, "세로");
+    check_case(kernel, cv::Size(640, 640), CV_8UC3, input, false, "같은 크기");
+    check_case(kernel, cv::Size(1920, 1080), CV_8UC3, input, false, "축소");
+    check_case(kernel, cv::Size(320, 240), CV_8UC3, input, false, "확대");
+    // SIMD 폭의 배수가 아닌 크기 (끝 스칼라 처리)
+    check_case(kernel, cv::Size(333, 517), CV_8UC3, cv::Size(320, 320), false, "홀수 크기");
+    check_case(kernel, cv::Size(640, 480), CV_8UC3, input, true, "가로");
+    // 8UC3가 아니면 기존 경로로 돌아감. 그 뒤 다시 8UC3로 와도 테두리를 새로 채워야 함
+    check_case(kernel, cv::Size(640, 480), CV_8UC1, input, false, "회색조");
+    check_case(kernel, cv::Size(640, 480), CV_8UC3, input, false, "가로");
+    return test_exit_code("test_letterbox_blob");
+}
@@ -0,0 +1,80 @@
+#include "ModelCache.h"
+#include "TestCheck.h"
+
+#include <unistd.h>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+
+// prepare_cache_file의 캐시 파일 이름과 정리 규칙을 임시 디렉터리에서 확인합니다.
+//  - 설정 키(최적화 수준 등)가 다르거나 경로가 다른 같은 이름의 모델은 서로의 캐시를 지우지 않음
+//  - 같은 경로, 같은 키에서 모델 내용만 바뀌면 예전 캐시를 지움
+namespace fs = std::filesystem;
+
+namespace {
+
+void touch(const std::string& path) { std::ofstream(path) << "cache"; }
+
+bool exists(const std::string& path) { return !path.empty() && fs::exists(path); }
+
+} // namespace
+
+int main() {
+    const fs::path root = fs::temp_directory_path() / ("test_model_cache_" + std::to_string(getpid()));
+    fs::remove_all(root);
+    const std::string cache_dir = (root / "cache").string();
+    const std::string model_a = (root / "a" / "yolo.onnx").string();
+    const std::string model_b = (root / "b" / "yolo.onnx").string();
+    const std::string suffix = ".opt.onnx";
+    bool hit = true;
+
+    // 처음에는 없음, 만든 뒤에는 같은 경로로 hit
+    const std::string all_v1 = prepare_cache_file(cache_dir, model_a, "ort/all", 1, suffix, hit);
+    CHECK(!all_v1.empty());
+    CHECK(!hit);
+    touch(all_v1);
+    CHECK_EQ(prepare_cache_file(cache_dir, model_a, "ort/all", 1, suffix, hit), all_v1);
+    CHECK(hit);
+
+    // 최적화 수준이 다른 캐시는 다른 파일이고, 만들 때 기존 캐시를 지우지 않음
+    const std::string basic_v1 = prepare_cache_file(cache_dir, model_a, "ort/basic", 1, suffix, hit);
+    CHECK(!hit);
+    CHECK(basic_v1 != all_v1);
+    touch(basic_v1);
+    CHECK(exists(all_v1));
+
+    // 다른 디렉터리의 같은 이름(같은 내용) 모델도 따로 캐시
+    const std::string other_dir = prepare_cache_file(cache_dir, model_b, "ort/all", 1, suffix, hit);
+    CHECK(!hit);
+    CHECK(other_dir != all_v1);
+    touch(other_dir);
+    CHECK(exists(all_v1));
+    CHECK(exists(basic_v1));
+
+    // 모델 내용이 바뀌면 같은 키의 예전 캐시만 지움
+    const std::string all_v2 = prepare_cache_file(cache_dir, model_a, "ort/all", 2, suffix, hit);
+    CHECK(!hit);
+    CHECK(all_v2 != all_v1);
+    CHECK(!exists(all_v1));
+    CHECK(exists(basic_v1));
+    CHECK(exists(other_dir));
+
+    // 상대 경로로 열어도 같은 파일이면 같은 캐시
+    const fs::path cwd = fs::current_path();
+    fs::create_directories(root / "a");
+    fs::current_path(root);
+    touch(all_v2);
+    CHECK_EQ(prepare_cache_file(cache_dir, "a/yolo.onnx", "ort/all", 2, suffix, hit), all_v2);
+    CHECK(hit);
+    fs::current_path(cwd);
+
+    // 다른 suffix의 파일은 건드리지 않음
+    const std::string other_suffix = prepare_cache_file(cache_dir, model_a, "ort/all", 2, ".other", hit);
+    touch(other_suffix);
+    prepare_cache_file(cache_dir, model_a, "ort/all", 3, suffix, hit);
+    CHECK(exists(other_suffix));
+    CHECK(!exists(all_v2));
+
+    fs::remove_all(root);
+    return test_exit_code("test_model_cache");
+}
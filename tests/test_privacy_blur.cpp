@@ -0,0 +1,145 @@
+#include "PrivacyBlur.h"
+#include "YuvImage.h"
+#include "TestCheck.h"
+
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+
+// blur 모드 렌더러(PrivacyBlur)의 세 방식을 붐비는 합성 장면(서로 겹치는 사람 12명)으로 확인합니다.
+//  - 사람 마스크 밖의 픽셀(BGR, YUV는 휘도)은 그대로
+//  - 마스크 안의 픽셀은 거의 모두 바뀜 (무작위 영상이라 흐리면 원래 값과 달라짐)
+//  - pixelate는 프레임 좌표에 맞춘 downscale 블록마다 원래 블록 평균인 한 색. 프레임 크기가 downscale의
+//    배수가 아니면 오른쪽/아래 끝의 부분 블록도 같은 규칙
+// 그리고 방식마다 프레임당 시간을 출력합니다.
+namespace {
+
+constexpr int kIterations = 50;
+
+struct Scene {
+    SegmentationResult result;
+    cv::Mat mask;       // 모든 사람 마스크의 합집합 (프레임 크기)
+    cv::Mat background; // mask의 반전
+};
+
+// 4x3 격자에 이웃과 겹치는 사람 12명, 마스크는 박스 안의 타원
+Scene crowded_scene(const cv::Size& size) {
+    Scene scene;
+    scene.mask = cv::Mat::zeros(size, CV_8UC1);
+    const cv::Size box_size(size.width / 3, size.height / 2);
+    for (int row = 0; row < 3; ++row) {
+        for (int col = 0; col < 4; ++col) {
+            const cv::Rect box(col * size.width / 4 - box_size.width / 8, row * size.height / 3 - box_size.height / 8,
+                               box_size.width, box_size.height);
+            const cv::Rect clipped = box & cv::Rect(0, 0, size.width, size.height);
+            cv::Mat mask = cv::Mat::zeros(clipped.size(), CV_8UC1);
+            cv::ellipse(mask, cv::Point(box.x + box.width / 2, box.y + box.height / 2) - clipped.tl(),
+                        cv::Size(box.width / 2, box.height / 2), 0, 0, 360, cv::Scalar(255), cv::FILLED);
+            cv::Mat dst = scene.mask(clipped);
+            cv::bitwise_or(dst, mask, dst);
+            scene.result.boxes.push_back(clipped);
+            scene.result.masks.push_back(mask);
+        }
+    }
+    scene.result.person_count = static_cast<int>(scene.result.boxes.size());
+    cv::bitwise_not(scene.mask, scene.background);
+    return scene;
+}
+
+// BGR은 세 채널 중 하나라도 다르면 바뀐 픽셀
+cv::Mat changed_pixels(const cv::Mat& before, const cv::Mat& after) {
+    cv::Mat diff;
+    cv::absdiff(before, after, diff);
+    if (diff.channels() > 1) cv::cvtColor(diff, diff, cv::COLOR_BGR2GRAY);
+    return diff > 0;
+}
+
+// pixelate: 마스크 안에 완전히 들어간 블록(끝의 부분 블록 포함)은 한 색이고, 그 색은 원래 블록의 평균
+// (반올림 차이로 1까지)이어야 함
+void check_blocks(const cv::Mat& before, const cv::Mat& after, const cv::Mat& mask, int block) {
+    int blocks = 0;
+    int partial_blocks = 0;
+    for (int y = 0; y < after.rows; y += block) {
+        for (int x = 0; x < after.cols; x += block) {
+            const cv::Rect rect = cv::Rect(x, y, block, block) & cv::Rect(0, 0, after.cols, after.rows);
+            if (cv::countNonZero(mask(rect)) != rect.area()) continue;
+            const cv::Mat tile = after(rect);
+            const cv::Scalar color = cv::mean(tile(cv::Rect(0, 0, 1, 1)));
+            cv::Mat diff;
+            cv::absdiff(tile, color, diff);
+            CHECK_EQ(cv::countNonZero(diff.reshape(1)), 0);
+            const cv::Scalar expected = cv::mean(before(rect));
+            for (int c = 0; c < after.channels(); ++c) CHECK(std::abs(color[c] - std::round(expected[c])) <= 1.0);
+            ++blocks;
+            if (rect.size() != cv::Size(block, block)) ++partial_blocks;
+        }
+    }
+    CHECK(blocks > 0);
+    if (after.cols % block != 0 || after.rows % block != 0) CHECK(partial_blocks > 0);
+}
+
+void check_format(const cv::Size& size, PixelFormat format, const char* name) {
+    cv::Mat bgr(size, CV_8UC3);
+    cv::randu(bgr, cv::Scalar::all(0), cv::Scalar::all(256));
+    cv::Mat src;
+    if (format == PixelFormat::Bgr) {
+        src = bgr;
+    } else {
+        bgr_to_yuv420(bgr, format, src);
+    }
+    const Scene scene = crowded_scene(size);
+    const int mask_pixels = cv::countNonZero(scene.mask);
+    BlurConfig config;
+
+    // 사람이 없으면 아무것도 바꾸지 않음
+    cv::Mat frame = src.clone();
+    PrivacyBlur(config).apply(frame, format, SegmentationResult());
+    CHECK_EQ(cv::countNonZero(changed_pixels(src, frame).reshape(1)), 0);
+
+    for (PrivacyBlur::Method method : {PrivacyBlur::Method::Pyramid, PrivacyBlur::Method::Pixelate,
+                                       PrivacyBlur::Method::Gaussian}) {
+        config.method = PrivacyBlur::method_name(method);
+        PrivacyBlur blur(config);
+        CHECK(blur.method() == method);
+
+        src.copyTo(frame);
+        blur.apply(frame, format, scene.result);
+        const cv::Mat before = format == PixelFormat::Bgr ? src : yuv420_luma(src);
+        const cv::Mat after = format == PixelFormat::Bgr ? frame : yuv420_luma(frame);
+        const cv::Mat changed = changed_pixels(before, after);
+        cv::Mat outside, inside;
+        cv::bitwise_and(changed, scene.background, outside);
+        cv::bitwise_and(changed, scene.mask, inside);
+        CHECK_EQ(cv::countNonZero(outside), 0);
+        const double inside_ratio = static_cast<double>(cv::countNonZero(inside)) / mask_pixels;
+        CHECK(inside_ratio > 0.8);
+        if (method == PrivacyBlur::Method::Pixelate) check_blocks(before, after, scene.mask, config.downscale);
+
+        double total_ms = 0.0;
+        for (int i = 0; i < kIterations; ++i) {
+            src.copyTo(frame); // 이미 가린 프레임을 다시 가리지 않도록 (복사 시간은 제외)
+            const auto started = std::chrono::steady_clock::now();
+            blur.apply(frame, format, scene.result);
+            total_ms += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - started).count();
+        }
+        std::cout << name << " " << size.width << "x" << size.height << " 사람 " << scene.result.person_count
+                  << "명, " << PrivacyBlur::method_name(method) << ": " << std::fixed << std::setprecision(3)
+                  << total_ms / kIterations << " ms, 마스크 안 바뀐 픽셀 " << std::setprecision(1)
+                  << inside_ratio * 100.0 << "%" << std::endl;
+        std::cout.unsetf(std::ios::fixed);
+    }
+}
+
+} // namespace
+
+int main() {
+    check_format(cv::Size(640, 480), PixelFormat::Bgr, "BGR");
+    check_format(cv::Size(640, 480), PixelFormat::I420, "I420");
+    check_format(cv::Size(640, 480), PixelFormat::Nv12, "NV12");
+    // downscale(8)의 배수가 아닌 크기: 오른쪽/아래 끝 블록이 2픽셀 폭의 부분 블록
+    check_format(cv::Size(650, 490), PixelFormat::Bgr, "BGR");
+    check_format(cv::Size(650, 490), PixelFormat::I420, "I420");
+    check_format(cv::Size(650, 490), PixelFormat::Nv12, "NV12");
+    return test_exit_code("test_privacy_blur");
+}
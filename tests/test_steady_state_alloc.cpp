@@ -0,0 +1,184 @@
+#include "FramePool.h"
+#include "FrameSource.h"
+#include "ImageConditioner.h"
+#include "InferenceResult.h"
+#include "Overlay.h"
+#include "PrivacyBlur.h"
+#include "TestCheck.h"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <new>
+
+// 캡처 → 렌더 경로(합성 소스 → FramePool → ImageConditioner → draw_overlays)를 워밍업 뒤에 돌리며
+// 할당을 셉니다.
+//  - cv::Mat 버퍼 할당(기본 MatAllocator를 감쌈): 프레임/작업 버퍼를 재사용하므로 0이어야 함
+//  - 전역 operator new (이 파일에서 바꿔 끼움): OpenCV 함수 안의 작은 임시 할당(글자 그리기의 점 목록,
+//    resize/blur 표 등)은 남으므로 횟수만 출력하고, 프레임 크기에 가까운 할당이 없는지만 확인
+namespace {
+
+constexpr int kWarmup = 20;
+constexpr int kFrames = 200;
+constexpr size_t kLargestSmallAlloc = 64 * 1024; // 640x480 프레임은 BGR 900 KiB, YUV 450 KiB
+
+std::atomic<bool> g_counting{false};
+std::atomic<uint64_t> g_new_count{0};
+std::atomic<size_t> g_largest_new{0};
+std::atomic<uint64_t> g_mat_allocations{0};
+
+void* counted_new(size_t size) {
+    if (g_counting.load(std::memory_order_relaxed)) {
+        ++g_new_count;
+        size_t largest = g_largest_new.load();
+        while (size > largest && !g_largest_new.compare_exchange_weak(largest, size)) {}
+    }
+    if (void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+
+// 기본 할당자에 넘기면서 새 버퍼 할당(외부 data가 없는 경우)만 셈
+class CountingMatAllocator : public cv::MatAllocator {
+public:
+    cv::UMatData* allocate(int dims, const int* sizes, int type, void* data, size_t* step, cv::AccessFlag flags,
+                           cv::UMatUsageFlags usage) const override {
+        if (!data && g_counting.load(std::memory_order_relaxed)) ++g_mat_allocations;
+        return base_->allocate(dims, sizes, type, data, step, flags, usage);
+    }
+    bool allocate(cv::UMatData* data, cv::AccessFlag flags, cv::UMatUsageFlags usage) const override {
+        return base_->allocate(data, flags, usage);
+    }
+    void deallocate(cv::UMatData* data) const override { base_->deallocate(data); }
+
+private:
+    cv::MatAllocator* base_ = cv::Mat::getStdAllocator();
+};
+
+InferenceResult detect_result() {
+    InferenceResult result;
+    result.mode = "detect";
+    result.class_names = {"person", "helmet", "safety-vest"};
+    for (int i = 0; i < 6; ++i) {
+        result.detections.push_back({cv::Rect(20 + i * 100, 60 + (i % 2) * 150, 90, 180), 0.9f, i % 3, i});
+    }
+    return result;
+}
+
+InferenceResult blur_result(const cv::Size& size) {
+    InferenceResult result;
+    result.mode = "blur";
+    for (int i = 0; i < 4; ++i) {
+        const cv::Rect box(40 + i * 150, size.height / 4, 120, size.height / 2);
+        cv::Mat mask = cv::Mat::zeros(box.size(), CV_8UC1);
+        cv::ellipse(mask, cv::Point(box.width / 2, box.height / 2), cv::Size(box.width / 2, box.height / 2), 0, 0, 360, cv::Scalar(255), cv::FILLED);
+        result.segmentation.boxes.push_back(box);
+        result.segmentation.masks.push_back(mask);
+    }
+    result.segmentation.person_count = static_cast<int>(result.segmentation.boxes.size());
+    return result;
+}
+
+void check_path(PixelFormat format, const char* format_name, const InferenceResult& result, const BlurConfig& blur_config) {
+    CaptureConfig capture;
+    capture.backend = "synthetic";
+    capture.format = format;
+    capture.paced = false;
+    SyntheticFrameSource source(capture);
+    CHECK(source.open());
+
+    FramePool pool;
+    ImageConditioner conditioner;
+    conditioner.set_curve(10, 1.1, 1.0);
+    PrivacyBlur blur(blur_config);
+    const std::map<std::string, cv::Scalar> colors = {{"person", cv::Scalar(0, 255, 0)}};
+    const std::vector<Zone> zones;
+    // 렌더 큐(4) 길이만큼 프레임을 붙잡았다 놓음. 테스트 자체의 할당이 섞이지 않도록 고정 배열
+    std::array<Frame, 4> render_queue;
+    Frame inference_frame;
+    Frame raw;
+    size_t next = 0;
+
+    auto step = [&]() {
+        CHECK(source.read(raw));
+        Frame frame;
+        frame.format = raw.format;
+        pool.acquire(frame, raw.image.rows, raw.image.cols, raw.image.type());
+        conditioner.apply(raw.image, raw.format, frame.image);
+        // 추론 단계로 넘기는 사본
+        inference_frame = frame;
+        pool.acquire(inference_frame, frame.image.rows, frame.image.cols, frame.image.type());
+        frame.image.copyTo(inference_frame.image);
+        draw_overlays(frame.image, frame.format, result, colors, zones, blur);
+        render_queue[next] = std::move(frame);
+        next = (next + 1) % render_queue.size();
+    };
+
+    for (int i = 0; i < kWarmup; ++i) step();
+    const uint64_t pool_allocations = pool.stats().allocations;
+
+    g_new_count = 0;
+    g_largest_new = 0;
+    g_mat_allocations = 0;
+    const auto started = std::chrono::steady_clock::now();
+    g_counting = true;
+    for (int i = 0; i < kFrames; ++i) step();
+    g_counting = false;
+    const double frame_ms =
+        std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - started).count() / kFrames;
+
+    CHECK_EQ(g_mat_allocations.load(), 0u);
+    CHECK_EQ(pool.stats().allocations, pool_allocations);
+    CHECK(g_largest_new.load() < kLargestSmallAlloc);
+    const std::string mode = result.mode == "blur" ? "blur/" + blur_config.method : result.mode;
+    std::cout << format_name << " " << mode << ": " << std::fixed << std::setprecision(3) << frame_ms
+              << " ms/프레임, Mat 할당 " << g_mat_allocations.load() << ", operator new " << std::setprecision(1)
+              << static_cast<double>(g_new_count.load()) / kFrames << "회/프레임 (최대 " << g_largest_new.load()
+              << " B)" << std::endl;
+    std::cout.unsetf(std::ios::fixed);
+}
+
+} // namespace
+
+void* operator new(size_t size) { return counted_new(size); }
+void* operator new[](size_t size) { return counted_new(size); }
+void* operator new(size_t size, const std::nothrow_t&) noexcept {
+    try {
+        return counted_new(size);
+    } catch (...) {
+        return nullptr;
+    }
+}
+void* operator new[](size_t size, const std::nothrow_t&) noexcept {
+    try {
+        return counted_new(size);
+    } catch (...) {
+        return nullptr;
+    }
+}
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, size_t) noexcept { std::free(p); }
+void operator delete[](void* p, size_t) noexcept { std::free(p); }
+
+int main() {
+    CountingMatAllocator allocator;
+    cv::Mat::setDefaultAllocator(&allocator);
+
+    const InferenceResult detect = detect_result();
+    const InferenceResult blur = blur_result(cv::Size(640, 480));
+    BlurConfig pyramid;
+    BlurConfig pixelate;
+    pixelate.method = "pixelate";
+    for (auto [format, name] : {std::make_pair(PixelFormat::Bgr, "BGR"), std::make_pair(PixelFormat::I420, "I420"),
+                                std::make_pair(PixelFormat::Nv12, "NV12")}) {
+        check_path(format, name, detect, pyramid);
+        check_path(format, name, blur, pyramid);
+        check_path(format, name, blur, pixelate);
+    }
+
+    cv::Mat::setDefaultAllocator(nullptr);
+    return test_exit_code("test_steady_state_alloc");
+}
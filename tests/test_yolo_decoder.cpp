@@ -0,0 +1,135 @@
+#include "YoloDecoder.h"
+#include "TestCheck.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <tuple>
+
+// int8 디코더(decode)가 기존 스칼라 루프(decode_reference)와 대상 클래스 검출을 똑같이 내는지 확인하고
+// 두 디코더의 호출당 시간을 출력합니다. 출력 텐서는 [4 + 클래스 수][앵커 수] int8 배치입니다.
+namespace {
+
+constexpr float kScale = 1.0f / 255.0f;
+constexpr int kZeroPoint = -128; // q = round(v * 255) - 128 → v = 0..1
+constexpr int kNumClasses = 5;
+constexpr int kNumDet = 2103;    // SIMD 폭의 배수가 아닌 앵커 수 (끝 스칼라 처리)
+constexpr float kConf = 0.5f;
+constexpr float kNms = 0.45f;
+const cv::Size kFrame(640, 480);
+
+int8_t quantize(float v) {
+    return static_cast<int8_t>(std::min(127, std::max(-128, static_cast<int>(std::lround(v / kScale)) + kZeroPoint)));
+}
+
+struct Output {
+    std::vector<int8_t> data = std::vector<int8_t>(static_cast<size_t>(4 + kNumClasses) * kNumDet, quantize(0.0f));
+    void set(int anchor, int row, float v) { data[static_cast<size_t>(row) * kNumDet + anchor] = quantize(v); }
+};
+
+// 물체마다 격자 칸 하나를 주고(칸끼리 겹치지 않음) 그 안에 같은 클래스의 앵커 몇 개를 흩뿌립니다.
+// 대상이 아닌 클래스의 박스가 대상 박스를 NMS로 지우는 경우가 없어 두 디코더의 대상 검출이 같아야 합니다.
+Output grid_scene(std::mt19937& rng) {
+    Output out;
+    std::uniform_real_distribution<float> low(0.0f, 0.3f);
+    for (int i = 0; i < kNumDet; ++i) {
+        for (int k = 0; k < kNumClasses; ++k) out.set(i, 4 + k, low(rng));
+        out.set(i, 0, 0.5f);
+        out.set(i, 1, 0.5f);
+        out.set(i, 2, 0.01f);
+        out.set(i, 3, 0.01f);
+    }
+    std::uniform_int_distribution<int> anchor_dist(0, kNumDet - 1);
+    std::uniform_int_distribution<int> class_dist(0, kNumClasses - 1);
+    std::uniform_real_distribution<float> jitter(-0.01f, 0.01f);
+    std::uniform_real_distribution<float> high(0.55f, 0.95f);
+    for (int gy = 0; gy < 4; ++gy) {
+        for (int gx = 0; gx < 5; ++gx) {
+            const int cls = class_dist(rng);
+            for (int a = 0; a < 3; ++a) {
+                const int anchor = anchor_dist(rng);
+                out.set(anchor, 0, (gx + 0.5f) / 5.0f + jitter(rng));
+                out.set(anchor, 1, (gy + 0.5f) / 4.0f + jitter(rng));
+                out.set(anchor, 2, 0.12f);
+                out.set(anchor, 3, 0.15f);
+                for (int k = 0; k < kNumClasses; ++k) out.set(anchor, 4 + k, k == cls ? high(rng) : low(rng));
+            }
+        }
+    }
+    return out;
+}
+
+// 완전히 무작위인 출력 (모든 클래스가 대상이면 두 디코더가 같은 후보로 같은 NMS를 돌림)
+Output random_scene(std::mt19937& rng) {
+    Output out;
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+    std::uniform_real_distribution<float> size(0.02f, 0.3f);
+    for (int i = 0; i < kNumDet; ++i) {
+        out.set(i, 0, unit(rng));
+        out.set(i, 1, unit(rng));
+        out.set(i, 2, size(rng));
+        out.set(i, 3, size(rng));
+        for (int k = 0; k < kNumClasses; ++k) out.set(i, 4 + k, unit(rng) * 0.6f);
+    }
+    return out;
+}
+
+using Key = std::tuple<int, int, int, int, int>;
+std::vector<std::pair<Key, float>> sorted(const std::vector<DetectionResult>& results) {
+    std::vector<std::pair<Key, float>> out;
+    for (const DetectionResult& r : results) {
+        out.emplace_back(Key(r.class_id, r.box.x, r.box.y, r.box.width, r.box.height), r.confidence);
+    }
+    std::sort(out.begin(), out.end());
+    return out;
+}
+
+void check_same(const Output& output, const std::vector<int>& targets, const char* name) {
+    YoloInt8Decoder decoder;
+    decoder.configure(kScale, kZeroPoint, kNumClasses, kNumDet, targets);
+    std::vector<DetectionResult> reference, fast;
+    decoder.decode_reference(output.data.data(), kFrame, kConf, kNms, reference);
+    decoder.decode(output.data.data(), kFrame, kConf, kNms, fast);
+
+    const auto a = sorted(reference);
+    const auto b = sorted(fast);
+    CHECK_EQ(a.size(), b.size());
+    for (size_t i = 0; i < std::min(a.size(), b.size()); ++i) {
+        CHECK(a[i].first == b[i].first);
+        CHECK(std::fabs(a[i].second - b[i].second) <= 1e-6f);
+    }
+    for (const DetectionResult& r : fast) {
+        CHECK(targets.empty() || std::find(targets.begin(), targets.end(), r.class_id) != targets.end());
+    }
+
+    constexpr int kIterations = 500;
+    auto measure = [&](auto&& run) {
+        const auto started = std::chrono::steady_clock::now();
+        for (int i = 0; i < kIterations; ++i) run();
+        return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - started).count() / kIterations;
+    };
+    const double reference_us = measure([&] { decoder.decode_reference(output.data.data(), kFrame, kConf, kNms, reference); });
+    const double int8_us = measure([&] { decoder.decode(output.data.data(), kFrame, kConf, kNms, fast); });
+    std::cout << name << " (앵커 " << kNumDet << ", 클래스 " << kNumClasses << ", 대상 "
+              << (targets.empty() ? kNumClasses : static_cast<int>(targets.size())) << "): 검출 " << fast.size()
+              << ", 기존 " << std::fixed << std::setprecision(1) << reference_us << " us, int8 " << int8_us << " us"
+              << std::endl;
+    std::cout.unsetf(std::ios::fixed);
+}
+
+} // namespace
+
+int main() {
+    std::mt19937 rng(1234);
+    for (int round = 0; round < 5; ++round) {
+        const Output scene = grid_scene(rng);
+        check_same(scene, {0}, "격자 장면, 대상 {0}");
+        check_same(scene, {1, 3}, "격자 장면, 대상 {1, 3}");
+        check_same(scene, {}, "격자 장면, 전체 클래스");
+        check_same(random_scene(rng), {}, "무작위 출력, 전체 클래스");
+    }
+    return test_exit_code("test_yolo_decoder");
+}